@@ -0,0 +1,208 @@
+/*******************************************************************
+* libFuzzer differential target: every kernel in reversalVariants,
+*	batchReversalVariants and checkedBatchReversalVariants must agree
+*	with reverseDigits_Reference on every input, the checked ones'
+*	overflow bits and counts with the exact reversal, and the int64_t
+*	reverseDigits_Unrolled with reverseDigitsChecked.
+*
+* Build with clang, e.g.
+*	clang++ -std=c++23 -O1 -g -fsanitize=fuzzer,address,undefined -fno-sanitize-recover=undefined
+*		-I IntDigitReverser Fuzz/FuzzReverseDigits.cpp -o FuzzReverseDigits
+* or swap -fsanitize=fuzzer for ReplayMain.cpp to replay a corpus without libFuzzer.
+*******************************************************************/
+
+#include "ReversalPreimages.h"
+#include "ReverseDigits.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	/// <summary>
+	/// Runs one value through every variant and aborts (so the fuzzer records the input) on the first disagreement.
+	/// </summary>
+	/// <param name="value"></param>
+	void checkAllVariants(int32_t value)
+	{
+		const int32_t expected = reverseDigits_Reference(value);
+		for (const ReversalVariant& variant : reversalVariants)
+		{
+			const int32_t actual = variant.func(value);
+			if (actual != expected)
+			{
+				std::fprintf(stderr, "[%.*s] reverse(%d) expected %d but got %d\n",
+					static_cast<int>(variant.name.size()), variant.name.data(), value, expected, actual);
+				std::abort();
+			}
+		}
+	}
+
+	void reportBatchMismatch(const BatchReversalVariant& variant, int32_t value, int32_t expected, int32_t actual, const char* how)
+	{
+		std::fprintf(stderr, "[%.*s] %s reverse(%d) expected %d but got %d\n",
+			static_cast<int>(variant.name.size()), variant.name.data(), how, value, expected, actual);
+		std::abort();
+	}
+
+	/// <summary>
+	/// Runs all of the values through every supported batch kernel, both out of place and in place.
+	///		The fuzzer picks the length, so the SIMD main loops and their scalar tails both get covered.
+	/// </summary>
+	/// <param name="values"></param>
+	void checkAllBatchVariants(const std::vector<int32_t>& values)
+	{
+		std::vector<int32_t> results(values.size());
+		std::vector<int32_t> inPlace(values.size());
+		for (const BatchReversalVariant& variant : batchReversalVariants)
+		{
+			if (!variant.isSupported())
+			{
+				continue;
+			}
+
+			variant.func(values, results);
+			inPlace = values;
+			variant.func(inPlace, inPlace);
+
+			for (size_t index = 0; index < values.size(); ++index)
+			{
+				const int32_t expected = reverseDigits_Reference(values[index]);
+				if (results[index] != expected)
+				{
+					reportBatchMismatch(variant, values[index], expected, results[index], "out of place");
+				}
+				if (inPlace[index] != expected)
+				{
+					reportBatchMismatch(variant, values[index], expected, inPlace[index], "in place");
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Runs all of the values through every supported checked batch kernel, with a mask full of garbage that has to be
+	///		overwritten, and checks the results, every overflow bit, the unused bits of the last word and the returned count.
+	/// </summary>
+	/// <param name="values"></param>
+	void checkAllCheckedBatchVariants(const std::vector<int32_t>& values)
+	{
+		std::vector<int32_t> results(values.size());
+		std::vector<uint64_t> overflowBits(overflowMaskWords(values.size()));
+		for (const CheckedBatchReversalVariant& variant : checkedBatchReversalVariants)
+		{
+			if (!variant.isSupported())
+			{
+				continue;
+			}
+
+			std::fill(overflowBits.begin(), overflowBits.end(), ~uint64_t(0));
+			const size_t overflowCount = variant.func(values, results, overflowBits);
+
+			size_t expectedCount = 0;
+			for (size_t index = 0; index < values.size(); ++index)
+			{
+				const int32_t expected = reverseDigits_Reference(values[index]);
+				const bool expectedBit = !fitsInt32(reverseDigits_Wide(values[index]));
+				const bool bit = ((overflowBits[index / 64] >> (index % 64)) & 1) != 0;
+				expectedCount += expectedBit ? 1 : 0;
+				if (results[index] != expected || bit != expectedBit)
+				{
+					std::fprintf(stderr, "[%.*s] reverse(%d) expected %d, overflow bit %d but got %d, overflow bit %d\n",
+						static_cast<int>(variant.name.size()), variant.name.data(), values[index], expected, expectedBit ? 1 : 0, results[index], bit ? 1 : 0);
+					std::abort();
+				}
+			}
+
+			const uint64_t unusedBits = values.size() % 64 == 0 ? 0 : ~uint64_t(0) << (values.size() % 64);
+			if (overflowCount != expectedCount || (!overflowBits.empty() && (overflowBits.back() & unusedBits) != 0))
+			{
+				std::fprintf(stderr, "[%.*s] %zu values: expected %zu overflows but got %zu, unused mask bits %s\n",
+					static_cast<int>(variant.name.size()), variant.name.data(), values.size(), expectedCount, overflowCount,
+					!overflowBits.empty() && (overflowBits.back() & unusedBits) != 0 ? "set" : "clear");
+				std::abort();
+			}
+		}
+	}
+
+	/// <summary>
+	/// The 64-bit reversal: reverseDigits_Unrolled(int64_t) against the looped reverseDigitsChecked.
+	/// </summary>
+	/// <param name="value"></param>
+	void checkWideVariants(int64_t value)
+	{
+		const int64_t expected = reverseDigitsChecked(value);
+		const int64_t actual = reverseDigits_Unrolled(value);
+		if (actual != expected)
+		{
+			std::fprintf(stderr, "[Unrolled int64] reverse(%lld) expected %lld but got %lld\n",
+				static_cast<long long>(value), static_cast<long long>(expected), static_cast<long long>(actual));
+			std::abort();
+		}
+	}
+
+	/// <summary>
+	/// Reads a little-endian signed integer of `width` bytes and sign extends it,
+	///		so short inputs (and the tail of longer ones) exercise the narrow widths and the small digit counts.
+	/// </summary>
+	/// <param name="data"></param>
+	/// <param name="width">1 to 4</param>
+	/// <returns></returns>
+	int32_t readSigned(const uint8_t* data, size_t width)
+	{
+		uint32_t bits = 0;
+		for (size_t index = 0; index < width; ++index)
+		{
+			bits |= static_cast<uint32_t>(data[index]) << (index * 8);
+		}
+
+		const uint32_t signBit = 1u << (width * 8 - 1);
+		if ((bits & signBit) != 0)
+		{
+			bits |= ~((signBit << 1) - 1);
+		}
+
+		return static_cast<int32_t>(bits);
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	std::vector<int32_t> values;
+	values.reserve(size / sizeof(int32_t) + 1);
+
+	size_t offset = 0;
+	for (; offset + sizeof(int32_t) <= size; offset += sizeof(int32_t))
+	{
+		values.push_back(readSigned(data + offset, sizeof(int32_t)));
+	}
+
+	if (offset < size)
+	{
+		values.push_back(readSigned(data + offset, size - offset));
+	}
+
+	for (const int32_t value : values)
+	{
+		checkAllVariants(value);
+	}
+	checkAllBatchVariants(values);
+	checkAllCheckedBatchVariants(values);
+
+	// The same bytes again as int64_t, so the 64-bit digit counts and overflow edges get covered too
+	for (size_t wideOffset = 0; wideOffset + sizeof(int64_t) <= size; wideOffset += sizeof(int64_t))
+	{
+		int64_t value = 0;
+		std::memcpy(&value, data + wideOffset, sizeof(value));
+		checkWideVariants(value);
+	}
+	for (const int32_t value : values)
+	{
+		checkWideVariants(value);
+	}
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*******************************************************************
+* Standalone driver for the fuzz targets: replays every file given on
+*	the command line (directories are walked recursively) through
+*	LLVMFuzzerTestOneInput, for builds without libFuzzer.
+*	Still worth building with -fsanitize=address,undefined.
+*******************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace
+{
+	bool replayFile(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			std::fprintf(stderr, "Failed to open %s\n", path.string().c_str());
+			return false;
+		}
+
+		const std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		LLVMFuzzerTestOneInput(contents.data(), contents.size());
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "Usage: %s <corpus file or directory>...\n", argv[0]);
+		return 2;
+	}
+
+	size_t replayed = 0;
+	bool anyFailed = false;
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		const std::filesystem::path path = argv[argIndex];
+		if (std::filesystem::is_directory(path))
+		{
+			for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path))
+			{
+				if (entry.is_regular_file())
+				{
+					anyFailed |= !replayFile(entry.path());
+					++replayed;
+				}
+			}
+		}
+		else
+		{
+			anyFailed |= !replayFile(path);
+			++replayed;
+		}
+	}
+
+	std::printf("Replayed %zu inputs\n", replayed);
+	return anyFailed ? 1 : 0;
+}
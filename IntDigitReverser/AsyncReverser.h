@@ -0,0 +1,351 @@
+/*******************************************************************
+* Awaitable batch reversal for coroutine based code.
+*	Part of the header-only library, next to ReverseDigits.h.
+*
+* Public API:
+*	AsyncReverser                 co_await reverser.reverseBatch(input, output)
+*	AsyncGenerator<T>             minimal async generator; co_await generator.next()
+*	reverseStream(reverser, ...)  generator of reversed blocks read from a source
+*
+* Awaiting coroutines push themselves onto a lock-free stack. A
+*	worker takes everything queued at once, reverses the whole
+*	batch, then resumes its coroutines in submission order on the
+*	worker thread, so coroutines that keep awaiting settle into
+*	batches the size of their number with no thread hand-offs.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ReverseDigits.h"
+
+class AsyncReverser
+{
+public:
+	/// <summary>
+	/// Awaitable returned by reverseBatch; the batch is submitted when it is awaited.
+	/// </summary>
+	class [[nodiscard]] Operation
+	{
+	public:
+		bool await_ready() const noexcept
+		{
+			return input.empty();
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) noexcept
+		{
+			waiter = handle;
+			reverser->submit(this);
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+
+	private:
+		friend AsyncReverser;
+
+		Operation(AsyncReverser* reverser, std::span<const int32_t> input, std::span<int32_t> output) noexcept
+			: reverser(reverser)
+			, input(input)
+			, output(output)
+		{
+		}
+
+		AsyncReverser* reverser;
+		std::span<const int32_t> input;
+		std::span<int32_t> output;
+		std::coroutine_handle<> waiter;
+		Operation* next = nullptr;
+	};
+
+	/// <summary>
+	/// Starts the worker threads. Awaiting coroutines are resumed on them.
+	/// </summary>
+	/// <param name="workerCount">At least 1</param>
+	explicit AsyncReverser(size_t workerCount = 1)
+	{
+		for (size_t worker = 0; worker < std::max<size_t>(workerCount, 1); ++worker)
+		{
+			workers.emplace_back([this]() { workerLoop(); });
+		}
+	}
+
+	AsyncReverser(const AsyncReverser&) = delete;
+	AsyncReverser& operator=(const AsyncReverser&) = delete;
+
+	/// <summary>
+	/// Stops and joins the workers. Every awaited batch has to have completed by then.
+	/// </summary>
+	~AsyncReverser()
+	{
+		stopping.store(true, std::memory_order_seq_cst);
+		wakeups.fetch_add(1, std::memory_order_seq_cst);
+		wakeups.notify_all();
+	}
+
+	/// <summary>
+	/// Reverses min(input.size(), output.size()) values on a worker when awaited, resuming the awaiting
+	///		coroutine there afterwards. Both spans have to stay valid until then; they may be the same span.
+	/// </summary>
+	/// <param name="input"></param>
+	/// <param name="output"></param>
+	/// <returns>The awaitable</returns>
+	Operation reverseBatch(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+	{
+		const size_t count = std::min(input.size(), output.size());
+		return Operation(this, input.first(count), output.first(count));
+	}
+
+	/// <summary>
+	/// Awaits that have gone through a worker so far.
+	/// </summary>
+	/// <returns></returns>
+	uint64_t operationCount() const noexcept
+	{
+		return operations.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// Batches the workers have taken so far; operationCount() / batchCount() is the average batch.
+	/// </summary>
+	/// <returns></returns>
+	uint64_t batchCount() const noexcept
+	{
+		return batches.load(std::memory_order_relaxed);
+	}
+
+private:
+	void submit(Operation* operation) noexcept
+	{
+		Operation* head = pending.load(std::memory_order_relaxed);
+		do
+		{
+			operation->next = head;
+		} while (!pending.compare_exchange_weak(head, operation, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+		// Only the push onto an empty stack wakes anyone; a non-empty one is already owed a worker
+		if (head == nullptr)
+		{
+			wakeups.fetch_add(1, std::memory_order_seq_cst);
+			wakeups.notify_one();
+		}
+	}
+
+	void workerLoop() noexcept
+	{
+		for (;;)
+		{
+			// Reading wakeups before the final check of the stack pairs with submit's push then increment
+			const uint32_t seenWakeups = wakeups.load(std::memory_order_seq_cst);
+			Operation* batch = pending.exchange(nullptr, std::memory_order_seq_cst);
+			if (batch == nullptr)
+			{
+				if (stopping.load(std::memory_order_seq_cst))
+				{
+					return;
+				}
+				wakeups.wait(seenWakeups, std::memory_order_seq_cst);
+				continue;
+			}
+
+			// The stack is newest first; flip it so coroutines resume in the order they awaited
+			Operation* ordered = nullptr;
+			uint64_t batchOperations = 0;
+			while (batch != nullptr)
+			{
+				Operation* const next = batch->next;
+				batch->next = ordered;
+				ordered = batch;
+				batch = next;
+				++batchOperations;
+			}
+
+			for (Operation* operation = ordered; operation != nullptr; operation = operation->next)
+			{
+				::reverseDigits(operation->input, operation->output);
+			}
+			operations.fetch_add(batchOperations, std::memory_order_relaxed);
+			batches.fetch_add(1, std::memory_order_relaxed);
+
+			// An operation lives in its coroutine's frame and is gone once that coroutine resumes
+			for (Operation* operation = ordered; operation != nullptr;)
+			{
+				Operation* const next = operation->next;
+				operation->waiter.resume();
+				operation = next;
+			}
+		}
+	}
+
+	alignas(64) std::atomic<Operation*> pending = nullptr;
+	alignas(64) std::atomic<uint32_t> wakeups = 0;
+	std::atomic<bool> stopping = false;
+
+	std::atomic<uint64_t> operations = 0;
+	std::atomic<uint64_t> batches = 0;
+
+	// Last, so the threads are joined before anything they use is destroyed
+	std::vector<std::jthread> workers;
+};
+
+/// <summary>
+/// Single consumer async generator: the body may co_await anything and co_yield values, the consumer
+///		co_awaits next() for each one. Control passes between the two by symmetric transfer, on whichever
+///		thread the body was last resumed on.
+/// </summary>
+/// <typeparam name="T">Yielded by value</typeparam>
+template<typename T>
+class AsyncGenerator
+{
+public:
+	struct promise_type;
+	using Handle = std::coroutine_handle<promise_type>;
+
+	struct promise_type
+	{
+		std::optional<T> current;
+		std::coroutine_handle<> consumer;
+
+		struct ResumeConsumer
+		{
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			std::coroutine_handle<> await_suspend(Handle handle) const noexcept
+			{
+				return handle.promise().consumer;
+			}
+
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		AsyncGenerator get_return_object() noexcept
+		{
+			return AsyncGenerator(Handle::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() const noexcept
+		{
+			return {};
+		}
+
+		ResumeConsumer final_suspend() const noexcept
+		{
+			return {};
+		}
+
+		ResumeConsumer yield_value(T value) noexcept
+		{
+			current = std::move(value);
+			return {};
+		}
+
+		void return_void() noexcept
+		{
+			current.reset();
+		}
+
+		void unhandled_exception() const noexcept
+		{
+			std::terminate();
+		}
+	};
+
+	struct NextAwaiter
+	{
+		Handle handle;
+
+		bool await_ready() const noexcept
+		{
+			return handle.done();
+		}
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) const noexcept
+		{
+			handle.promise().consumer = consumer;
+			return handle;
+		}
+
+		std::optional<T> await_resume() const noexcept
+		{
+			return handle.done() ? std::nullopt : std::exchange(handle.promise().current, std::nullopt);
+		}
+	};
+
+	AsyncGenerator(AsyncGenerator&& other) noexcept
+		: handle(std::exchange(other.handle, nullptr))
+	{
+	}
+
+	AsyncGenerator(const AsyncGenerator&) = delete;
+	AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+	AsyncGenerator& operator=(AsyncGenerator&&) = delete;
+
+	~AsyncGenerator()
+	{
+		if (handle)
+		{
+			handle.destroy();
+		}
+	}
+
+	/// <summary>
+	/// Runs the body to its next co_yield. Don't destroy the generator while that is in progress.
+	/// </summary>
+	/// <returns>Awaits the next value, or std::nullopt once the body has finished</returns>
+	NextAwaiter next() const noexcept
+	{
+		return NextAwaiter{ handle };
+	}
+
+private:
+	explicit AsyncGenerator(Handle handle) noexcept
+		: handle(handle)
+	{
+	}
+
+	Handle handle;
+};
+
+/// <summary>
+/// Streams a source through reverser a block at a time. The yielded span is valid until the next next().
+/// </summary>
+/// <typeparam name="Source">Callable as size_t(std::span&lt;int32_t&gt; block), filling the front of block and returning how much, 0 at the end</typeparam>
+/// <param name="reverser">Has to outlive the generator</param>
+/// <param name="source"></param>
+/// <param name="blockValues">Values per await, and the largest yielded block</param>
+/// <returns></returns>
+template<typename Source>
+AsyncGenerator<std::span<const int32_t>> reverseStream(AsyncReverser& reverser, Source source, size_t blockValues)
+{
+	std::vector<int32_t> block(std::max<size_t>(blockValues, 1));
+	for (;;)
+	{
+		const size_t count = std::min(source(std::span<int32_t>(block)), block.size());
+		if (count == 0)
+		{
+			co_return;
+		}
+
+		const std::span<int32_t> filled = std::span<int32_t>(block).first(count);
+		co_await reverser.reverseBatch(filled, filled);
+		co_yield filled;
+	}
+}
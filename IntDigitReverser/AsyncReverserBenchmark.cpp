@@ -0,0 +1,191 @@
+/*******************************************************************
+* Per await overhead of the coroutine API against direct calls.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "AsyncReverser.h"
+#include "AsyncReverserBenchmark.h"
+#include "ReverseDigits.h"
+
+namespace
+{
+	// Bigger batches get fewer awaits, so every measurement covers about this many values
+	constexpr size_t valuesPerMeasurement = 1 << 26;
+	constexpr size_t streamValues = 1 << 24;
+
+	/// <summary>
+	/// Starts running right away and destroys itself when it finishes; completion is signalled through a latch.
+	/// </summary>
+	struct DetachedTask
+	{
+		struct promise_type
+		{
+			DetachedTask get_return_object() const noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never initial_suspend() const noexcept
+			{
+				return {};
+			}
+
+			std::suspend_never final_suspend() const noexcept
+			{
+				return {};
+			}
+
+			void return_void() const noexcept
+			{
+			}
+
+			void unhandled_exception() const noexcept
+			{
+				std::terminate();
+			}
+		};
+	};
+
+	DetachedTask awaitLoop(AsyncReverser& reverser, std::span<const int32_t> input, std::span<int32_t> output, size_t awaitCount, std::latch& done)
+	{
+		for (size_t awaitIndex = 0; awaitIndex < awaitCount; ++awaitIndex)
+		{
+			co_await reverser.reverseBatch(input, output);
+		}
+		done.count_down();
+	}
+
+	DetachedTask consumeStream(AsyncGenerator<std::span<const int32_t>> stream, uint32_t& mismatches, std::latch& done)
+	{
+		int32_t expectedInput = 0;
+		while (std::optional<std::span<const int32_t>> block = co_await stream.next())
+		{
+			for (const int32_t reversed : *block)
+			{
+				mismatches += reversed == reverseDigits_ModuloLookup(expectedInput) ? 0 : 1;
+				expectedInput += 997;
+			}
+		}
+		done.count_down();
+	}
+
+	double nanosecondsSince(std::chrono::high_resolution_clock::time_point start, size_t count)
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / static_cast<double>(std::max<size_t>(count, 1));
+	}
+
+	bool matchesReference(std::span<const int32_t> input, std::span<const int32_t> output)
+	{
+		for (size_t index = 0; index < input.size(); ++index)
+		{
+			if (output[index] != reverseDigits_ModuloLookup(input[index]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int runAsyncReverserBenchmark(size_t awaitCount)
+{
+	constexpr std::array<size_t, 4> valuesPerAwaitOptions = { 1, 16, 256, 4096 };
+	constexpr std::array<size_t, 2> coroutineCountOptions = { 1, 64 };
+
+	std::println("Up to {:L} awaits per measurement on 1 worker thread, {}\n", awaitCount, toString(batchSimdLevel()));
+	std::println("{:>13} {:>10} {:>14} {:>14} {:>12} {:>10}", "values/await", "coroutines", "direct ns/call", "async ns/await", "overhead ns", "avg batch");
+
+	std::mt19937 generator(1);
+	std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::lowest(), std::numeric_limits<int32_t>::max());
+
+	bool allCorrect = true;
+	for (const size_t valuesPerAwait : valuesPerAwaitOptions)
+	{
+		for (const size_t coroutineCount : coroutineCountOptions)
+		{
+			const size_t awaitsPerCoroutine = std::max<size_t>(std::min(awaitCount, valuesPerMeasurement / valuesPerAwait) / coroutineCount, 1);
+			const size_t totalAwaits = awaitsPerCoroutine * coroutineCount;
+
+			// Each coroutine gets its own input and output, as separate callers would
+			std::vector<int32_t> input(valuesPerAwait * coroutineCount);
+			std::vector<int32_t> output(input.size());
+			std::ranges::generate(input, [&]() { return distribution(generator); });
+			const auto inputOf = [&](size_t coroutine) { return std::span<const int32_t>(input).subspan(coroutine * valuesPerAwait, valuesPerAwait); };
+			const auto outputOf = [&](size_t coroutine) { return std::span<int32_t>(output).subspan(coroutine * valuesPerAwait, valuesPerAwait); };
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (size_t callIndex = 0; callIndex < awaitsPerCoroutine; ++callIndex)
+			{
+				for (size_t coroutine = 0; coroutine < coroutineCount; ++coroutine)
+				{
+					reverseDigits(inputOf(coroutine), outputOf(coroutine));
+				}
+			}
+			const double direct = nanosecondsSince(start, totalAwaits);
+			allCorrect &= matchesReference(input, output);
+
+			std::ranges::fill(output, 0);
+			double async = 0.0;
+			double averageBatch = 0.0;
+			{
+				// Declared first so it outlives the worker, which is still leaving the last coroutine when the latch opens
+				std::latch done(static_cast<ptrdiff_t>(coroutineCount));
+				AsyncReverser reverser;
+
+				start = std::chrono::high_resolution_clock::now();
+				for (size_t coroutine = 0; coroutine < coroutineCount; ++coroutine)
+				{
+					awaitLoop(reverser, inputOf(coroutine), outputOf(coroutine), awaitsPerCoroutine, done);
+				}
+				done.wait();
+				async = nanosecondsSince(start, totalAwaits);
+				averageBatch = static_cast<double>(reverser.operationCount()) / static_cast<double>(std::max<uint64_t>(reverser.batchCount(), 1));
+			}
+			allCorrect &= matchesReference(input, output);
+
+			std::println("{:>13} {:>10} {:>14.1f} {:>14.1f} {:>12.1f} {:>10.1f}", valuesPerAwait, coroutineCount, direct, async, async - direct, averageBatch);
+		}
+	}
+
+	std::println("\nStreaming {:L} values through reverseStream:", streamValues);
+	for (const size_t blockValues : { size_t(256), size_t(4096), size_t(65536) })
+	{
+		uint32_t mismatches = 0;
+		double perValue = 0.0;
+		{
+			std::latch done(1);
+			AsyncReverser reverser;
+
+			int32_t nextValue = 0;
+			size_t remaining = streamValues;
+			const auto source = [&](std::span<int32_t> block)
+			{
+				const size_t count = std::min(block.size(), remaining);
+				for (int32_t& value : block.first(count))
+				{
+					value = nextValue;
+					nextValue += 997;
+				}
+				remaining -= count;
+				return count;
+			};
+
+			const auto start = std::chrono::high_resolution_clock::now();
+			consumeStream(reverseStream(reverser, source, blockValues), mismatches, done);
+			done.wait();
+			perValue = nanosecondsSince(start, streamValues);
+		}
+		allCorrect &= mismatches == 0;
+		std::println("  {:>6} values per block: {:.2f}ns per value, including generating and checking it", blockValues, perValue);
+	}
+
+	if (!allCorrect)
+	{
+		std::println("\n!!!! WRONG RESULTS");
+		return 1;
+	}
+	return 0;
+}
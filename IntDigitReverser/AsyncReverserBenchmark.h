@@ -0,0 +1,17 @@
+/*******************************************************************
+* Cost of awaiting the coroutine API instead of calling the batch
+*	kernel directly.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary>
+/// For several values per await and coroutine counts, times awaitCount co_await reverser.reverseBatch calls against
+///		the same number of direct reverseDigits calls and prints the overhead per await and the average batch the
+///		worker saw, then streams values through reverseStream at a few block sizes. Every result is checked.
+/// </summary>
+/// <param name="awaitCount">Awaits per measurement, fewer for the bigger batches</param>
+/// <returns>Non-zero on wrong results</returns>
+int runAsyncReverserBenchmark(size_t awaitCount);
@@ -0,0 +1,41 @@
+/*******************************************************************
+* The median timing the bench modes share, so their numbers are
+*	comparable: one untimed warmup call, then the median of
+*	benchmarkSampleCount timed samples.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+inline constexpr size_t benchmarkSampleCount = 5;
+
+/// <summary>
+/// Median time per call over benchmarkSampleCount samples, after one untimed warmup call. Each sample averages
+///		callsPerSample calls, so calls too short to time one at a time are timed in a loop.
+/// </summary>
+/// <param name="call"></param>
+/// <param name="callsPerSample"></param>
+/// <returns></returns>
+template<typename Call>
+std::chrono::duration<double, std::nano> medianTimePerCall(Call&& call, size_t callsPerSample = 1)
+{
+	callsPerSample = std::max<size_t>(callsPerSample, 1);
+
+	call();
+	std::array<std::chrono::duration<double, std::nano>, benchmarkSampleCount> samples;
+	for (std::chrono::duration<double, std::nano>& sample : samples)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (size_t callIndex = 0; callIndex < callsPerSample; ++callIndex)
+		{
+			call();
+		}
+		sample = (std::chrono::high_resolution_clock::now() - start) / static_cast<double>(callsPerSample);
+	}
+	std::ranges::nth_element(samples, samples.begin() + benchmarkSampleCount / 2);
+	return samples[benchmarkSampleCount / 2];
+}
@@ -0,0 +1,159 @@
+/*******************************************************************
+* Output file writer with one large, caller-filled buffer.
+*	Callers reserve space, format straight into it and commit,
+*	so nothing is allocated or copied per record.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+
+class BufferedWriter
+{
+public:
+	static constexpr size_t defaultBufferSize = 4 << 20;
+
+	BufferedWriter(BufferedWriter&& other) noexcept
+		: file(std::exchange(other.file, nullptr))
+		, buffer(std::move(other.buffer))
+		, bufferSize(other.bufferSize)
+		, used(other.used)
+		, written(other.written)
+		, hasFailed(other.hasFailed)
+	{
+	}
+
+	BufferedWriter(const BufferedWriter&) = delete;
+	BufferedWriter& operator=(const BufferedWriter&) = delete;
+	BufferedWriter& operator=(BufferedWriter&&) = delete;
+
+	~BufferedWriter()
+	{
+		close();
+	}
+
+	/// <summary>
+	/// Creates or truncates path for writing.
+	/// </summary>
+	/// <param name="path"></param>
+	/// <param name="bufferSize"></param>
+	/// <returns>The writer, or a description of what failed</returns>
+	static std::expected<BufferedWriter, std::string> open(const std::filesystem::path& path, size_t bufferSize = defaultBufferSize)
+	{
+#if defined(_WIN32)
+		std::FILE* file = _wfopen(path.c_str(), L"wb");
+#else
+		std::FILE* file = std::fopen(path.c_str(), "wb");
+#endif
+		if (file == nullptr)
+		{
+			return std::unexpected(std::format("Failed to open {} for writing: {}", path.string(), std::strerror(errno)));
+		}
+		// Everything is already buffered here; stdio's own buffer would just be another copy
+		std::setvbuf(file, nullptr, _IONBF, 0);
+
+		return BufferedWriter(file, bufferSize);
+	}
+
+	/// <summary>
+	/// Returns a cursor with at least maxBytes of room, flushing first if needed. Follow with commit.
+	/// </summary>
+	/// <param name="maxBytes">At most the buffer size</param>
+	/// <returns></returns>
+	char* reserve(size_t maxBytes) noexcept
+	{
+		if (bufferSize - used < maxBytes)
+		{
+			flush();
+		}
+		return buffer.get() + used;
+	}
+
+	/// <summary>
+	/// Marks everything up to end (a cursor from reserve, moved forward) as written.
+	/// </summary>
+	/// <param name="end"></param>
+	void commit(const char* end) noexcept
+	{
+		used = static_cast<size_t>(end - buffer.get());
+	}
+
+	void write(std::span<const char> bytes) noexcept
+	{
+		// Big writes go straight to the file instead of being copied through the buffer
+		if (bytes.size() >= bufferSize)
+		{
+			flush();
+			if (file != nullptr)
+			{
+				hasFailed |= std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size();
+				written += bytes.size();
+			}
+			return;
+		}
+
+		while (!bytes.empty())
+		{
+			const size_t chunk = std::min(bytes.size(), bufferSize);
+			char* const cursor = reserve(chunk);
+			std::memcpy(cursor, bytes.data(), chunk);
+			commit(cursor + chunk);
+			bytes = bytes.subspan(chunk);
+		}
+	}
+
+	void flush() noexcept
+	{
+		if (used != 0 && file != nullptr)
+		{
+			hasFailed |= std::fwrite(buffer.get(), 1, used, file) != used;
+			written += used;
+		}
+		used = 0;
+	}
+
+	/// <summary>
+	/// Flushes and closes the file.
+	/// </summary>
+	/// <returns>False if any write failed</returns>
+	bool close() noexcept
+	{
+		flush();
+		if (file != nullptr)
+		{
+			hasFailed |= std::fclose(file) != 0;
+			file = nullptr;
+		}
+		return !hasFailed;
+	}
+
+	size_t bytesWritten() const noexcept
+	{
+		return written + used;
+	}
+
+private:
+	BufferedWriter(std::FILE* file, size_t bufferSize)
+		: file(file)
+		, buffer(std::make_unique_for_overwrite<char[]>(bufferSize))
+		, bufferSize(bufferSize)
+	{
+	}
+
+	std::FILE* file = nullptr;
+	std::unique_ptr<char[]> buffer;
+	size_t bufferSize = 0;
+	size_t used = 0;
+	size_t written = 0;
+	bool hasFailed = false;
+};
@@ -0,0 +1,133 @@
+/*******************************************************************
+* Closed loop load generation shared by the service benchmarks:
+*	every client sends one request, waits for the reply, checks it
+*	and sends the next, while per request latencies are recorded.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <latch>
+#include <limits>
+#include <print>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ReverseDigits.h"
+
+struct LoadSummary
+{
+	uint64_t requestCount = 0;
+	uint64_t wrongReplies = 0;
+	double seconds = 0.0;
+	std::chrono::nanoseconds p50{};
+	std::chrono::nanoseconds p99{};
+	std::chrono::nanoseconds max{};
+};
+
+/// <summary>
+/// Runs every client on its own thread for requestCount round trips of valuesPerRequest random values each,
+///		checking every reply against reverseDigits_ModuloLookup.
+/// </summary>
+/// <typeparam name="Client">Callable as bool(std::span&lt;const int32_t&gt; values, std::span&lt;int32_t&gt; reversed), false on failure</typeparam>
+/// <param name="clients">One per thread, already connected</param>
+/// <param name="requestCount">Per client</param>
+/// <param name="valuesPerRequest"></param>
+/// <returns>The latency distribution, or a description of what failed</returns>
+template<typename Client>
+std::expected<LoadSummary, std::string> measureClosedLoop(std::span<Client> clients, size_t requestCount, size_t valuesPerRequest)
+{
+	std::vector<std::vector<std::chrono::nanoseconds>> latencies(clients.size());
+	std::atomic<uint64_t> wrongReplies = 0;
+	std::atomic<bool> failed = false;
+	std::latch startLatch(static_cast<ptrdiff_t>(clients.size()) + 1);
+
+	std::chrono::high_resolution_clock::time_point startTime;
+	{
+		std::vector<std::jthread> threads;
+		for (size_t clientIndex = 0; clientIndex < clients.size(); ++clientIndex)
+		{
+			threads.emplace_back([&, clientIndex]()
+			{
+				Client& client = clients[clientIndex];
+				std::vector<std::chrono::nanoseconds>& clientLatencies = latencies[clientIndex];
+				clientLatencies.reserve(requestCount);
+
+				std::mt19937 generator(static_cast<uint32_t>(clientIndex));
+				std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::lowest(), std::numeric_limits<int32_t>::max());
+
+				std::vector<int32_t> values(valuesPerRequest);
+				std::vector<int32_t> reversed(valuesPerRequest);
+
+				startLatch.arrive_and_wait();
+				for (size_t requestIndex = 0; requestIndex < requestCount && !failed; ++requestIndex)
+				{
+					std::ranges::generate(values, [&]() { return distribution(generator); });
+
+					const auto requestStart = std::chrono::high_resolution_clock::now();
+					if (!client(std::span<const int32_t>(values), std::span<int32_t>(reversed)))
+					{
+						failed = true;
+						break;
+					}
+					clientLatencies.push_back(std::chrono::high_resolution_clock::now() - requestStart);
+
+					bool matches = true;
+					for (size_t valueIndex = 0; valueIndex < values.size(); ++valueIndex)
+					{
+						matches &= reversed[valueIndex] == reverseDigits_ModuloLookup(values[valueIndex]);
+					}
+					wrongReplies += matches ? 0 : 1;
+				}
+			});
+		}
+
+		startTime = std::chrono::high_resolution_clock::now();
+		startLatch.arrive_and_wait();
+	}
+	const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+
+	if (failed)
+	{
+		return std::unexpected(std::string("A client failed mid run"));
+	}
+
+	std::vector<std::chrono::nanoseconds> allLatencies;
+	for (const std::vector<std::chrono::nanoseconds>& clientLatencies : latencies)
+	{
+		allLatencies.insert(allLatencies.end(), clientLatencies.begin(), clientLatencies.end());
+	}
+	std::ranges::sort(allLatencies);
+
+	LoadSummary summary;
+	summary.requestCount = allLatencies.size();
+	summary.wrongReplies = wrongReplies;
+	summary.seconds = std::max(duration.count(), 1e-9);
+	if (!allLatencies.empty())
+	{
+		summary.p50 = allLatencies[(allLatencies.size() - 1) / 2];
+		summary.p99 = allLatencies[(allLatencies.size() - 1) * 99 / 100];
+		summary.max = allLatencies.back();
+	}
+	return summary;
+}
+
+inline void printLoadSummary(const LoadSummary& summary, size_t valuesPerRequest)
+{
+	const auto toMicroseconds = [](std::chrono::nanoseconds duration) { return std::chrono::duration<double, std::micro>(duration).count(); };
+
+	std::println("  p50 {:.2f}us, p99 {:.2f}us, max {:.1f}us, {:.0f} requests/s, {:.2f} Mvalues/s{}",
+		toMicroseconds(summary.p50), toMicroseconds(summary.p99), toMicroseconds(summary.max),
+		static_cast<double>(summary.requestCount) / summary.seconds,
+		static_cast<double>(summary.requestCount * valuesPerRequest) / summary.seconds / 1e6,
+		summary.wrongReplies == 0 ? "" : std::format("  !!!! {} WRONG REPLIES", summary.wrongReplies));
+}
@@ -0,0 +1,105 @@
+/*******************************************************************
+* Binary columnar file format for handing values between processes
+*	without going through text.
+*
+*	Layout: one 64 byte header, then count packed values of
+*	valueWidth bytes each in the declared byte order. The header
+*	is always little endian and its size keeps the values cache
+*	line aligned in a memory mapping. Only 4 byte (int32) values
+*	are accepted so far.
+*******************************************************************/
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <span>
+#include <string>
+
+enum class ColumnEndianness : uint8_t
+{
+	Little = 0,
+	Big = 1,
+};
+
+inline constexpr ColumnEndianness nativeColumnEndianness = std::endian::native == std::endian::big ? ColumnEndianness::Big : ColumnEndianness::Little;
+
+inline constexpr char columnFileMagic[8] = { 'I', 'D', 'R', 'C', 'O', 'L', '0', '1' };
+inline constexpr size_t columnHeaderSize = 64;
+
+struct ColumnFileHeader
+{
+	uint8_t valueWidth = sizeof(int32_t);
+	ColumnEndianness endianness = nativeColumnEndianness;
+	uint64_t count = 0;
+
+	size_t dataSize() const noexcept
+	{
+		return static_cast<size_t>(count) * valueWidth;
+	}
+};
+
+/// <summary>
+/// Serializes header into the first columnHeaderSize bytes of out.
+/// </summary>
+/// <param name="header"></param>
+/// <param name="out">Must be at least columnHeaderSize bytes</param>
+inline void writeColumnHeader(const ColumnFileHeader& header, std::span<char> out) noexcept
+{
+	std::memset(out.data(), 0, columnHeaderSize);
+	std::memcpy(out.data(), columnFileMagic, sizeof(columnFileMagic));
+	out[8] = static_cast<char>(header.valueWidth);
+	out[9] = static_cast<char>(header.endianness);
+
+	const uint64_t count = std::endian::native == std::endian::little ? header.count : std::byteswap(header.count);
+	std::memcpy(out.data() + 16, &count, sizeof(count));
+}
+
+/// <summary>
+/// Parses and checks a column file header, rejecting any value width but 4.
+/// </summary>
+/// <param name="headerBytes">The first columnHeaderSize (or more) bytes of the file</param>
+/// <param name="fileSize">Size of the whole file, so the value count can be checked against it</param>
+/// <returns>The header, or a description of what is wrong with it</returns>
+inline std::expected<ColumnFileHeader, std::string> readColumnHeader(std::span<const char> headerBytes, uint64_t fileSize)
+{
+	if (headerBytes.size() < columnHeaderSize || fileSize < columnHeaderSize || std::memcmp(headerBytes.data(), columnFileMagic, sizeof(columnFileMagic)) != 0)
+	{
+		return std::unexpected(std::string("not a column file"));
+	}
+
+	ColumnFileHeader header;
+	header.valueWidth = static_cast<uint8_t>(headerBytes[8]);
+	header.endianness = static_cast<ColumnEndianness>(headerBytes[9]);
+
+	uint64_t count = 0;
+	std::memcpy(&count, headerBytes.data() + 16, sizeof(count));
+	header.count = std::endian::native == std::endian::little ? count : std::byteswap(count);
+
+	if (header.valueWidth != sizeof(int32_t))
+	{
+		return std::unexpected(std::format("{} byte values aren't supported, only 4 byte int32", header.valueWidth));
+	}
+	if (header.endianness != ColumnEndianness::Little && header.endianness != ColumnEndianness::Big)
+	{
+		return std::unexpected(std::format("invalid endianness {}", static_cast<int>(header.endianness)));
+	}
+	if (header.count > (fileSize - columnHeaderSize) / header.valueWidth)
+	{
+		return std::unexpected(std::format("header claims {} values but the file only holds {}", header.count, (fileSize - columnHeaderSize) / header.valueWidth));
+	}
+	return header;
+}
+
+/// <summary>
+/// Parses and checks the header at the front of a whole column file.
+/// </summary>
+/// <param name="file">The entire file</param>
+/// <returns>The header, or a description of what is wrong with it</returns>
+inline std::expected<ColumnFileHeader, std::string> readColumnHeader(std::span<const char> file)
+{
+	return readColumnHeader(file, file.size());
+}
@@ -0,0 +1,533 @@
+/*******************************************************************
+* Column file reversers: mmap in, cache sized blocks through the
+*	batch kernel straight into the output buffer; or overlapped
+*	block reads, reversal and writes through io_uring or a pool
+*	of pread / pwrite threads.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+#include <cstdio>
+
+#include "BufferedWriter.h"
+#include "ColumnFile.h"
+#include "ColumnFileReverser.h"
+#include "IoUring.h"
+#include "MappedFile.h"
+#include "PositionalFile.h"
+#include "ReverseDigits.h"
+
+namespace
+{
+	constexpr size_t cacheLineSize = 64;
+	constexpr size_t pageSize = 4096;
+
+	// Keeps the bandwidth measurement's copies from being optimized out
+	volatile char copySink;
+
+	/// <summary>
+	/// Best of a few large memcpys, as the read + write bandwidth the reverser should be compared with.
+	/// </summary>
+	/// <returns>Bytes read plus bytes written per second</returns>
+	double measureCopyBandwidth()
+	{
+		// Well past any last level cache
+		constexpr size_t copyBytes = 256 << 20;
+		constexpr size_t repeatCount = 3;
+
+		std::vector<char> source(copyBytes, 1);
+		std::vector<char> destination(copyBytes, 0);
+
+		double bestSeconds = std::numeric_limits<double>::max();
+		for (size_t repeatIndex = 0; repeatIndex < repeatCount; ++repeatIndex)
+		{
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			std::memcpy(destination.data(), source.data(), copyBytes);
+			const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+			bestSeconds = std::min(bestSeconds, duration.count());
+			copySink = destination[repeatIndex];
+		}
+
+		return 2.0 * static_cast<double>(copyBytes) / std::max(bestSeconds, 1e-9);
+	}
+
+	/// <summary>
+	/// What every async backend needs to know about one reversal job.
+	/// </summary>
+	struct AsyncColumnJob
+	{
+		const PositionalFile& input;
+		const PositionalFile& output;
+		uint64_t dataBytes;
+		size_t blockBytes;
+		size_t blockCount;
+		bool needsByteSwap;
+
+		uint64_t blockOffset(size_t blockIndex) const noexcept
+		{
+			return columnHeaderSize + static_cast<uint64_t>(blockIndex) * blockBytes;
+		}
+
+		size_t blockLength(size_t blockIndex) const noexcept
+		{
+			return static_cast<size_t>(std::min<uint64_t>(blockBytes, dataBytes - static_cast<uint64_t>(blockIndex) * blockBytes));
+		}
+	};
+
+	/// <summary>
+	/// The compute stage: reverses a block of raw file bytes in place, converting to native byte order.
+	/// </summary>
+	/// <param name="bytes">Page aligned, a whole number of values</param>
+	/// <param name="needsByteSwap"></param>
+	void reverseColumnBlock(std::span<char> bytes, bool needsByteSwap)
+	{
+		const std::span<int32_t> values(reinterpret_cast<int32_t*>(bytes.data()), bytes.size() / sizeof(int32_t));
+		if (needsByteSwap)
+		{
+			std::ranges::transform(values, values.begin(), [](int32_t value) { return std::byteswap(value); });
+		}
+		reverseDigits(values, values);
+	}
+
+	/// <summary>
+	/// Every one of queueDepth threads claims the next block, preads it into its own buffer, reverses it and pwrites it.
+	///		With enough threads some are always blocked in I/O while others compute.
+	/// </summary>
+	/// <param name="job"></param>
+	/// <param name="buffers">queueDepth buffers of job.blockBytes</param>
+	/// <returns>False on I/O errors</returns>
+	bool runThreadPoolPipeline(const AsyncColumnJob& job, std::span<const std::span<char>> buffers)
+	{
+		std::atomic<size_t> nextBlock = 0;
+		std::atomic<bool> failed = false;
+
+		{
+			std::vector<std::jthread> workers;
+			for (const std::span<char> buffer : buffers)
+			{
+				workers.emplace_back([&job, &nextBlock, &failed, buffer]()
+				{
+					for (size_t blockIndex = nextBlock++; blockIndex < job.blockCount && !failed; blockIndex = nextBlock++)
+					{
+						const std::span<char> block = buffer.first(job.blockLength(blockIndex));
+						if (!job.input.readAt(block, job.blockOffset(blockIndex)))
+						{
+							failed = true;
+							break;
+						}
+						reverseColumnBlock(block, job.needsByteSwap);
+						if (!job.output.writeAt(block, job.blockOffset(blockIndex)))
+						{
+							failed = true;
+							break;
+						}
+					}
+				});
+			}
+		}
+
+		return !failed;
+	}
+
+#if IOURING_AVAILABLE
+	/// <summary>
+	/// One registered buffer per slot, each cycling read -> reverse -> write -> next block. The reversal runs on this
+	///		thread between submissions, so it overlaps with the kernel servicing every other slot's I/O.
+	/// </summary>
+	/// <param name="job"></param>
+	/// <param name="ring">Must hold at least buffers.size() submissions</param>
+	/// <param name="buffers">Already registered with ring, in this order</param>
+	/// <param name="buffersAbandoned">Set if requests were left in flight and the ring abandoned; the caller must then leak the buffers</param>
+	/// <returns>False on I/O errors</returns>
+	bool runIoUringPipeline(const AsyncColumnJob& job, IoUring& ring, std::span<const std::span<char>> buffers, bool& buffersAbandoned)
+	{
+		enum class SlotStage
+		{
+			Reading,
+			Writing,
+		};
+
+		struct Slot
+		{
+			size_t blockIndex = 0;
+			size_t length = 0;
+			size_t transferred = 0;
+			SlotStage stage = SlotStage::Reading;
+		};
+
+		std::vector<Slot> slots(buffers.size());
+		size_t nextBlock = 0;
+		size_t completedBlocks = 0;
+		size_t inFlight = 0;
+
+		const auto submitRead = [&](size_t slotIndex)
+		{
+			Slot& slot = slots[slotIndex];
+			const std::span<char> remaining = buffers[slotIndex].subspan(slot.transferred, slot.length - slot.transferred);
+			ring.prepareReadFixed(job.input.descriptor(), static_cast<uint16_t>(slotIndex), remaining, job.blockOffset(slot.blockIndex) + slot.transferred, slotIndex);
+			++inFlight;
+		};
+		const auto submitWrite = [&](size_t slotIndex)
+		{
+			Slot& slot = slots[slotIndex];
+			const std::span<char> remaining = buffers[slotIndex].subspan(slot.transferred, slot.length - slot.transferred);
+			ring.prepareWriteFixed(job.output.descriptor(), static_cast<uint16_t>(slotIndex), remaining, job.blockOffset(slot.blockIndex) + slot.transferred, slotIndex);
+			++inFlight;
+		};
+		const auto startNextBlock = [&](size_t slotIndex)
+		{
+			if (nextBlock < job.blockCount)
+			{
+				slots[slotIndex] = { nextBlock, job.blockLength(nextBlock), 0, SlotStage::Reading };
+				++nextBlock;
+				submitRead(slotIndex);
+			}
+		};
+
+		for (size_t slotIndex = 0; slotIndex < slots.size(); ++slotIndex)
+		{
+			startNextBlock(slotIndex);
+		}
+
+		bool failed = false;
+		while (completedBlocks < job.blockCount && !failed)
+		{
+			// Still falls through to the drain below: earlier submissions may be reading or writing the buffers
+			if (!ring.submitAndWait(1))
+			{
+				failed = true;
+				break;
+			}
+
+			ring.forEachCompletion([&](uint64_t slotIndex, int32_t result)
+			{
+				--inFlight;
+				Slot& slot = slots[slotIndex];
+				if (failed)
+				{
+					return;
+				}
+
+				// Reads past the end return 0, which can only mean the file shrank underneath us
+				if (result <= 0)
+				{
+					failed = true;
+					return;
+				}
+
+				// Short transfers are rare on regular files, but legal; resubmit the rest
+				slot.transferred += static_cast<size_t>(result);
+				if (slot.transferred < slot.length)
+				{
+					slot.stage == SlotStage::Reading ? submitRead(slotIndex) : submitWrite(slotIndex);
+					return;
+				}
+
+				if (slot.stage == SlotStage::Reading)
+				{
+					reverseColumnBlock(buffers[slotIndex].first(slot.length), job.needsByteSwap);
+					slot.stage = SlotStage::Writing;
+					slot.transferred = 0;
+					submitWrite(slotIndex);
+				}
+				else
+				{
+					++completedBlocks;
+					startNextBlock(slotIndex);
+				}
+			});
+		}
+
+		// Never leave requests in flight into buffers that are about to be freed: whatever wasn't submitted is dropped,
+		//	and the rest is waited for without submitting anything new
+		inFlight -= ring.discardUnsubmitted();
+		while (inFlight != 0)
+		{
+			if (!ring.waitForCompletions(1))
+			{
+				ring.abandon();
+				buffersAbandoned = true;
+				return false;
+			}
+			inFlight -= ring.forEachCompletion([](uint64_t, int32_t) {});
+		}
+
+		return !failed;
+	}
+#endif
+}
+
+int runReverseColumnFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, size_t blockBytes)
+{
+	const size_t blockValues = std::max(blockBytes / cacheLineSize, size_t(1)) * cacheLineSize / sizeof(int32_t);
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	std::expected<MappedFile, std::string> input = MappedFile::openReadOnly(inputPath);
+	if (!input)
+	{
+		std::println(stderr, "{}", input.error());
+		return 1;
+	}
+
+	const std::expected<ColumnFileHeader, std::string> header = readColumnHeader(input->chars());
+	if (!header)
+	{
+		std::println(stderr, "{}: {}", inputPath.string(), header.error());
+		return 1;
+	}
+	const bool needsByteSwap = header->endianness != nativeColumnEndianness;
+
+	// The output buffer has to hold a whole block so it can be reversed into directly
+	std::expected<BufferedWriter, std::string> output = BufferedWriter::open(outputPath, std::max(BufferedWriter::defaultBufferSize, blockValues * sizeof(int32_t)));
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	ColumnFileHeader outputHeader = *header;
+	outputHeader.endianness = nativeColumnEndianness;
+	char* const headerCursor = output->reserve(columnHeaderSize);
+	writeColumnHeader(outputHeader, std::span(headerCursor, columnHeaderSize));
+	output->commit(headerCursor + columnHeaderSize);
+
+	// The mapping is page aligned and the header is a cache line, so the values are too
+	const std::span<const int32_t> values(reinterpret_cast<const int32_t*>(input->chars().data() + columnHeaderSize), header->count);
+
+	std::chrono::high_resolution_clock::duration kernelDuration{};
+	for (size_t blockStart = 0; blockStart < values.size(); blockStart += blockValues)
+	{
+		const std::span<const int32_t> block = values.subspan(blockStart, std::min(blockValues, values.size() - blockStart));
+
+		char* const cursor = output->reserve(block.size_bytes());
+		const std::span<int32_t> reversed(reinterpret_cast<int32_t*>(cursor), block.size());
+
+		const auto blockStartTime = std::chrono::high_resolution_clock::now();
+		if (needsByteSwap)
+		{
+			std::ranges::transform(block, reversed.begin(), [](int32_t value) { return std::byteswap(value); });
+			reverseDigits(reversed, reversed);
+		}
+		else
+		{
+			reverseDigits(block, reversed);
+		}
+		kernelDuration += std::chrono::high_resolution_clock::now() - blockStartTime;
+
+		output->commit(cursor + block.size_bytes());
+	}
+
+	const size_t outputBytes = output->bytesWritten();
+	if (!output->close())
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+	const double seconds = std::max(duration.count(), 1e-9);
+	const double kernelSeconds = std::max(std::chrono::duration_cast<std::chrono::duration<double>>(kernelDuration).count(), 1e-9);
+
+	// Bytes moved through memory: every value is read once and written once
+	const double movedBytes = 2.0 * static_cast<double>(values.size_bytes());
+	const double copyBandwidth = measureCopyBandwidth();
+
+	std::println("Reversed {:L} values ({:L} bytes out) in {:.3f}s, {:L} byte blocks, {}{}", values.size(), outputBytes, seconds,
+		blockValues * sizeof(int32_t), toString(batchSimdLevel()), needsByteSwap ? ", byte swapped" : "");
+	std::println("  end to end {:.3f} GB/s read + write, {:.1f}% of memcpy", movedBytes / seconds / 1e9, 100.0 * movedBytes / seconds / copyBandwidth);
+	std::println("  kernel     {:.3f} GB/s read + write, {:.1f}% of memcpy", movedBytes / kernelSeconds / 1e9, 100.0 * movedBytes / kernelSeconds / copyBandwidth);
+	std::println("  memcpy     {:.3f} GB/s read + write", copyBandwidth / 1e9);
+	return 0;
+}
+
+std::string_view toString(AsyncFileBackend backend)
+{
+	switch (backend)
+	{
+	case AsyncFileBackend::Auto:
+		return "Auto";
+	case AsyncFileBackend::IoUring:
+		return "io_uring";
+	case AsyncFileBackend::ThreadPool:
+		return "pread/pwrite thread pool";
+	}
+	return "Unknown";
+}
+
+int runReverseColumnFileAsync(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, size_t blockBytes, size_t queueDepth, AsyncFileBackend backend)
+{
+	blockBytes = std::clamp(blockBytes / pageSize, size_t(1), maxColumnBlockBytes / pageSize) * pageSize;
+	queueDepth = std::clamp(queueDepth, size_t(1), maxColumnQueueDepth);
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	std::expected<PositionalFile, std::string> input = PositionalFile::openRead(inputPath);
+	if (!input)
+	{
+		std::println(stderr, "{}", input.error());
+		return 1;
+	}
+
+	std::array<char, columnHeaderSize> headerBytes = {};
+	const int64_t inputSize = input->size();
+	if (inputSize < 0 || !input->readAt(std::span(headerBytes.data(), std::min<size_t>(headerBytes.size(), static_cast<size_t>(inputSize))), 0))
+	{
+		std::println(stderr, "Failed reading {}", inputPath.string());
+		return 1;
+	}
+
+	const std::expected<ColumnFileHeader, std::string> header = readColumnHeader(headerBytes, static_cast<uint64_t>(inputSize));
+	if (!header)
+	{
+		std::println(stderr, "{}: {}", inputPath.string(), header.error());
+		return 1;
+	}
+
+	std::expected<PositionalFile, std::string> output = PositionalFile::create(outputPath);
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	ColumnFileHeader outputHeader = *header;
+	outputHeader.endianness = nativeColumnEndianness;
+	writeColumnHeader(outputHeader, headerBytes);
+	if (!output->writeAt(headerBytes, 0))
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	const AsyncColumnJob job = {
+		.input = *input,
+		.output = *output,
+		.dataBytes = header->dataSize(),
+		.blockBytes = blockBytes,
+		.blockCount = static_cast<size_t>((header->dataSize() + blockBytes - 1) / blockBytes),
+		.needsByteSwap = header->endianness != nativeColumnEndianness,
+	};
+
+	// One page aligned allocation carved into queueDepth blocks, which is also what gets registered with io_uring
+	if (blockBytes > (std::numeric_limits<size_t>::max() - pageSize) / queueDepth)
+	{
+		std::println(stderr, "{} x {:L} byte blocks don't fit the address space", queueDepth, blockBytes);
+		return 1;
+	}
+	std::unique_ptr<char[]> bufferStorage(new (std::nothrow) char[queueDepth * blockBytes + pageSize]);
+	if (!bufferStorage)
+	{
+		std::println(stderr, "Failed to allocate {} x {:L} byte blocks", queueDepth, blockBytes);
+		return 1;
+	}
+	char* const alignedStorage = bufferStorage.get() + (pageSize - reinterpret_cast<uintptr_t>(bufferStorage.get()) % pageSize) % pageSize;
+	std::vector<std::span<char>> buffers;
+	for (size_t bufferIndex = 0; bufferIndex < queueDepth; ++bufferIndex)
+	{
+		buffers.emplace_back(alignedStorage + bufferIndex * blockBytes, blockBytes);
+	}
+
+	AsyncFileBackend usedBackend = AsyncFileBackend::ThreadPool;
+	bool succeeded = false;
+#if IOURING_AVAILABLE
+	if (backend != AsyncFileBackend::ThreadPool)
+	{
+		std::expected<IoUring, std::string> ring = IoUring::create(static_cast<unsigned>(queueDepth));
+		if (ring)
+		{
+			std::vector<iovec> registered;
+			for (const std::span<char> buffer : buffers)
+			{
+				registered.push_back({ buffer.data(), buffer.size() });
+			}
+			if (!ring->registerBuffers(registered))
+			{
+				ring = std::unexpected(std::format("Registering {} io_uring buffers failed: {}", registered.size(), std::strerror(errno)));
+			}
+		}
+
+		if (ring)
+		{
+			usedBackend = AsyncFileBackend::IoUring;
+			bool buffersAbandoned = false;
+			succeeded = runIoUringPipeline(job, *ring, buffers, buffersAbandoned);
+			if (buffersAbandoned)
+			{
+				// The kernel may still read or write them
+				static_cast<void>(bufferStorage.release());
+			}
+		}
+		else if (backend == AsyncFileBackend::IoUring)
+		{
+			std::println(stderr, "{}", ring.error());
+			return 1;
+		}
+		else
+		{
+			std::println("{}, falling back to {}", ring.error(), toString(AsyncFileBackend::ThreadPool));
+		}
+	}
+#else
+	if (backend == AsyncFileBackend::IoUring)
+	{
+		std::println(stderr, "io_uring isn't available on this platform");
+		return 1;
+	}
+#endif
+	if (usedBackend == AsyncFileBackend::ThreadPool)
+	{
+		succeeded = runThreadPoolPipeline(job, buffers);
+	}
+
+	if (!succeeded)
+	{
+		std::println(stderr, "I/O failed reversing {} into {}", inputPath.string(), outputPath.string());
+		return 1;
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+	const double seconds = std::max(duration.count(), 1e-9);
+	const double movedBytes = 2.0 * static_cast<double>(job.dataBytes);
+
+	std::println("Reversed {:L} values in {:.3f}s with {}, {} x {:L} byte blocks in flight, {}{}", header->count, seconds, toString(usedBackend),
+		queueDepth, blockBytes, toString(batchSimdLevel()), job.needsByteSwap ? ", byte swapped" : "");
+	std::println("  end to end {:.3f} GB/s read + write, {:.2f} Mvalues/s", movedBytes / seconds / 1e9, static_cast<double>(header->count) / seconds / 1e6);
+	return 0;
+}
+
+int runGenerateColumnFile(const std::filesystem::path& outputPath, uint64_t count)
+{
+	std::expected<BufferedWriter, std::string> output = BufferedWriter::open(outputPath);
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	char* const headerCursor = output->reserve(columnHeaderSize);
+	writeColumnHeader(ColumnFileHeader{ .count = count }, std::span(headerCursor, columnHeaderSize));
+	output->commit(headerCursor + columnHeaderSize);
+
+	// Same seed as generate-text, so both files hold the same values
+	std::mt19937 generator(12345);
+	std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::lowest(), std::numeric_limits<int32_t>::max());
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		const int32_t value = distribution(generator);
+		char* const cursor = output->reserve(sizeof(value));
+		std::memcpy(cursor, &value, sizeof(value));
+		output->commit(cursor + sizeof(value));
+	}
+
+	if (!output->close())
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	std::println("Wrote {:L} values to {}", count, outputPath.string());
+	return 0;
+}
@@ -0,0 +1,61 @@
+/*******************************************************************
+* File modes for the binary columnar format in ColumnFile.h.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// A quarter of a typical per-core L2, so a block's input and output both stay cache resident
+inline constexpr size_t defaultColumnBlockBytes = 256 << 10;
+
+/// <summary>
+/// Reverses every value of a 4 byte column file into a new column file in native byte order, and prints
+///		throughput next to this machine's memcpy bandwidth. The input is memory mapped and handed to the
+///		batch kernel blockBytes at a time, writing straight into the output buffer.
+/// </summary>
+/// <param name="inputPath"></param>
+/// <param name="outputPath"></param>
+/// <param name="blockBytes">Rounded down to a whole cache line, at least one</param>
+/// <returns>Non-zero on I/O errors or an unsupported column</returns>
+int runReverseColumnFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, size_t blockBytes);
+
+// Blocks in flight at once in reverse-file-async
+inline constexpr size_t defaultColumnQueueDepth = 8;
+// reverse-file-async's limits: io_uring registers at most 1 GiB per buffer, and the fallback starts a thread per block in flight
+inline constexpr size_t maxColumnBlockBytes = size_t(1) << 30;
+inline constexpr size_t maxColumnQueueDepth = 4096;
+
+enum class AsyncFileBackend
+{
+	Auto,
+	IoUring,
+	ThreadPool,
+};
+
+std::string_view toString(AsyncFileBackend backend);
+
+/// <summary>
+/// Same result as runReverseColumnFile, but with reads, reversal and writes of different blocks overlapping:
+///		an io_uring with queueDepth registered block buffers, reversing each block in place as its read completes
+///		and writing it back from the same buffer, or queueDepth threads doing pread, reverse, pwrite where
+///		io_uring isn't available. Prints end to end throughput.
+/// </summary>
+/// <param name="inputPath"></param>
+/// <param name="outputPath"></param>
+/// <param name="blockBytes">Rounded down to a whole page, at least one and at most maxColumnBlockBytes</param>
+/// <param name="queueDepth">Clamped to 1 to maxColumnQueueDepth</param>
+/// <param name="backend">Auto tries io_uring first and falls back to the thread pool</param>
+/// <returns>Non-zero on I/O errors, an unsupported column or an unavailable backend</returns>
+int runReverseColumnFileAsync(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, size_t blockBytes, size_t queueDepth, AsyncFileBackend backend);
+
+/// <summary>
+/// Writes a column file of count uniformly random int32 values, in native byte order, from a fixed seed.
+/// </summary>
+/// <param name="outputPath"></param>
+/// <param name="count"></param>
+/// <returns>Non-zero on I/O errors</returns>
+int runGenerateColumnFile(const std::filesystem::path& outputPath, uint64_t count);
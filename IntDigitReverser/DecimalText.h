@@ -0,0 +1,235 @@
+/*******************************************************************
+* Fast decimal text helpers for the file processing modes:
+*	SIMD newline scanning, SWAR int32 parsing and table driven
+*	int32 formatting. None of them allocate.
+*******************************************************************/
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <emmintrin.h>
+#define DECIMALTEXT_SSE2 1
+#else
+#define DECIMALTEXT_SSE2 0
+#endif
+
+// Longest int32 in decimal, "-2147483648"
+inline constexpr size_t maxDecimalInt32Length = 11;
+
+/// <summary>
+/// Bit N is set if data[N] == delimiter, for the 64 bytes starting at data.
+///		Four 16 byte compares + movemask with SSE2 (which every x64 CPU has), a plain loop elsewhere.
+/// </summary>
+/// <param name="data">Must have at least 64 readable bytes</param>
+/// <param name="delimiter"></param>
+/// <returns></returns>
+inline uint64_t delimiterMask64(const char* data, char delimiter) noexcept
+{
+#if DECIMALTEXT_SSE2
+	const __m128i pattern = _mm_set1_epi8(delimiter);
+	uint64_t mask = 0;
+	for (int lane = 0; lane < 4; ++lane)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + lane * 16));
+		const uint32_t laneMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, pattern)));
+		mask |= static_cast<uint64_t>(laneMask) << (lane * 16);
+	}
+	return mask;
+#else
+	uint64_t mask = 0;
+	for (int index = 0; index < 64; ++index)
+	{
+		mask |= static_cast<uint64_t>(data[index] == delimiter) << index;
+	}
+	return mask;
+#endif
+}
+
+/// <summary>
+/// Calls onField(begin, end) for every delimiter separated field of text, including a final unterminated one.
+///		onField returns false to stop early.
+/// </summary>
+/// <param name="text"></param>
+/// <param name="delimiter"></param>
+/// <param name="onField"></param>
+/// <returns>False if onField stopped the scan</returns>
+template<typename OnField>
+bool forEachDelimitedField(std::string_view text, char delimiter, OnField&& onField)
+{
+	const char* const data = text.data();
+	const size_t size = text.size();
+
+	size_t fieldBegin = 0;
+	size_t position = 0;
+	for (; position + 64 <= size; position += 64)
+	{
+		for (uint64_t mask = delimiterMask64(data + position, delimiter); mask != 0; mask &= mask - 1)
+		{
+			const size_t fieldEnd = position + static_cast<size_t>(std::countr_zero(mask));
+			if (!onField(data + fieldBegin, data + fieldEnd))
+			{
+				return false;
+			}
+			fieldBegin = fieldEnd + 1;
+		}
+	}
+
+	for (; position < size; ++position)
+	{
+		if (data[position] == delimiter)
+		{
+			if (!onField(data + fieldBegin, data + position))
+			{
+				return false;
+			}
+			fieldBegin = position + 1;
+		}
+	}
+
+	if (fieldBegin < size)
+	{
+		return onField(data + fieldBegin, data + size);
+	}
+	return true;
+}
+
+/// <summary>
+/// True if all 8 bytes of chunk are '0'-'9'.
+/// </summary>
+/// <param name="chunk"></param>
+/// <returns></returns>
+constexpr bool isEightDigits(uint64_t chunk) noexcept
+{
+	return (((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333);
+}
+
+/// <summary>
+/// Converts 8 ASCII digits loaded little-endian (first character in the lowest byte) in three multiplies,
+///		combining neighboring digits, then pairs, then quads.
+/// </summary>
+/// <param name="chunk"></param>
+/// <returns></returns>
+constexpr uint32_t parseEightDigits(uint64_t chunk) noexcept
+{
+	uint64_t digits = chunk - 0x3030303030303030;
+	digits = (digits * 10) + (digits >> 8);
+	digits = (((digits & 0x000000FF000000FF) * (100 + (1'000'000ull << 32))) + (((digits >> 16) & 0x000000FF000000FF) * (1 + (10'000ull << 32)))) >> 32;
+	return static_cast<uint32_t>(digits);
+}
+
+/// <summary>
+/// Parses an optionally negative decimal int32 with no other characters.
+///		Up to 8 digits are checked and converted in one SWAR step, 9 and 10 digit values in two.
+/// </summary>
+/// <param name="text"></param>
+/// <param name="value"></param>
+/// <returns>False if text isn't a valid int32</returns>
+inline bool parseDecimalInt32(std::string_view text, int32_t& value) noexcept
+{
+	const bool negate = !text.empty() && text.front() == '-';
+	if (negate)
+	{
+		text.remove_prefix(1);
+	}
+
+	const size_t digitCount = text.size();
+	if (digitCount == 0 || digitCount > 10)
+	{
+		return false;
+	}
+
+	uint64_t magnitude = 0;
+	if constexpr (std::endian::native == std::endian::little)
+	{
+		const size_t headCount = digitCount > 8 ? digitCount - 8 : 0;
+		for (size_t index = 0; index < headCount; ++index)
+		{
+			const char digit = text[index];
+			if (digit < '0' || digit > '9')
+			{
+				return false;
+			}
+			magnitude = magnitude * 10 + static_cast<uint64_t>(digit - '0');
+		}
+
+		// Left pad with '0' so the digits line up with the low end of the 8 digit block
+		const size_t tailCount = digitCount - headCount;
+		uint64_t chunk = 0x3030303030303030;
+		std::memcpy(reinterpret_cast<char*>(&chunk) + (8 - tailCount), text.data() + headCount, tailCount);
+		if (!isEightDigits(chunk))
+		{
+			return false;
+		}
+		magnitude = magnitude * 100'000'000 + parseEightDigits(chunk);
+	}
+	else
+	{
+		for (const char digit : text)
+		{
+			if (digit < '0' || digit > '9')
+			{
+				return false;
+			}
+			magnitude = magnitude * 10 + static_cast<uint64_t>(digit - '0');
+		}
+	}
+
+	const uint64_t limit = negate ? 2'147'483'648ull : 2'147'483'647ull;
+	if (magnitude > limit)
+	{
+		return false;
+	}
+
+	value = negate ? static_cast<int32_t>(0 - magnitude) : static_cast<int32_t>(magnitude);
+	return true;
+}
+
+// "00" "01" ... "99", so two digits are written per division
+inline constexpr char decimalDigitPairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/// <summary>
+/// Writes value in decimal to out, two digits per step.
+/// </summary>
+/// <param name="value"></param>
+/// <param name="out">Must have room for maxDecimalInt32Length characters</param>
+/// <returns>One past the last character written</returns>
+inline char* formatDecimalInt32(int32_t value, char* out) noexcept
+{
+	uint32_t magnitude = static_cast<uint32_t>(value);
+	if (value < 0)
+	{
+		*out++ = '-';
+		magnitude = 0u - magnitude;
+	}
+
+	char digits[10];
+	char* cursor = std::end(digits);
+	while (magnitude >= 100)
+	{
+		const uint32_t pair = magnitude % 100;
+		magnitude /= 100;
+		cursor -= 2;
+		std::memcpy(cursor, decimalDigitPairs + pair * 2, 2);
+	}
+	if (magnitude >= 10)
+	{
+		cursor -= 2;
+		std::memcpy(cursor, decimalDigitPairs + magnitude * 2, 2);
+	}
+	else
+	{
+		*--cursor = static_cast<char>('0' + magnitude);
+	}
+
+	const size_t length = static_cast<size_t>(std::end(digits) - cursor);
+	std::memcpy(out, cursor, length);
+	return out + length;
+}
@@ -0,0 +1,310 @@
+/*******************************************************************
+* Fixed-width digit reversal for zero-padded identifiers.
+*	Unlike reverseDigits, exactly Width digits are reversed and
+*	every zero is kept on both ends: "000120" becomes "021000".
+*	Part of the header-only library, next to ReverseDigits.h.
+*
+* Public API:
+*	reverseFixedWidth<Width>(uint64_t)              the low Width digits reversed, as a number
+*	reverseFixedWidthRecords<Width>(text, delim)    every record of a text buffer reversed in place
+*	fixedWidthRecordsFunc(width)                    the same for a width known only at runtime
+*
+* The text kernels rewrite records of Width digits followed by a
+*	delimiter in place, so there's no parse or format step at all.
+*	Up to 8 digits a record is one byte swap in a uint64_t (SWAR);
+*	up to 16 it's one SSSE3 shuffle. Both load a whole 8 or 16
+*	bytes starting at the record, so records that close to the end
+*	of the buffer go through the scalar kernel, but store only the
+*	field: storing the bytes past it too would partly overlap the
+*	next record's load, which then can't be forwarded from the store
+*	and stalls (a 6 digit field ran at half the scalar speed).
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+
+#include "DecimalText.h"
+#include "ReverseDigits.h"
+
+// Longest field the runtime width lookups below instantiate kernels for
+inline constexpr size_t maxFixedWidth = 32;
+
+/// <summary>
+/// The low Width decimal digits of value in the opposite order, leading and trailing zeros included:
+///		reverseFixedWidth&lt;6&gt;(120) == 21000, since "000120" reversed is "021000".
+/// </summary>
+/// <typeparam name="Width">1 to 19 digits, so the result always fits uint64_t</typeparam>
+/// <param name="value">Digits past the low Width are ignored</param>
+/// <returns></returns>
+template<size_t Width>
+constexpr uint64_t reverseFixedWidth(uint64_t value) noexcept
+{
+	static_assert(Width >= 1 && Width <= 19, "Width has to be 1 to 19 digits");
+
+	// A fixed trip count, so the compiler unrolls it and every division is by a constant
+	uint64_t result = 0;
+	for (size_t digit = 0; digit < Width; ++digit)
+	{
+		result = result * 10 + value % 10;
+		value /= 10;
+	}
+	return result;
+}
+
+struct FixedWidthReversalResult
+{
+	uint64_t recordCount = 0;
+	// Set if a record wasn't Width digits followed by the delimiter; recordCount is then the 1-based index of that record
+	bool valid = true;
+};
+
+/// <summary>
+/// Reverses Width digit characters in place, one byte at a time; the baseline and tail handler of the wider kernels.
+/// </summary>
+/// <param name="field">Width characters</param>
+/// <returns>False, with field untouched, if any of them isn't '0'-'9'</returns>
+template<size_t Width>
+inline bool reverseFixedWidthField_Scalar(char* field) noexcept
+{
+	if (!std::all_of(field, field + Width, [](char c) { return c >= '0' && c <= '9'; }))
+	{
+		return false;
+	}
+	std::reverse(field, field + Width);
+	return true;
+}
+
+/// <summary>
+/// Reverses Width (at most 8) digit characters in place with one byte swap of a uint64_t.
+/// </summary>
+/// <param name="field">Must have 8 readable bytes; only the first Width are written</param>
+/// <returns>False, with field untouched, if any of the Width characters isn't '0'-'9'</returns>
+template<size_t Width>
+inline bool reverseFixedWidthField_Swar(char* field) noexcept
+{
+	static_assert(Width >= 1 && Width <= 8, "The SWAR kernel handles at most 8 digits");
+
+	constexpr uint64_t fieldMask = Width == 8 ? ~uint64_t(0) : (uint64_t(1) << (Width * 8)) - 1;
+
+	uint64_t chunk;
+	std::memcpy(&chunk, field, sizeof(chunk));
+
+	// Pad the bytes past the field with '0' so the 8 digit check covers exactly the field
+	const uint64_t digits = chunk & fieldMask;
+	if (!isEightDigits(digits | (0x3030303030303030 & ~fieldMask)))
+	{
+		return false;
+	}
+
+	// Little-endian: the byte swap moves the field to the top bytes, reversed, and the shift brings it back down
+	const uint64_t reversed = std::byteswap(digits) >> (64 - Width * 8);
+	std::memcpy(field, &reversed, Width);
+	return true;
+}
+
+#if REVERSEDIGITS_X86
+
+namespace FixedWidthDetail
+{
+	// pshufb control reversing the first Width bytes; the rest aren't stored
+	template<size_t Width>
+	inline constexpr auto reverseShuffle = []()
+	{
+		std::array<int8_t, 16> control = {};
+		for (size_t index = 0; index < 16; ++index)
+		{
+			control[index] = static_cast<int8_t>(index < Width ? Width - 1 - index : index);
+		}
+		return control;
+	}();
+}
+
+/// <summary>
+/// Reverses Width (at most 16) digit characters in place with one SSSE3 shuffle; the digit check is one
+///		compare and movemask. Only call this if the CPU supports SSE4.1.
+/// </summary>
+/// <param name="field">Must have 16 readable bytes; only the first Width are written</param>
+/// <returns>False, with field untouched, if any of the Width characters isn't '0'-'9'</returns>
+template<size_t Width>
+REVERSEDIGITS_TARGET_SSE41 inline bool reverseFixedWidthField_SSE41(char* field) noexcept
+{
+	static_assert(Width >= 1 && Width <= 16, "The SSE4.1 kernel handles at most 16 digits");
+
+	constexpr uint32_t fieldBits = (uint32_t(1) << Width) - 1;
+
+	const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(field));
+
+	// '0'-'9' minus '0' is 0-9; everything else wraps to 10 or more, which min(x, 9) changes
+	const __m128i offsets = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+	const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(offsets, _mm_set1_epi8(9)), offsets);
+	if ((static_cast<uint32_t>(_mm_movemask_epi8(isDigit)) & fieldBits) != fieldBits)
+	{
+		return false;
+	}
+
+	const __m128i control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(FixedWidthDetail::reverseShuffle<Width>.data()));
+	const __m128i reversed = _mm_shuffle_epi8(chunk, control);
+	if constexpr (Width == 16)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(field), reversed);
+	}
+	else
+	{
+		// A constant size copy, which the compiler turns into the few stores that cover exactly Width bytes
+		alignas(16) char bytes[16];
+		_mm_store_si128(reinterpret_cast<__m128i*>(bytes), reversed);
+		std::memcpy(field, bytes, Width);
+	}
+	return true;
+}
+
+#endif // REVERSEDIGITS_X86
+
+/// <summary>
+/// Reverses every record of Width digits followed by delimiter in text, in place, one byte at a time;
+///		the baseline for, and tail handler of, the wider kernels.
+/// </summary>
+/// <param name="text">Whole records; the delimiter after the last one is optional</param>
+/// <param name="delimiter"></param>
+/// <returns></returns>
+template<size_t Width>
+inline FixedWidthReversalResult reverseFixedWidthRecords_Scalar(std::span<char> text, char delimiter) noexcept
+{
+	constexpr size_t stride = Width + 1;
+
+	FixedWidthReversalResult result = {};
+	for (size_t position = 0; position < text.size(); position += stride)
+	{
+		++result.recordCount;
+		const bool terminated = position + Width < text.size();
+		if (position + Width > text.size() || (terminated && text[position + Width] != delimiter)
+			|| !reverseFixedWidthField_Scalar<Width>(text.data() + position))
+		{
+			result.valid = false;
+			return result;
+		}
+	}
+	return result;
+}
+
+namespace FixedWidthDetail
+{
+	// Hands the records a wider kernel stopped short of (they'd load past the end of text) to the scalar one
+	template<size_t Width>
+	inline FixedWidthReversalResult finish(std::span<char> text, char delimiter, size_t position, uint64_t recordCount) noexcept
+	{
+		FixedWidthReversalResult result = reverseFixedWidthRecords_Scalar<Width>(text.subspan(position), delimiter);
+		result.recordCount += recordCount;
+		return result;
+	}
+}
+
+/// <summary>
+/// reverseFixedWidthRecords_Scalar with the SWAR field kernel. Width at most 8.
+/// </summary>
+/// <param name="text"></param>
+/// <param name="delimiter"></param>
+/// <returns></returns>
+template<size_t Width>
+inline FixedWidthReversalResult reverseFixedWidthRecords_Swar(std::span<char> text, char delimiter) noexcept
+{
+	constexpr size_t stride = Width + 1;
+
+	uint64_t recordCount = 0;
+	size_t position = 0;
+	for (; position + std::max<size_t>(8, stride) <= text.size(); position += stride)
+	{
+		++recordCount;
+		if (text[position + Width] != delimiter || !reverseFixedWidthField_Swar<Width>(text.data() + position))
+		{
+			return { recordCount, false };
+		}
+	}
+
+	return FixedWidthDetail::finish<Width>(text, delimiter, position, recordCount);
+}
+
+#if REVERSEDIGITS_X86
+
+/// <summary>
+/// reverseFixedWidthRecords_Scalar with the SSE4.1 field kernel. Width at most 16; only call this if the CPU supports SSE4.1.
+/// </summary>
+/// <param name="text"></param>
+/// <param name="delimiter"></param>
+/// <returns></returns>
+template<size_t Width>
+REVERSEDIGITS_TARGET_SSE41 inline FixedWidthReversalResult reverseFixedWidthRecords_SSE41(std::span<char> text, char delimiter) noexcept
+{
+	constexpr size_t stride = Width + 1;
+
+	// Its own loop rather than one shared with the SWAR kernel: the field kernel only inlines into a caller with the same target
+	uint64_t recordCount = 0;
+	size_t position = 0;
+	for (; position + std::max<size_t>(16, stride) <= text.size(); position += stride)
+	{
+		++recordCount;
+		if (text[position + Width] != delimiter || !reverseFixedWidthField_SSE41<Width>(text.data() + position))
+		{
+			return { recordCount, false };
+		}
+	}
+
+	return FixedWidthDetail::finish<Width>(text, delimiter, position, recordCount);
+}
+
+#endif // REVERSEDIGITS_X86
+
+/// <summary>
+/// The fixed-width entry point: reverses every record of Width digits followed by delimiter in place with the
+///		fastest kernel for Width, SWAR up to 8 digits and SSE4.1 up to 16 where the CPU has it.
+/// </summary>
+/// <param name="text">Whole records; the delimiter after the last one is optional</param>
+/// <param name="delimiter"></param>
+/// <returns></returns>
+template<size_t Width>
+inline FixedWidthReversalResult reverseFixedWidthRecords(std::span<char> text, char delimiter) noexcept
+{
+	static_assert(Width >= 1 && Width <= maxFixedWidth);
+
+	if constexpr (Width <= 8)
+	{
+		return reverseFixedWidthRecords_Swar<Width>(text, delimiter);
+	}
+	else
+	{
+#if REVERSEDIGITS_X86
+		if constexpr (Width <= 16)
+		{
+			if (activeSimdLevel() >= SimdLevel::SSE41)
+			{
+				return reverseFixedWidthRecords_SSE41<Width>(text, delimiter);
+			}
+		}
+#endif
+		return reverseFixedWidthRecords_Scalar<Width>(text, delimiter);
+	}
+}
+
+using FixedWidthRecordsFunc = FixedWidthReversalResult(*)(std::span<char>, char);
+
+/// <summary>
+/// reverseFixedWidthRecords&lt;width&gt; for a width only known at runtime.
+/// </summary>
+/// <param name="width"></param>
+/// <returns>nullptr unless 1 &lt;= width &lt;= maxFixedWidth</returns>
+inline FixedWidthRecordsFunc fixedWidthRecordsFunc(size_t width) noexcept
+{
+	static constexpr auto table = []<size_t... Index>(std::index_sequence<Index...>)
+	{
+		return std::array<FixedWidthRecordsFunc, sizeof...(Index)>{ &reverseFixedWidthRecords<Index + 1>... };
+	}(std::make_index_sequence<maxFixedWidth>());
+
+	return width >= 1 && width <= maxFixedWidth ? table[width - 1] : nullptr;
+}
@@ -0,0 +1,263 @@
+/*******************************************************************
+* Fixed-width ID files: reversed in place, padding and all, with
+*	no conversion to binary.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "BufferedWriter.h"
+#include "FixedWidthText.h"
+#include "FixedWidthTextFile.h"
+#include "MappedFile.h"
+#include "ReverseDigits.h"
+
+namespace
+{
+	constexpr size_t repeatCount = 10;
+
+	/// <summary>
+	/// The integer path an ID column usually takes: parse the digits, reverseFixedWidth, format back zero-padded.
+	/// </summary>
+	/// <param name="input">Whole records, each terminated by '\n'</param>
+	/// <param name="output">Must be at least as large as input</param>
+	/// <returns>False on a record that isn't Width digits</returns>
+	template<size_t Width>
+	bool reverseFixedWidthViaInteger(std::span<const char> input, std::span<char> output)
+	{
+		constexpr size_t stride = Width + 1;
+		for (size_t position = 0; position + stride <= input.size(); position += stride)
+		{
+			uint64_t value = 0;
+			const std::from_chars_result parsed = std::from_chars(input.data() + position, input.data() + position + Width, value);
+			if (parsed.ec != std::errc() || parsed.ptr != input.data() + position + Width)
+			{
+				return false;
+			}
+
+			uint64_t reversed = reverseFixedWidth<Width>(value);
+			for (size_t digit = Width; digit-- > 0;)
+			{
+				output[position + digit] = static_cast<char>('0' + reversed % 10);
+				reversed /= 10;
+			}
+			output[position + Width] = '\n';
+		}
+		return true;
+	}
+
+	struct KernelResult
+	{
+		std::string_view name;
+		std::vector<double> seconds;
+		bool valid = true;
+		bool matches = true;
+	};
+
+	/// <summary>
+	/// Times each kernel repeatCount times over a fresh copy of input and checks its output against the first kernel's.
+	/// </summary>
+	template<size_t Width>
+	int benchmarkWidth(std::span<const char> input, uint64_t count)
+	{
+		std::vector<char> work(input.size());
+		std::vector<char> expected;
+
+		const auto timeKernel = [&](std::string_view name, const auto& kernel)
+		{
+			KernelResult result = { name };
+			for (size_t repeatIndex = 0; repeatIndex < repeatCount; ++repeatIndex)
+			{
+				std::print(".");
+				// The kernels destroy their input; refresh it outside of the timed region
+				std::ranges::copy(input, work.begin());
+
+				const auto startTime = std::chrono::high_resolution_clock::now();
+				result.valid &= kernel();
+				const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+				result.seconds.push_back(duration.count());
+			}
+			std::print("\n");
+
+			if (expected.empty())
+			{
+				expected = work;
+			}
+			result.matches = result.valid && work == expected;
+			std::ranges::sort(result.seconds);
+			return result;
+		};
+
+		const auto timeRecords = [&](std::string_view name, FixedWidthRecordsFunc func)
+		{
+			return timeKernel(name, [&]() { return func(work, '\n').valid; });
+		};
+
+		std::vector<KernelResult> results;
+		results.push_back(timeRecords("Scalar", &reverseFixedWidthRecords_Scalar<Width>));
+		if constexpr (Width <= 8)
+		{
+			results.push_back(timeRecords("SWAR", &reverseFixedWidthRecords_Swar<Width>));
+		}
+#if REVERSEDIGITS_X86
+		if constexpr (Width <= 16)
+		{
+			if (activeSimdLevel() >= SimdLevel::SSE41)
+			{
+				results.push_back(timeRecords("SSE4.1", &reverseFixedWidthRecords_SSE41<Width>));
+			}
+		}
+#endif
+		results.push_back(timeRecords("Dispatch", &reverseFixedWidthRecords<Width>));
+
+		// Parses from the untouched input and writes into work, so it's compared like the in place kernels
+		results.push_back(timeKernel("Parse + Integer + Format", [&]() { return reverseFixedWidthViaInteger<Width>(input, work); }));
+
+		std::print("\n");
+		bool allMatch = true;
+		for (const KernelResult& result : results)
+		{
+			const double median = std::max(result.seconds[result.seconds.size() / 2], 1e-9);
+			allMatch &= result.matches;
+			std::println("{:<26} median {:.2f}ms, {:.3f} GB/s, {:.2f} Mrecords/s{}", result.name, median * 1'000.0,
+				static_cast<double>(input.size()) / median / 1e9, static_cast<double>(count) / median / 1e6, result.matches ? "" : "  !!!! OUTPUT DIFFERS");
+		}
+		return allMatch ? 0 : 1;
+	}
+
+	using BenchmarkWidthFunc = int(*)(std::span<const char>, uint64_t);
+
+	// benchmarkWidth<1> to benchmarkWidth<19>, the widths reverseFixedWidth covers
+	constexpr auto benchmarkWidthTable = []<size_t... Index>(std::index_sequence<Index...>)
+	{
+		return std::array<BenchmarkWidthFunc, sizeof...(Index)>{ &benchmarkWidth<Index + 1>... };
+	}(std::make_index_sequence<19>());
+}
+
+int runReverseFixedWidthFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, size_t width)
+{
+	const FixedWidthRecordsFunc reverseRecords = fixedWidthRecordsFunc(width);
+	if (reverseRecords == nullptr)
+	{
+		std::println(stderr, "Width has to be 1 to {}", maxFixedWidth);
+		return 2;
+	}
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	std::expected<MappedFile, std::string> input = MappedFile::openCopyOnWrite(inputPath);
+	if (!input)
+	{
+		std::println(stderr, "{}", input.error());
+		return 1;
+	}
+
+	std::expected<BufferedWriter, std::string> output = BufferedWriter::open(outputPath);
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	const std::span<char> text = input->writableChars();
+	const FixedWidthReversalResult result = reverseRecords(text, '\n');
+	if (!result.valid)
+	{
+		std::println(stderr, "{}:{}: not exactly {} digits", inputPath.string(), result.recordCount, width);
+		return 1;
+	}
+
+	output->write(text);
+	if (!output->close())
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+	const double seconds = std::max(duration.count(), 1e-9);
+
+	std::println("Reversed {:L} {} digit records in place ({:L} bytes) in {:.3f}s", result.recordCount, width, input->size(), seconds);
+	std::println("  {:.3f} GB/s, {:.2f} Mrecords/s", static_cast<double>(input->size()) / seconds / 1e9, static_cast<double>(result.recordCount) / seconds / 1e6);
+	return 0;
+}
+
+int runGenerateFixedWidthFile(const std::filesystem::path& outputPath, uint64_t count, size_t width)
+{
+	if (width < 1 || width > maxFixedWidth)
+	{
+		std::println(stderr, "Width has to be 1 to {}", maxFixedWidth);
+		return 2;
+	}
+
+	std::expected<BufferedWriter, std::string> output = BufferedWriter::open(outputPath);
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	// Fixed seed so runs are comparable
+	std::mt19937 generator(12345);
+	std::uniform_int_distribution<int> distribution(0, 9);
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		char* cursor = output->reserve(width + 1);
+		for (size_t digit = 0; digit < width; ++digit)
+		{
+			*cursor++ = static_cast<char>('0' + distribution(generator));
+		}
+		*cursor++ = '\n';
+		output->commit(cursor);
+	}
+
+	if (!output->close())
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	std::println("Wrote {:L} {} digit records to {}", count, width, outputPath.string());
+	return 0;
+}
+
+int runFixedWidthBenchmark(uint64_t count, size_t width)
+{
+	if (width < 1 || width > benchmarkWidthTable.size())
+	{
+		std::println(stderr, "Width has to be 1 to {}", benchmarkWidthTable.size());
+		return 2;
+	}
+
+	const std::filesystem::path inputPath = std::filesystem::temp_directory_path() / "intdigitreverser-fixed.txt";
+	const std::filesystem::path outputPath = std::filesystem::temp_directory_path() / "intdigitreverser-fixed-reversed.txt";
+
+	int exitCode = runGenerateFixedWidthFile(inputPath, count, width);
+	if (exitCode == 0)
+	{
+		std::expected<MappedFile, std::string> input = MappedFile::openReadOnly(inputPath);
+		if (!input)
+		{
+			std::println(stderr, "{}", input.error());
+			exitCode = 1;
+		}
+		else
+		{
+			std::println("Timing fixed-width kernels {}x over {:L} records ({:L} bytes)...\n", repeatCount, count, input->size());
+			exitCode = benchmarkWidthTable[width - 1](input->chars(), count);
+		}
+	}
+
+	if (exitCode == 0)
+	{
+		std::println("\nEnd to end, mapped file in, reversed file out:");
+		exitCode = runReverseFixedWidthFile(inputPath, outputPath, width);
+	}
+
+	std::error_code ignored;
+	std::filesystem::remove(inputPath, ignored);
+	std::filesystem::remove(outputPath, ignored);
+	return exitCode;
+}
@@ -0,0 +1,37 @@
+/*******************************************************************
+* File modes for newline separated fixed-width zero-padded IDs.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+/// <summary>
+/// Reverses exactly width digits of every line of inputPath into outputPath, keeping the zero padding.
+///		The input is mapped copy on write and reversed in place with reverseFixedWidthRecords. LF line endings only.
+/// </summary>
+/// <param name="inputPath"></param>
+/// <param name="outputPath"></param>
+/// <param name="width">1 to maxFixedWidth digits per line</param>
+/// <returns>Non-zero on I/O errors or lines that aren't exactly width digits</returns>
+int runReverseFixedWidthFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath, size_t width);
+
+/// <summary>
+/// Writes count lines of width random digits each, zeros included anywhere, as input for runReverseFixedWidthFile.
+/// </summary>
+/// <param name="outputPath"></param>
+/// <param name="count"></param>
+/// <param name="width">1 to maxFixedWidth</param>
+/// <returns>Non-zero on I/O errors</returns>
+int runGenerateFixedWidthFile(const std::filesystem::path& outputPath, uint64_t count, size_t width);
+
+/// <summary>
+/// Writes count records of width digits to a temporary file, then times the scalar, SWAR and SSE4.1 kernels on
+///		it against parse + reverseFixedWidth + zero-padded format, and the whole file mode end to end.
+/// </summary>
+/// <param name="count"></param>
+/// <param name="width">1 to 19, the widths reverseFixedWidth handles</param>
+/// <returns>Non-zero on I/O errors or if the kernels disagree</returns>
+int runFixedWidthBenchmark(uint64_t count, size_t width);
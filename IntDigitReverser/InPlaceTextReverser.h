@@ -0,0 +1,148 @@
+/*******************************************************************
+* Text to text digit reversal that never converts to binary.
+*	Each delimited decimal field is reversed where it sits in the
+*	buffer, and the buffer is compacted as the fields shrink.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "DecimalText.h"
+#include "ReverseDigits.h"
+
+struct InPlaceReversalResult
+{
+	// Length of the rewritten text; fields only ever shrink, so this is at most the original length
+	size_t length = 0;
+	uint64_t fieldCount = 0;
+	// Set if a field wasn't a valid int32; fieldCount is then the 1-based index of that field
+	bool valid = true;
+};
+
+/// <summary>
+/// Rewrites a single decimal field, already moved to output, as its digit reversal.
+///		Matches reverseDigits exactly: leading zeros of the input are ignored, the trailing zeros become
+///		leading zeros of the result and are dropped, the sign is kept, zero loses any sign, and a reversal
+///		that doesn't fit int32 becomes "0". The range checks are lexicographic compares on equal length digit strings.
+///		Like parseDecimalInt32, a field has at most 10 digits counting its leading zeros.
+/// </summary>
+/// <param name="field">The field's characters; rewritten in place</param>
+/// <returns>The new length of the field, or 0 if the field isn't a valid int32</returns>
+inline size_t reverseDecimalFieldInPlace(std::span<char> field) noexcept
+{
+	// "2147483648" and "2147483647"
+	constexpr std::string_view minInt32Digits = longestPossibleIntString.substr(1);
+	constexpr std::string_view maxInt32Digits = "2147483647";
+
+	const bool negate = !field.empty() && field.front() == '-';
+	const size_t signLength = negate ? 1 : 0;
+	if (field.size() - signLength > maxInt32Digits.size())
+	{
+		return 0;
+	}
+
+	size_t digitsBegin = signLength;
+	while (digitsBegin + 1 < field.size() && field[digitsBegin] == '0')
+	{
+		++digitsBegin;
+	}
+
+	const std::string_view digits(field.data() + digitsBegin, field.size() - digitsBegin);
+	if (digits.empty())
+	{
+		return 0;
+	}
+	for (const char digit : digits)
+	{
+		if (digit < '0' || digit > '9')
+		{
+			return 0;
+		}
+	}
+	if (digits.size() == maxInt32Digits.size() && digits > (negate ? minInt32Digits : maxInt32Digits))
+	{
+		return 0;
+	}
+
+	if (digits == "0")
+	{
+		field[0] = '0';
+		return 1;
+	}
+
+	// The input's trailing zeros would be the result's leading zeros, so leave them out of the reversal
+	size_t digitsEnd = field.size();
+	while (field[digitsEnd - 1] == '0')
+	{
+		--digitsEnd;
+	}
+
+	char* const output = field.data() + signLength;
+	const size_t resultLength = digitsEnd - digitsBegin;
+	std::reverse(field.data() + digitsBegin, field.data() + digitsEnd);
+	std::memmove(output, field.data() + digitsBegin, resultLength);
+
+	if (resultLength == maxInt32Digits.size() && std::string_view(output, resultLength) > maxInt32Digits)
+	{
+		field[0] = '0';
+		return 1;
+	}
+
+	return signLength + resultLength;
+}
+
+/// <summary>
+/// Reverses every delimiter separated field of text in place, compacting the text as fields shrink.
+///		Delimiters are found 64 bytes at a time with SIMD compares (see forEachDelimitedField).
+///		Each rewritten field is followed by one delimiter, including the last one if the input had it.
+///		With '\n' as the delimiter a '\r' ending a field is dropped, so CRLF text comes out as LF, the same as parsing it does.
+/// </summary>
+/// <param name="text"></param>
+/// <param name="delimiter"></param>
+/// <returns></returns>
+inline InPlaceReversalResult reverseDecimalFieldsInPlace(std::span<char> text, char delimiter) noexcept
+{
+	InPlaceReversalResult result = {};
+	char* const base = text.data();
+	char* writeCursor = base;
+
+	// Writes only ever land at or before the field being processed, and the delimiter mask
+	//	for the current 64 byte window is computed before any of its fields are touched, so rewriting during the scan is safe
+	result.valid = forEachDelimitedField(std::string_view(base, text.size()), delimiter, [&](const char* fieldBegin, const char* fieldEnd)
+	{
+		++result.fieldCount;
+
+		char* const field = base + (fieldBegin - base);
+		size_t fieldLength = static_cast<size_t>(fieldEnd - fieldBegin);
+		if (delimiter == '\n' && fieldLength != 0 && field[fieldLength - 1] == '\r')
+		{
+			--fieldLength;
+		}
+		const size_t newLength = reverseDecimalFieldInPlace(std::span<char>(field, fieldLength));
+		if (newLength == 0)
+		{
+			return false;
+		}
+
+		if (writeCursor != field)
+		{
+			std::memmove(writeCursor, field, newLength);
+		}
+		writeCursor += newLength;
+
+		// Keep a delimiter after every field that had one
+		if (static_cast<size_t>(fieldEnd - base) < text.size())
+		{
+			*writeCursor++ = delimiter;
+		}
+		return true;
+	});
+
+	result.length = static_cast<size_t>(writeCursor - base);
+	return result;
+}
@@ -0,0 +1,326 @@
+/*******************************************************************
+* Minimal RAII io_uring wrapper on the raw syscalls, so no liburing
+*	is needed: fixed buffer reads and writes, batched submission
+*	and completion reaping. Linux only; IOURING_AVAILABLE is 0
+*	everywhere else and callers fall back to positional I/O.
+*******************************************************************/
+
+#pragma once
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define IOURING_AVAILABLE 1
+#else
+#define IOURING_AVAILABLE 0
+#endif
+
+#if IOURING_AVAILABLE
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <span>
+#include <string>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+class IoUring
+{
+public:
+	IoUring(IoUring&& other) noexcept
+		: ringDescriptor(std::exchange(other.ringDescriptor, -1))
+		, submissionRing(std::exchange(other.submissionRing, nullptr))
+		, submissionRingSize(other.submissionRingSize)
+		, completionRing(std::exchange(other.completionRing, nullptr))
+		, completionRingSize(other.completionRingSize)
+		, submissionEntries(std::exchange(other.submissionEntries, nullptr))
+		, submissionEntriesSize(other.submissionEntriesSize)
+		, submissionHead(other.submissionHead)
+		, submissionTail(other.submissionTail)
+		, submissionMask(other.submissionMask)
+		, submissionArray(other.submissionArray)
+		, completionHead(other.completionHead)
+		, completionTail(other.completionTail)
+		, completionMask(other.completionMask)
+		, completionEntries(other.completionEntries)
+		, pendingSubmissions(other.pendingSubmissions)
+	{
+	}
+
+	IoUring(const IoUring&) = delete;
+	IoUring& operator=(const IoUring&) = delete;
+	IoUring& operator=(IoUring&&) = delete;
+
+	~IoUring()
+	{
+		if (submissionEntries != nullptr)
+		{
+			::munmap(submissionEntries, submissionEntriesSize);
+		}
+		if (completionRing != nullptr && completionRing != submissionRing)
+		{
+			::munmap(completionRing, completionRingSize);
+		}
+		if (submissionRing != nullptr)
+		{
+			::munmap(submissionRing, submissionRingSize);
+		}
+		if (ringDescriptor >= 0)
+		{
+			::close(ringDescriptor);
+		}
+	}
+
+	/// <summary>
+	/// Sets up a ring with room for entries submissions in flight.
+	///		Fails (rather than aborting) where the kernel or a seccomp policy doesn't allow io_uring.
+	/// </summary>
+	/// <param name="entries"></param>
+	/// <returns>The ring, or a description of what failed</returns>
+	static std::expected<IoUring, std::string> create(unsigned entries)
+	{
+		io_uring_params params = {};
+		const int descriptor = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+		if (descriptor < 0)
+		{
+			return std::unexpected(std::format("io_uring_setup failed: {}", std::strerror(errno)));
+		}
+
+		IoUring ring(descriptor);
+
+		ring.submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		ring.completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (singleMapping)
+		{
+			ring.submissionRingSize = std::max(ring.submissionRingSize, ring.completionRingSize);
+			ring.completionRingSize = ring.submissionRingSize;
+		}
+
+		void* const submissionRing = ::mmap(nullptr, ring.submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQ_RING);
+		if (submissionRing == MAP_FAILED)
+		{
+			return std::unexpected(std::format("Failed to map the io_uring submission ring: {}", std::strerror(errno)));
+		}
+		ring.submissionRing = static_cast<char*>(submissionRing);
+
+		if (singleMapping)
+		{
+			ring.completionRing = ring.submissionRing;
+		}
+		else
+		{
+			void* const completionRing = ::mmap(nullptr, ring.completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_CQ_RING);
+			if (completionRing == MAP_FAILED)
+			{
+				return std::unexpected(std::format("Failed to map the io_uring completion ring: {}", std::strerror(errno)));
+			}
+			ring.completionRing = static_cast<char*>(completionRing);
+		}
+
+		ring.submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+		void* const submissionEntries = ::mmap(nullptr, ring.submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQES);
+		if (submissionEntries == MAP_FAILED)
+		{
+			return std::unexpected(std::format("Failed to map the io_uring submission entries: {}", std::strerror(errno)));
+		}
+		ring.submissionEntries = static_cast<io_uring_sqe*>(submissionEntries);
+
+		ring.submissionHead = reinterpret_cast<unsigned*>(ring.submissionRing + params.sq_off.head);
+		ring.submissionTail = reinterpret_cast<unsigned*>(ring.submissionRing + params.sq_off.tail);
+		ring.submissionMask = *reinterpret_cast<unsigned*>(ring.submissionRing + params.sq_off.ring_mask);
+		ring.submissionArray = reinterpret_cast<unsigned*>(ring.submissionRing + params.sq_off.array);
+		ring.completionHead = reinterpret_cast<unsigned*>(ring.completionRing + params.cq_off.head);
+		ring.completionTail = reinterpret_cast<unsigned*>(ring.completionRing + params.cq_off.tail);
+		ring.completionMask = *reinterpret_cast<unsigned*>(ring.completionRing + params.cq_off.ring_mask);
+		ring.completionEntries = reinterpret_cast<io_uring_cqe*>(ring.completionRing + params.cq_off.cqes);
+
+		return ring;
+	}
+
+	/// <summary>
+	/// Pins buffers in the kernel once, so fixed reads and writes skip the per-request page mapping.
+	/// </summary>
+	/// <param name="buffers">Indexed by bufferIndex in prepareReadFixed / prepareWriteFixed</param>
+	/// <returns>False on failure, e.g. RLIMIT_MEMLOCK too low</returns>
+	bool registerBuffers(std::span<const iovec> buffers) noexcept
+	{
+		return ::syscall(__NR_io_uring_register, ringDescriptor, IORING_REGISTER_BUFFERS, buffers.data(), static_cast<unsigned>(buffers.size())) == 0;
+	}
+
+	/// <summary>
+	/// Queues a read of bytes at offset into a registered buffer; submitted by the next submitAndWait.
+	/// </summary>
+	/// <param name="fileDescriptor"></param>
+	/// <param name="bufferIndex"></param>
+	/// <param name="bytes">Must lie within registered buffer bufferIndex</param>
+	/// <param name="offset"></param>
+	/// <param name="userData">Handed back with the completion</param>
+	void prepareReadFixed(int fileDescriptor, uint16_t bufferIndex, std::span<char> bytes, uint64_t offset, uint64_t userData) noexcept
+	{
+		prepare(IORING_OP_READ_FIXED, fileDescriptor, bufferIndex, bytes.data(), bytes.size(), offset, userData);
+	}
+
+	/// <summary>
+	/// Queues a write of bytes at offset from a registered buffer; submitted by the next submitAndWait.
+	/// </summary>
+	/// <param name="fileDescriptor"></param>
+	/// <param name="bufferIndex"></param>
+	/// <param name="bytes">Must lie within registered buffer bufferIndex</param>
+	/// <param name="offset"></param>
+	/// <param name="userData">Handed back with the completion</param>
+	void prepareWriteFixed(int fileDescriptor, uint16_t bufferIndex, std::span<const char> bytes, uint64_t offset, uint64_t userData) noexcept
+	{
+		prepare(IORING_OP_WRITE_FIXED, fileDescriptor, bufferIndex, bytes.data(), bytes.size(), offset, userData);
+	}
+
+	/// <summary>
+	/// Submits everything prepared so far with one syscall, then blocks until at least minComplete completions are ready.
+	/// </summary>
+	/// <param name="minComplete"></param>
+	/// <returns>False on failure</returns>
+	bool submitAndWait(unsigned minComplete) noexcept
+	{
+		for (;;)
+		{
+			const long result = ::syscall(__NR_io_uring_enter, ringDescriptor, pendingSubmissions, minComplete, minComplete != 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+			if (result >= 0)
+			{
+				pendingSubmissions -= static_cast<unsigned>(result);
+				return true;
+			}
+			if (errno != EINTR)
+			{
+				return false;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Blocks until at least minComplete completions are ready without submitting anything, riding out
+	///		interruptions and transient kernel back pressure; what a teardown drain waits with.
+	/// </summary>
+	/// <param name="minComplete"></param>
+	/// <returns>False if waiting itself fails</returns>
+	bool waitForCompletions(unsigned minComplete) noexcept
+	{
+		for (;;)
+		{
+			const long result = ::syscall(__NR_io_uring_enter, ringDescriptor, 0u, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0);
+			if (result >= 0)
+			{
+				return true;
+			}
+			if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			{
+				return false;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Takes back every prepared request the kernel hasn't been handed yet, so they're never started.
+	/// </summary>
+	/// <returns>How many were dropped</returns>
+	unsigned discardUnsubmitted() noexcept
+	{
+		// Without SQPOLL the kernel only reads entries inside io_uring_enter, so the tail can simply move back
+		const unsigned discarded = pendingSubmissions;
+		std::atomic_ref(*submissionTail).store(*submissionTail - discarded, std::memory_order_release);
+		pendingSubmissions = 0;
+		return discarded;
+	}
+
+	/// <summary>
+	/// Gives up the ring without unmapping or closing it, for when requests are still in flight and can't be waited for:
+	///		the kernel keeps the registered buffers pinned while the ring lives, so the ring (and the buffers, which
+	///		the caller has to leak too) must outlive those requests.
+	/// </summary>
+	void abandon() noexcept
+	{
+		ringDescriptor = -1;
+		submissionRing = nullptr;
+		completionRing = nullptr;
+		submissionEntries = nullptr;
+	}
+
+	/// <summary>
+	/// Calls onCompletion(userData, result) for every completion that is ready, without blocking.
+	///		result is the byte count, or -errno on failure.
+	/// </summary>
+	/// <param name="onCompletion"></param>
+	/// <returns>How many completions were handled</returns>
+	template<typename OnCompletion>
+	unsigned forEachCompletion(OnCompletion&& onCompletion)
+	{
+		unsigned head = *completionHead;
+		const unsigned tail = std::atomic_ref(*completionTail).load(std::memory_order_acquire);
+
+		unsigned handled = 0;
+		for (; head != tail; ++head, ++handled)
+		{
+			const io_uring_cqe& completion = completionEntries[head & completionMask];
+			onCompletion(completion.user_data, completion.res);
+		}
+
+		std::atomic_ref(*completionHead).store(head, std::memory_order_release);
+		return handled;
+	}
+
+private:
+	explicit IoUring(int ringDescriptor) noexcept
+		: ringDescriptor(ringDescriptor)
+	{
+	}
+
+	void prepare(uint8_t opcode, int fileDescriptor, uint16_t bufferIndex, const void* address, size_t length, uint64_t offset, uint64_t userData) noexcept
+	{
+		// Callers never have more requests in flight than the ring holds, so there is always a free entry
+		const unsigned tail = *submissionTail;
+		const unsigned index = tail & submissionMask;
+
+		io_uring_sqe& entry = submissionEntries[index];
+		std::memset(&entry, 0, sizeof(entry));
+		entry.opcode = opcode;
+		entry.fd = fileDescriptor;
+		entry.addr = reinterpret_cast<uint64_t>(address);
+		entry.len = static_cast<uint32_t>(length);
+		entry.off = offset;
+		entry.buf_index = bufferIndex;
+		entry.user_data = userData;
+
+		submissionArray[index] = index;
+		std::atomic_ref(*submissionTail).store(tail + 1, std::memory_order_release);
+		++pendingSubmissions;
+	}
+
+	int ringDescriptor = -1;
+
+	char* submissionRing = nullptr;
+	size_t submissionRingSize = 0;
+	char* completionRing = nullptr;
+	size_t completionRingSize = 0;
+	io_uring_sqe* submissionEntries = nullptr;
+	size_t submissionEntriesSize = 0;
+
+	unsigned* submissionHead = nullptr;
+	unsigned* submissionTail = nullptr;
+	unsigned submissionMask = 0;
+	unsigned* submissionArray = nullptr;
+	unsigned* completionHead = nullptr;
+	unsigned* completionTail = nullptr;
+	unsigned completionMask = 0;
+	io_uring_cqe* completionEntries = nullptr;
+
+	unsigned pendingSubmissions = 0;
+};
+
+#endif
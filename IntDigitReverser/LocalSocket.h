@@ -0,0 +1,359 @@
+/*******************************************************************
+* Minimal RAII stream socket for the reversal service: Unix domain
+*	sockets ("unix:<path>") or loopback TCP ("tcp:<port>"), with
+*	blocking send / receive of whole buffers, optionally with a
+*	send timeout. Linux and Windows 10+.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#include <afunix.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "Ws2_32.lib")
+#endif
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+class LocalSocket
+{
+public:
+#if defined(_WIN32)
+	using NativeHandle = SOCKET;
+	static constexpr NativeHandle invalidHandle = INVALID_SOCKET;
+#else
+	using NativeHandle = int;
+	static constexpr NativeHandle invalidHandle = -1;
+#endif
+
+	LocalSocket() noexcept = default;
+
+	LocalSocket(LocalSocket&& other) noexcept
+		: handle(std::exchange(other.handle, invalidHandle))
+	{
+	}
+
+	LocalSocket& operator=(LocalSocket&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			handle = std::exchange(other.handle, invalidHandle);
+		}
+		return *this;
+	}
+
+	LocalSocket(const LocalSocket&) = delete;
+	LocalSocket& operator=(const LocalSocket&) = delete;
+
+	~LocalSocket()
+	{
+		close();
+	}
+
+	/// <summary>
+	/// Binds and listens on address, replacing a stale Unix socket file if there is one.
+	/// </summary>
+	/// <param name="address">"unix:&lt;path&gt;" or "tcp:&lt;port&gt;" (loopback only)</param>
+	/// <returns>The listening socket, or a description of what failed</returns>
+	static std::expected<LocalSocket, std::string> listen(std::string_view address)
+	{
+		std::expected<Endpoint, std::string> endpoint = parseAddress(address);
+		if (!endpoint)
+		{
+			return std::unexpected(endpoint.error());
+		}
+
+		LocalSocket socket(::socket(endpoint->family(), SOCK_STREAM, 0));
+		if (!socket.isOpen())
+		{
+			return std::unexpected(std::format("Failed to create a socket for {}: {}", address, lastErrorText()));
+		}
+
+		if (endpoint->family() == AF_UNIX)
+		{
+			std::error_code ignored;
+			std::filesystem::remove(endpoint->unixAddress.sun_path, ignored);
+		}
+		else
+		{
+			const int enable = 1;
+			::setsockopt(socket.handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&enable), sizeof(enable));
+		}
+
+		if (::bind(socket.handle, endpoint->address(), endpoint->addressLength()) != 0 || ::listen(socket.handle, SOMAXCONN) != 0)
+		{
+			return std::unexpected(std::format("Failed to listen on {}: {}", address, lastErrorText()));
+		}
+		return socket;
+	}
+
+	/// <summary>
+	/// Connects to a listening address, with Nagle disabled for TCP so small requests aren't held back.
+	/// </summary>
+	/// <param name="address">"unix:&lt;path&gt;" or "tcp:&lt;port&gt;" (loopback only)</param>
+	/// <returns>The connected socket, or a description of what failed</returns>
+	static std::expected<LocalSocket, std::string> connect(std::string_view address)
+	{
+		std::expected<Endpoint, std::string> endpoint = parseAddress(address);
+		if (!endpoint)
+		{
+			return std::unexpected(endpoint.error());
+		}
+
+		LocalSocket socket(::socket(endpoint->family(), SOCK_STREAM, 0));
+		if (!socket.isOpen())
+		{
+			return std::unexpected(std::format("Failed to create a socket for {}: {}", address, lastErrorText()));
+		}
+		if (::connect(socket.handle, endpoint->address(), endpoint->addressLength()) != 0)
+		{
+			return std::unexpected(std::format("Failed to connect to {}: {}", address, lastErrorText()));
+		}
+		socket.disableNagle(endpoint->family());
+		return socket;
+	}
+
+	/// <summary>
+	/// Blocks until a client connects.
+	/// </summary>
+	/// <returns>The connection, or a description of what failed</returns>
+	std::expected<LocalSocket, std::string> accept() const
+	{
+		sockaddr_storage peer = {};
+		socklen_t peerLength = sizeof(peer);
+		LocalSocket connection(::accept(handle, reinterpret_cast<sockaddr*>(&peer), &peerLength));
+		if (!connection.isOpen())
+		{
+			return std::unexpected(std::format("accept failed: {}", lastErrorText()));
+		}
+		connection.disableNagle(peer.ss_family);
+		return connection;
+	}
+
+	/// <summary>
+	/// Makes sendAll give up and return false once a single send has been blocked for longer than timeout,
+	///		for a peer that stops reading. Zero waits forever, the default.
+	/// </summary>
+	/// <param name="timeout"></param>
+	/// <returns>False if the option couldn't be set</returns>
+	bool setSendTimeout(std::chrono::milliseconds timeout) const noexcept
+	{
+#if defined(_WIN32)
+		const DWORD milliseconds = static_cast<DWORD>(timeout.count());
+		return ::setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&milliseconds), sizeof(milliseconds)) == 0;
+#else
+		const timeval interval = { .tv_sec = static_cast<time_t>(timeout.count() / 1000), .tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000) };
+		return ::setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, &interval, sizeof(interval)) == 0;
+#endif
+	}
+
+	/// <summary>
+	/// Sends all of bytes, however many calls it takes.
+	/// </summary>
+	/// <param name="bytes"></param>
+	/// <returns>False if the connection failed or was closed, or a send timed out (see setSendTimeout)</returns>
+	bool sendAll(std::span<const char> bytes) const noexcept
+	{
+		while (!bytes.empty())
+		{
+			const int chunk = static_cast<int>(std::min<size_t>(bytes.size(), 1 << 30));
+#if defined(_WIN32)
+			const int sent = ::send(handle, bytes.data(), chunk, 0);
+#else
+			const ssize_t sent = ::send(handle, bytes.data(), static_cast<size_t>(chunk), MSG_NOSIGNAL);
+			if (sent < 0 && errno == EINTR)
+			{
+				continue;
+			}
+#endif
+			if (sent <= 0)
+			{
+				return false;
+			}
+			bytes = bytes.subspan(static_cast<size_t>(sent));
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Fills all of bytes, however many calls it takes.
+	/// </summary>
+	/// <param name="bytes"></param>
+	/// <returns>False if the connection failed or was closed first</returns>
+	bool receiveAll(std::span<char> bytes) const noexcept
+	{
+		while (!bytes.empty())
+		{
+			const int chunk = static_cast<int>(std::min<size_t>(bytes.size(), 1 << 30));
+#if defined(_WIN32)
+			const int received = ::recv(handle, bytes.data(), chunk, 0);
+#else
+			const ssize_t received = ::recv(handle, bytes.data(), static_cast<size_t>(chunk), 0);
+			if (received < 0 && errno == EINTR)
+			{
+				continue;
+			}
+#endif
+			if (received <= 0)
+			{
+				return false;
+			}
+			bytes = bytes.subspan(static_cast<size_t>(received));
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Wakes any thread blocked receiving on this socket, without closing the handle under it.
+	/// </summary>
+	void shutdown() const noexcept
+	{
+#if defined(_WIN32)
+		::shutdown(handle, SD_BOTH);
+#else
+		::shutdown(handle, SHUT_RDWR);
+#endif
+	}
+
+	bool isOpen() const noexcept
+	{
+		return handle != invalidHandle;
+	}
+
+private:
+	struct Endpoint
+	{
+		bool isUnix = false;
+		sockaddr_un unixAddress = {};
+		sockaddr_in tcpAddress = {};
+
+		int family() const noexcept
+		{
+			return isUnix ? AF_UNIX : AF_INET;
+		}
+
+		const sockaddr* address() const noexcept
+		{
+			return isUnix ? reinterpret_cast<const sockaddr*>(&unixAddress) : reinterpret_cast<const sockaddr*>(&tcpAddress);
+		}
+
+		socklen_t addressLength() const noexcept
+		{
+			return isUnix ? static_cast<socklen_t>(sizeof(unixAddress)) : static_cast<socklen_t>(sizeof(tcpAddress));
+		}
+	};
+
+	explicit LocalSocket(NativeHandle handle) noexcept
+		: handle(handle)
+	{
+	}
+
+	static std::expected<Endpoint, std::string> parseAddress(std::string_view address)
+	{
+		initializeSockets();
+
+		Endpoint endpoint;
+		if (address.starts_with("unix:"))
+		{
+			const std::string_view path = address.substr(5);
+			if (path.empty() || path.size() >= sizeof(endpoint.unixAddress.sun_path))
+			{
+				return std::unexpected(std::format("Invalid Unix socket path in {}", address));
+			}
+			endpoint.isUnix = true;
+			endpoint.unixAddress.sun_family = AF_UNIX;
+			std::memcpy(endpoint.unixAddress.sun_path, path.data(), path.size());
+			return endpoint;
+		}
+
+		if (address.starts_with("tcp:"))
+		{
+			const std::string_view portText = address.substr(4);
+			uint16_t port = 0;
+			if (std::from_chars(portText.data(), portText.data() + portText.size(), port).ec != std::errc() || port == 0)
+			{
+				return std::unexpected(std::format("Invalid TCP port in {}", address));
+			}
+			endpoint.tcpAddress.sin_family = AF_INET;
+			endpoint.tcpAddress.sin_port = htons(port);
+			endpoint.tcpAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			return endpoint;
+		}
+
+		return std::unexpected(std::format("Unknown address {}, expected unix:<path> or tcp:<port>", address));
+	}
+
+	static void initializeSockets() noexcept
+	{
+#if defined(_WIN32)
+		static const bool initialized = []()
+		{
+			WSADATA data = {};
+			return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+		}();
+		(void)initialized;
+#endif
+	}
+
+	static std::string lastErrorText()
+	{
+#if defined(_WIN32)
+		return std::format("error {}", WSAGetLastError());
+#else
+		return std::strerror(errno);
+#endif
+	}
+
+	void disableNagle(int family) const noexcept
+	{
+		if (family == AF_INET)
+		{
+			const int enable = 1;
+			::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&enable), sizeof(enable));
+		}
+	}
+
+	void close() noexcept
+	{
+		if (handle != invalidHandle)
+		{
+#if defined(_WIN32)
+			::closesocket(handle);
+#else
+			::close(handle);
+#endif
+		}
+		handle = invalidHandle;
+	}
+
+	NativeHandle handle = invalidHandle;
+};
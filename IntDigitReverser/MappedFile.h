@@ -0,0 +1,219 @@
+/*******************************************************************
+* Minimal RAII wrapper around a read-only (or private copy on write) memory mapped file,
+*	for the file processing modes. Linux (mmap) and Windows
+*	(CreateFileMapping) only.
+*******************************************************************/
+
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class MappedFile
+{
+public:
+	MappedFile() noexcept = default;
+
+	MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			std::swap(mappedData, other.mappedData);
+			std::swap(mappedSize, other.mappedSize);
+#if defined(_WIN32)
+			std::swap(fileHandle, other.fileHandle);
+			std::swap(mappingHandle, other.mappingHandle);
+#else
+			std::swap(fileDescriptor, other.fileDescriptor);
+#endif
+		}
+		return *this;
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile()
+	{
+		close();
+	}
+
+	/// <summary>
+	/// Maps the whole file read-only, hinting the OS that it will be read front to back.
+	///		Empty files succeed with an empty span, since neither OS can map zero bytes.
+	/// </summary>
+	/// <param name="path"></param>
+	/// <returns>The mapping, or a description of what failed</returns>
+	static std::expected<MappedFile, std::string> openReadOnly(const std::filesystem::path& path)
+	{
+		return open(path, false);
+	}
+
+	/// <summary>
+	/// Maps the whole file as a private copy on write mapping: the pages can be modified in place,
+	///		but the changes are never written back to the file.
+	/// </summary>
+	/// <param name="path"></param>
+	/// <returns>The mapping, or a description of what failed</returns>
+	static std::expected<MappedFile, std::string> openCopyOnWrite(const std::filesystem::path& path)
+	{
+		return open(path, true);
+	}
+
+	std::span<const std::byte> bytes() const noexcept
+	{
+		return { mappedData, mappedSize };
+	}
+
+	std::span<const char> chars() const noexcept
+	{
+		return { reinterpret_cast<const char*>(mappedData), mappedSize };
+	}
+
+	/// <summary>
+	/// Only valid for mappings from openCopyOnWrite.
+	/// </summary>
+	/// <returns></returns>
+	std::span<char> writableChars() const noexcept
+	{
+		return { reinterpret_cast<char*>(mappedData), mappedSize };
+	}
+
+	size_t size() const noexcept
+	{
+		return mappedSize;
+	}
+
+private:
+	static std::expected<MappedFile, std::string> open(const std::filesystem::path& path, bool copyOnWrite)
+	{
+		MappedFile file;
+
+#if defined(_WIN32)
+		file.fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file.fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return std::unexpected(std::format("Failed to open {} (error {})", path.string(), GetLastError()));
+		}
+
+		LARGE_INTEGER fileSize = {};
+		if (!GetFileSizeEx(file.fileHandle, &fileSize))
+		{
+			return std::unexpected(std::format("Failed to get the size of {} (error {})", path.string(), GetLastError()));
+		}
+		file.mappedSize = static_cast<size_t>(fileSize.QuadPart);
+		if (file.mappedSize == 0)
+		{
+			return file;
+		}
+
+		file.mappingHandle = CreateFileMappingW(file.fileHandle, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+		if (file.mappingHandle == nullptr)
+		{
+			return std::unexpected(std::format("Failed to map {} (error {})", path.string(), GetLastError()));
+		}
+
+		file.mappedData = static_cast<std::byte*>(MapViewOfFile(file.mappingHandle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+		if (file.mappedData == nullptr)
+		{
+			return std::unexpected(std::format("Failed to map {} (error {})", path.string(), GetLastError()));
+		}
+#else
+		file.fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file.fileDescriptor < 0)
+		{
+			return std::unexpected(std::format("Failed to open {}: {}", path.string(), std::strerror(errno)));
+		}
+
+		struct stat fileStat = {};
+		if (::fstat(file.fileDescriptor, &fileStat) != 0)
+		{
+			return std::unexpected(std::format("Failed to stat {}: {}", path.string(), std::strerror(errno)));
+		}
+		file.mappedSize = static_cast<size_t>(fileStat.st_size);
+		if (file.mappedSize == 0)
+		{
+			return file;
+		}
+
+		void* const mapping = ::mmap(nullptr, file.mappedSize, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, file.fileDescriptor, 0);
+		if (mapping == MAP_FAILED)
+		{
+			return std::unexpected(std::format("Failed to map {}: {}", path.string(), std::strerror(errno)));
+		}
+		file.mappedData = static_cast<std::byte*>(mapping);
+		::madvise(mapping, file.mappedSize, MADV_SEQUENTIAL);
+#endif
+
+		return file;
+	}
+
+	void close() noexcept
+	{
+#if defined(_WIN32)
+		if (mappedData != nullptr)
+		{
+			UnmapViewOfFile(mappedData);
+		}
+		if (mappingHandle != nullptr)
+		{
+			CloseHandle(mappingHandle);
+		}
+		if (fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(fileHandle);
+		}
+		mappingHandle = nullptr;
+		fileHandle = INVALID_HANDLE_VALUE;
+#else
+		if (mappedData != nullptr)
+		{
+			::munmap(mappedData, mappedSize);
+		}
+		if (fileDescriptor >= 0)
+		{
+			::close(fileDescriptor);
+		}
+		fileDescriptor = -1;
+#endif
+		mappedData = nullptr;
+		mappedSize = 0;
+	}
+
+	std::byte* mappedData = nullptr;
+	size_t mappedSize = 0;
+#if defined(_WIN32)
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+};
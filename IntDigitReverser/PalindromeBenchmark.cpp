@@ -0,0 +1,182 @@
+/*******************************************************************
+* Palindrome checks: early exit scalar, SIMD batch and generation
+*	by mirroring, each timed against reversing and comparing.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "BenchmarkTiming.h"
+#include "Palindromes.h"
+#include "PalindromeBenchmark.h"
+#include "ReverseDigits.h"
+
+namespace
+{
+	/// <summary>
+	/// medianTimePerCall in milliseconds, for the runs long enough to print as such.
+	/// </summary>
+	/// <param name="call"></param>
+	/// <returns></returns>
+	template<typename Call>
+	std::chrono::duration<double, std::milli> medianTime(Call&& call)
+	{
+		return medianTimePerCall(call);
+	}
+
+	struct Distribution
+	{
+		std::string_view name;
+		std::vector<int32_t> values;
+	};
+
+	/// <summary>
+	/// Full range values (nearly all 9 or 10 digits), a uniform spread of digit counts, and half palindromes
+	///		so the early exit has to run to the middle as often as not.
+	/// </summary>
+	/// <param name="valueCount"></param>
+	/// <returns></returns>
+	std::vector<Distribution> makeDistributions(size_t valueCount)
+	{
+		constexpr int32_t tens[] = { 1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000 };
+
+		std::vector<int32_t> palindromes;
+		forEachDigitPalindrome(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), [&](int32_t value) { palindromes.push_back(value); });
+
+		std::mt19937 random(42);
+		std::uniform_int_distribution<int32_t> anyValue(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+		std::uniform_int_distribution<size_t> anyDigitCount(0, std::size(tens) - 1);
+		std::uniform_int_distribution<size_t> anyPalindrome(0, palindromes.size() - 1);
+
+		std::vector<Distribution> distributions = {
+			{ "full range", std::vector<int32_t>(valueCount) },
+			{ "log-uniform", std::vector<int32_t>(valueCount) },
+			{ "50% palindromes", std::vector<int32_t>(valueCount) },
+		};
+		for (size_t index = 0; index < valueCount; ++index)
+		{
+			distributions[0].values[index] = anyValue(random);
+
+			// In int64_t, since 9 * 1'000'000'000 doesn't fit int32_t; 1 digit values start at 0 rather than 1
+			const int64_t digitsTens = tens[anyDigitCount(random)];
+			const int64_t lowest = digitsTens == 1 ? 0 : digitsTens;
+			const int64_t span = std::min<int64_t>(digitsTens * 10, int64_t(std::numeric_limits<int32_t>::max()) + 1) - lowest;
+			const int32_t magnitude = static_cast<int32_t>(lowest + static_cast<int64_t>(static_cast<uint32_t>(anyValue(random))) % span);
+			distributions[1].values[index] = index % 2 == 0 ? magnitude : -magnitude;
+
+			distributions[2].values[index] = index % 2 == 0 ? palindromes[anyPalindrome(random)] : anyValue(random);
+		}
+		return distributions;
+	}
+}
+
+int runPalindromeBenchmark(size_t valueCount, int32_t filterRange)
+{
+	using ScalarKernel = bool(*)(int32_t);
+	constexpr std::pair<std::string_view, ScalarKernel> scalarKernels[] = {
+		{ "ModuloMultiply == x", &isDigitPalindrome_ReverseCompare },
+		{ "Digit Pairs", &isDigitPalindrome_DigitPairs },
+		{ "Half Reverse", &isDigitPalindrome_HalfReverse },
+	};
+
+	valueCount = std::max<size_t>(valueCount, 1);
+	filterRange = std::max(filterRange, 0);
+	bool allCorrect = true;
+
+	std::println("Classifying {:L} values per distribution, {}; median of {} runs, per value\n", valueCount, toString(batchSimdLevel()), benchmarkSampleCount);
+	for (const Distribution& distribution : makeDistributions(valueCount))
+	{
+		const std::span<const int32_t> values = distribution.values;
+		std::vector<uint8_t> expected(values.size());
+		for (size_t index = 0; index < values.size(); ++index)
+		{
+			expected[index] = isDigitPalindrome_ReverseCompare(values[index]) ? 1 : 0;
+		}
+		const size_t expectedCount = static_cast<size_t>(std::ranges::count(expected, 1));
+		std::println("{} ({:L} palindromes)", distribution.name, expectedCount);
+
+		double baseline = 0.0;
+		for (const auto& [name, kernel] : scalarKernels)
+		{
+			size_t palindromeCount = 0;
+			const auto elapsed = medianTime([&]()
+			{
+				palindromeCount = 0;
+				for (const int32_t value : values)
+				{
+					palindromeCount += kernel(value) ? 1 : 0;
+				}
+			});
+			for (size_t index = 0; index < values.size(); ++index)
+			{
+				allCorrect &= kernel(values[index]) == (expected[index] != 0);
+			}
+			allCorrect &= palindromeCount == expectedCount;
+
+			const double perValue = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(values.size());
+			baseline = baseline == 0.0 ? perValue : baseline;
+			std::println("  {:<22} {:>8.3f}ns {:>6.2f}x", name, perValue, baseline / perValue);
+		}
+
+		std::vector<uint8_t> flags(values.size());
+		for (const BatchPalindromeVariant& variant : batchPalindromeVariants)
+		{
+			if (!variant.isSupported())
+			{
+				std::println("  {:<22} unsupported on this CPU", variant.name);
+				continue;
+			}
+			std::ranges::fill(flags, 0);
+			const auto elapsed = medianTime([&]() { variant.func(values, flags); });
+			allCorrect &= flags == expected;
+
+			const double perValue = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(values.size());
+			std::println("  {:<22} {:>8.3f}ns {:>6.2f}x", variant.name, perValue, baseline / perValue);
+		}
+		std::print("\n");
+	}
+
+	// Generation: every palindrome in the range, against testing each value in it
+	std::println("Enumerating the palindromes in [{:L}, {:L}]", -filterRange, filterRange);
+	std::vector<int32_t> filtered;
+	const auto filterTime = medianTime([&]()
+	{
+		filtered.clear();
+		for (int32_t value = -filterRange;; ++value)
+		{
+			if (isDigitPalindrome_ReverseCompare(value))
+			{
+				filtered.push_back(value);
+			}
+			if (value == filterRange)
+			{
+				break;
+			}
+		}
+	});
+	std::vector<int32_t> generated;
+	const auto generateTime = medianTime([&]()
+	{
+		generated.clear();
+		forEachDigitPalindrome(-filterRange, filterRange, [&](int32_t value) { generated.push_back(value); });
+	});
+	allCorrect &= generated == filtered;
+	std::println("  {:<22} {:>12.3f}ms", "filter", filterTime.count());
+	std::println("  {:<22} {:>12.3f}ms {:>10.1f}x, {:L} palindromes", "forEachDigitPalindrome", generateTime.count(), filterTime / generateTime, generated.size());
+
+	size_t everyPalindrome = 0;
+	const auto everyTime = medianTime([&]()
+	{
+		everyPalindrome = 0;
+		forEachDigitPalindrome(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), [&](int32_t) { ++everyPalindrome; });
+	});
+	std::println("  {:<22} {:>12.3f}ms, {:L} palindromes over all of int32_t", "forEachDigitPalindrome", everyTime.count(), everyPalindrome);
+
+	if (!allCorrect)
+	{
+		std::println("\n!!!! WRONG RESULTS");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,19 @@
+/*******************************************************************
+* Palindrome classification and generation against the plain
+*	reverse and compare.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Times every scalar and batch palindrome kernel against reverseDigits_ModuloMultiply(x) == x on valueCount values
+///		of three distributions, then forEachDigitPalindrome against filtering [-filterRange, filterRange] with the same
+///		test, checking that every method agrees with the baseline.
+/// </summary>
+/// <param name="valueCount">Values per distribution</param>
+/// <param name="filterRange">Half width of the range that is filtered</param>
+/// <returns>Non-zero on wrong results</returns>
+int runPalindromeBenchmark(size_t valueCount, int32_t filterRange);
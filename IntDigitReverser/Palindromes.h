@@ -0,0 +1,452 @@
+/*******************************************************************
+* Decimal palindromes, i.e. reverse(x) == x, without building the
+*	reversed value. Part of the header-only library, next to
+*	ReverseDigits.h.
+*
+* Public API:
+*	isDigitPalindrome(int32_t)                     recommended scalar check, constexpr
+*	isDigitPalindrome(span<const int32_t>, span)   batch, 1 / 0 per value, picks the widest SIMD kernel
+*	isDigitPalindrome_*                            the individual scalar and batch kernels
+*	forEachDigitPalindrome(first, last, visit)     every palindrome in a range, by mirroring half the digits
+*
+* Same semantics as comparing against reverseDigits_ModuloLookup: the
+*	sign is ignored (-121 is a palindrome), a value ending in 0 never
+*	is one, and neither is INT32_MIN.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "ReverseDigits.h"
+
+/// <summary>
+/// The baseline: reverse the whole value and compare.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr bool isDigitPalindrome_ReverseCompare(int32_t value) noexcept
+{
+	return reverseDigits_ModuloMultiply(value) == value;
+}
+
+/// <summary>
+/// Compares the outermost digit pair, then the next one in, with reverseDigits_ModuloLookup's tens table,
+///		returning at the first mismatch. Most non-palindromes are rejected after a single pair.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr bool isDigitPalindrome_DigitPairs(int32_t value) noexcept
+{
+	constexpr uint32_t tensLookupTable[] = {
+		1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000
+	};
+
+	uint32_t remaining = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+	if (remaining < 10)
+	{
+		return true;
+	}
+	// A trailing zero would have to be a leading zero
+	if (remaining % 10 == 0)
+	{
+		return false;
+	}
+
+	size_t topIndex = 1;
+	while (topIndex < std::size(tensLookupTable) && remaining >= tensLookupTable[topIndex])
+	{
+		++topIndex;
+	}
+	--topIndex;
+
+	// Peel the top and bottom digit off together, leaving the inner digits for the next pair
+	for (; topIndex > 0; topIndex -= 2)
+	{
+		const uint32_t topTens = tensLookupTable[topIndex];
+		if (remaining / topTens != remaining % 10)
+		{
+			return false;
+		}
+		remaining = remaining % topTens / 10;
+		if (topIndex == 1)
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// Reverses only the lower half of the digits and compares it with the upper half. Divides by the constant 10 only,
+///		but always runs to the middle.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr bool isDigitPalindrome_HalfReverse(int32_t value) noexcept
+{
+	uint32_t remaining = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+	if (remaining % 10 == 0 && remaining != 0)
+	{
+		return false;
+	}
+
+	uint32_t lowerHalf = 0;
+	while (remaining > lowerHalf)
+	{
+		lowerHalf = lowerHalf * 10 + remaining % 10;
+		remaining /= 10;
+	}
+	// Equal for an even digit count; for an odd one the middle digit ended up on the lower half
+	return remaining == lowerHalf || remaining == lowerHalf / 10;
+}
+
+/// <summary>
+/// The recommended scalar entry point; currently the digit pair kernel.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr bool isDigitPalindrome(int32_t value) noexcept
+{
+	return isDigitPalindrome_DigitPairs(value);
+}
+
+
+/*******************************************************************
+* Batch kernels
+*	All of them classify min(input.size(), output.size()) values,
+*	writing 1 for a palindrome and 0 otherwise.
+*******************************************************************/
+
+/// <summary>
+/// Batch classification with the scalar kernel; the baseline for, and tail handler of, the SIMD versions.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+inline void isDigitPalindrome_BatchScalar(std::span<const int32_t> input, std::span<uint8_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+	for (size_t index = 0; index < count; ++index)
+	{
+		output[index] = isDigitPalindrome(input[index]) ? 1 : 0;
+	}
+}
+
+#if REVERSEDIGITS_X86
+
+/// <summary>
+/// Unsigned lane / 10 by the reciprocal multiply of reverseDigitsLanes_SSE41.
+/// </summary>
+/// <param name="dividends"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_SSE41 inline __m128i divideLanesByTen_SSE41(__m128i dividends) noexcept
+{
+	const __m128i divideByTenMagic = _mm_set1_epi32(static_cast<int32_t>(0xCCCCCCCD));
+	const __m128i evenQuotients = _mm_srli_epi64(_mm_mul_epu32(dividends, divideByTenMagic), 35);
+	const __m128i oddQuotients = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(dividends, 32), divideByTenMagic), 3);
+	return _mm_blend_epi16(evenQuotients, oddQuotients, 0b1100'1100);
+}
+
+/// <summary>
+/// Lane * 10 as two shifts and an add.
+/// </summary>
+/// <param name="lanes"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_SSE41 inline __m128i multiplyLanesByTen_SSE41(__m128i lanes) noexcept
+{
+	return _mm_add_epi32(_mm_slli_epi32(lanes, 3), _mm_slli_epi32(lanes, 1));
+}
+
+/// <summary>
+/// Eight lane AVX2 version of divideLanesByTen_SSE41.
+/// </summary>
+/// <param name="dividends"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m256i divideLanesByTen_AVX2(__m256i dividends) noexcept
+{
+	const __m256i divideByTenMagic = _mm256_set1_epi32(static_cast<int32_t>(0xCCCCCCCD));
+	const __m256i evenQuotients = _mm256_srli_epi64(_mm256_mul_epu32(dividends, divideByTenMagic), 35);
+	const __m256i oddQuotients = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(dividends, 32), divideByTenMagic), 3);
+	return _mm256_blend_epi32(evenQuotients, oddQuotients, 0b1010'1010);
+}
+
+/// <summary>
+/// Eight lane AVX2 version of multiplyLanesByTen_SSE41.
+/// </summary>
+/// <param name="lanes"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m256i multiplyLanesByTen_AVX2(__m256i lanes) noexcept
+{
+	return _mm256_add_epi32(_mm256_slli_epi32(lanes, 3), _mm256_slli_epi32(lanes, 1));
+}
+
+/// <summary>
+/// isDigitPalindrome_HalfReverse on four lanes. Lanes can't return early on their own, so the loop instead stops
+///		as soon as every lane has reached its middle; short values finish in fewer rounds.
+///		INT32_MIN's magnitude reads as negative here, which stops it at once and correctly reports it as no palindrome.
+/// </summary>
+/// <param name="values"></param>
+/// <returns>All ones in palindrome lanes, zero elsewhere</returns>
+REVERSEDIGITS_TARGET_SSE41 inline __m128i isDigitPalindromeLanes_SSE41(__m128i values) noexcept
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i remaining = _mm_abs_epi32(values);
+	__m128i lowerHalf = zero;
+
+	const __m128i firstQuotients = divideLanesByTen_SSE41(remaining);
+	const __m128i endsInZero = _mm_andnot_si128(_mm_cmpeq_epi32(remaining, zero), _mm_cmpeq_epi32(remaining, multiplyLanesByTen_SSE41(firstQuotients)));
+
+	// At most 10 digits, so 5 rounds reach the middle of every lane
+	for (int round = 0; round < 5; ++round)
+	{
+		const __m128i active = _mm_cmpgt_epi32(remaining, lowerHalf);
+		if (_mm_testz_si128(active, active))
+		{
+			break;
+		}
+
+		const __m128i quotients = divideLanesByTen_SSE41(remaining);
+		const __m128i lowDigits = _mm_sub_epi32(remaining, multiplyLanesByTen_SSE41(quotients));
+		lowerHalf = _mm_blendv_epi8(lowerHalf, _mm_add_epi32(multiplyLanesByTen_SSE41(lowerHalf), lowDigits), active);
+		remaining = _mm_blendv_epi8(remaining, quotients, active);
+	}
+
+	const __m128i matches = _mm_or_si128(_mm_cmpeq_epi32(remaining, lowerHalf), _mm_cmpeq_epi32(remaining, divideLanesByTen_SSE41(lowerHalf)));
+	return _mm_andnot_si128(endsInZero, matches);
+}
+
+/// <summary>
+/// Eight lane AVX2 version of isDigitPalindromeLanes_SSE41.
+/// </summary>
+/// <param name="values"></param>
+/// <returns>All ones in palindrome lanes, zero elsewhere</returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m256i isDigitPalindromeLanes_AVX2(__m256i values) noexcept
+{
+	const __m256i zero = _mm256_setzero_si256();
+
+	__m256i remaining = _mm256_abs_epi32(values);
+	__m256i lowerHalf = zero;
+
+	const __m256i firstQuotients = divideLanesByTen_AVX2(remaining);
+	const __m256i endsInZero = _mm256_andnot_si256(_mm256_cmpeq_epi32(remaining, zero), _mm256_cmpeq_epi32(remaining, multiplyLanesByTen_AVX2(firstQuotients)));
+
+	for (int round = 0; round < 5; ++round)
+	{
+		const __m256i active = _mm256_cmpgt_epi32(remaining, lowerHalf);
+		if (_mm256_testz_si256(active, active))
+		{
+			break;
+		}
+
+		const __m256i quotients = divideLanesByTen_AVX2(remaining);
+		const __m256i lowDigits = _mm256_sub_epi32(remaining, multiplyLanesByTen_AVX2(quotients));
+		lowerHalf = _mm256_blendv_epi8(lowerHalf, _mm256_add_epi32(multiplyLanesByTen_AVX2(lowerHalf), lowDigits), active);
+		remaining = _mm256_blendv_epi8(remaining, quotients, active);
+	}
+
+	const __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi32(remaining, lowerHalf), _mm256_cmpeq_epi32(remaining, divideLanesByTen_AVX2(lowerHalf)));
+	return _mm256_andnot_si256(endsInZero, matches);
+}
+
+/// <summary>
+/// Batch classification four values at a time with SSE4.1. Only call this if the CPU supports SSE4.1.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+REVERSEDIGITS_TARGET_SSE41 inline void isDigitPalindrome_BatchSSE41(std::span<const int32_t> input, std::span<uint8_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+
+	size_t index = 0;
+	for (; index + 4 <= count; index += 4)
+	{
+		const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + index));
+		const int mask = _mm_movemask_ps(_mm_castsi128_ps(isDigitPalindromeLanes_SSE41(values)));
+		for (size_t lane = 0; lane < 4; ++lane)
+		{
+			output[index + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+		}
+	}
+
+	isDigitPalindrome_BatchScalar(input.subspan(index, count - index), output.subspan(index));
+}
+
+/// <summary>
+/// Batch classification eight values at a time with AVX2. Only call this if the CPU supports AVX2.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+REVERSEDIGITS_TARGET_AVX2 inline void isDigitPalindrome_BatchAVX2(std::span<const int32_t> input, std::span<uint8_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+
+	size_t index = 0;
+	for (; index + 8 <= count; index += 8)
+	{
+		const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + index));
+		const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(isDigitPalindromeLanes_AVX2(values)));
+		for (size_t lane = 0; lane < 8; ++lane)
+		{
+			output[index + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+		}
+	}
+
+	isDigitPalindrome_BatchScalar(input.subspan(index, count - index), output.subspan(index));
+}
+
+#endif // REVERSEDIGITS_X86
+
+/// <summary>
+/// The recommended batch entry point: 1 for every palindrome in input, 0 otherwise, with the widest kernel the CPU supports.
+///		Classifies min(input.size(), output.size()) values.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+inline void isDigitPalindrome(std::span<const int32_t> input, std::span<uint8_t> output) noexcept
+{
+#if REVERSEDIGITS_X86
+	switch (activeSimdLevel())
+	{
+	case SimdLevel::AVX512:
+	case SimdLevel::AVX2:
+		isDigitPalindrome_BatchAVX2(input, output);
+		return;
+	case SimdLevel::SSE41:
+		isDigitPalindrome_BatchSSE41(input, output);
+		return;
+	case SimdLevel::Scalar:
+		break;
+	}
+#endif
+	isDigitPalindrome_BatchScalar(input, output);
+}
+
+/// <summary>
+/// Every batch palindrome kernel, for the benchmark and checks; skip entries whose isSupported() is false.
+/// </summary>
+struct BatchPalindromeVariant
+{
+	std::string_view name;
+	void(*func)(std::span<const int32_t>, std::span<uint8_t>);
+	SimdLevel requiredLevel = SimdLevel::Scalar;
+
+	bool isSupported() const noexcept
+	{
+		return requiredLevel <= activeSimdLevel();
+	}
+};
+
+inline constexpr BatchPalindromeVariant batchPalindromeVariants[] = {
+	{ "Batch Scalar", &isDigitPalindrome_BatchScalar, SimdLevel::Scalar },
+#if REVERSEDIGITS_X86
+	{ "Batch SSE4.1", &isDigitPalindrome_BatchSSE41, SimdLevel::SSE41 },
+	{ "Batch AVX2", &isDigitPalindrome_BatchAVX2, SimdLevel::AVX2 },
+#endif
+	{ "Batch Dispatch", static_cast<void(*)(std::span<const int32_t>, std::span<uint8_t>)>(&isDigitPalindrome), SimdLevel::Scalar },
+};
+
+/// <summary>
+/// Calls visit(p) for every magnitude palindrome in [first, last], ascending or descending, by mirroring each half.
+/// </summary>
+/// <param name="first"></param>
+/// <param name="last"></param>
+/// <param name="descending"></param>
+/// <param name="visit">Returns false to stop</param>
+/// <returns>False if visit stopped it</returns>
+template<typename Visit>
+constexpr bool forEachMagnitudePalindrome(uint64_t first, uint64_t last, bool descending, Visit& visit)
+{
+	constexpr uint64_t tens[] = {
+		1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000, 10'000'000'000
+	};
+
+	// The palindrome of a given digit count whose upper (digitCount + 1) / 2 digits are half
+	const auto mirror = [](uint64_t half, size_t digitCount)
+	{
+		uint64_t palindrome = half;
+		for (uint64_t lower = digitCount % 2 == 0 ? half : half / 10; lower != 0; lower /= 10)
+		{
+			palindrome = palindrome * 10 + lower % 10;
+		}
+		return palindrome;
+	};
+
+	for (size_t step = 1; step <= 10; ++step)
+	{
+		const size_t digitCount = descending ? 11 - step : step;
+		const size_t halfDigits = (digitCount + 1) / 2;
+		const uint64_t lengthFirst = digitCount == 1 ? 0 : tens[digitCount - 1];
+		const uint64_t lengthLast = tens[digitCount] - 1;
+		if (lengthLast < first || lengthFirst > last)
+		{
+			continue;
+		}
+
+		// Halves are the palindromes' leading digits, and mirroring keeps their order
+		const uint64_t firstHalf = std::max(first, lengthFirst) / tens[digitCount - halfDigits];
+		const uint64_t lastHalf = std::min(last, lengthLast) / tens[digitCount - halfDigits];
+		for (uint64_t offset = 0; offset <= lastHalf - firstHalf; ++offset)
+		{
+			const uint64_t palindrome = mirror(descending ? lastHalf - offset : firstHalf + offset, digitCount);
+			if (palindrome >= first && palindrome <= last && !visit(palindrome))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// Calls visit for every palindrome in [first, last] in ascending order, generating them directly from their
+///		leading halves instead of testing every value: about 2 * sqrt(range) values instead of range.
+/// </summary>
+/// <param name="first"></param>
+/// <param name="last"></param>
+/// <param name="visit">Callable with int32_t; returning bool, false stops the enumeration</param>
+template<typename Visit>
+constexpr void forEachDigitPalindrome(int32_t first, int32_t last, Visit&& visit)
+{
+	const auto emit = [&](int32_t value)
+	{
+		if constexpr (std::is_same_v<std::invoke_result_t<Visit&, int32_t>, bool>)
+		{
+			return visit(value);
+		}
+		else
+		{
+			visit(value);
+			return true;
+		}
+	};
+
+	if (last < first)
+	{
+		return;
+	}
+
+	// Negative palindromes are the negated positive ones; INT32_MIN's magnitude is no palindrome, so it can be left out
+	if (first < 0)
+	{
+		const uint64_t magnitudeFirst = last < 0 ? static_cast<uint64_t>(-static_cast<int64_t>(last)) : 1;
+		const uint64_t magnitudeLast = static_cast<uint64_t>(-static_cast<int64_t>(std::max(first, -std::numeric_limits<int32_t>::max())));
+		const auto emitNegative = [&](uint64_t magnitude) { return emit(-static_cast<int32_t>(magnitude)); };
+		if (!forEachMagnitudePalindrome(magnitudeFirst, magnitudeLast, true, emitNegative))
+		{
+			return;
+		}
+	}
+	if (last >= 0)
+	{
+		const auto emitPositive = [&](uint64_t magnitude) { return emit(static_cast<int32_t>(magnitude)); };
+		forEachMagnitudePalindrome(static_cast<uint64_t>(std::max(first, 0)), static_cast<uint64_t>(last), false, emitPositive);
+	}
+}
@@ -0,0 +1,276 @@
+/*******************************************************************
+* Multi-threaded batch reversal for arrays too big for one core.
+*	Part of the header-only library, next to ReverseDigits.h.
+*
+* Public API:
+*	ReverseThreadPool                              persistent pool; reverseDigits and firstTouch on it
+*	reverseDigits_Parallel(span<const int32_t>, span)  the same on a process wide pool of every core
+*
+* Work is split into chunks. Each participant starts with an equal,
+*	contiguous range of them, so the same thread keeps writing the
+*	same output pages from call to call (and firstTouch can place
+*	those pages on that thread's NUMA node); idle participants then
+*	steal the upper half of whatever range has the most left.
+*******************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "ReverseDigits.h"
+#include "ThreadAffinity.h"
+
+class ReverseThreadPool
+{
+public:
+	// 64 KiB in and out per chunk, so a chunk's input and output stay within a core's L2
+	static constexpr size_t defaultChunkValues = 16 << 10;
+
+	/// <summary>
+	/// Starts threadCount - 1 worker threads; the calling thread is the last participant in every call.
+	/// </summary>
+	/// <param name="threadCount">0 for every available core</param>
+	/// <param name="cores">If not empty, participant N is pinned to cores[N % size]. The caller is participant 0, pinned only
+	///		for the duration of each call and then restored, whichever thread makes it</param>
+	explicit ReverseThreadPool(size_t threadCount = 0, std::span<const size_t> cores = {})
+		: participantCount(threadCount != 0 ? threadCount : availableCores().size())
+		, callerCore(cores.empty() ? SIZE_MAX : cores[0])
+		, ranges(std::make_unique<WorkRange[]>(participantCount))
+	{
+		for (size_t participant = 1; participant < participantCount; ++participant)
+		{
+			workers.emplace_back([this, participant, core = cores.empty() ? SIZE_MAX : cores[participant % cores.size()]]()
+			{
+				if (core != SIZE_MAX)
+				{
+					pinCurrentThreadToCore(core);
+				}
+				workerLoop(participant);
+			});
+		}
+	}
+
+	ReverseThreadPool(const ReverseThreadPool&) = delete;
+	ReverseThreadPool& operator=(const ReverseThreadPool&) = delete;
+
+	~ReverseThreadPool()
+	{
+		stopping.store(true, std::memory_order_relaxed);
+		generation.fetch_add(1, std::memory_order_release);
+		generation.notify_all();
+	}
+
+	/// <summary>
+	/// Participants per call, including the calling thread.
+	/// </summary>
+	/// <returns></returns>
+	size_t threadCount() const noexcept
+	{
+		return participantCount;
+	}
+
+	/// <summary>
+	/// Reverses min(input.size(), output.size()) values, every chunk with the dispatching batch kernel.
+	///		Blocks until done; input and output may be the same span. Calls from several threads take turns.
+	/// </summary>
+	/// <param name="input"></param>
+	/// <param name="output"></param>
+	/// <param name="chunkValues">Values per scheduled chunk</param>
+	void reverseDigits(std::span<const int32_t> input, std::span<int32_t> output, size_t chunkValues = defaultChunkValues) noexcept
+	{
+		run(&::reverseDigits, input, output, chunkValues);
+	}
+
+	/// <summary>
+	/// Writes every page of a freshly allocated output from the participant that reverseDigits will initially
+	///		assign it to, so with first-touch NUMA placement each page lands on the node of the thread that fills it.
+	///		Use the same chunkValues as the later reverseDigits calls, and pin the pool so threads don't migrate.
+	/// </summary>
+	/// <param name="output"></param>
+	/// <param name="chunkValues"></param>
+	void firstTouch(std::span<int32_t> output, size_t chunkValues = defaultChunkValues) noexcept
+	{
+		run(&touchPages, output, output, chunkValues);
+	}
+
+private:
+	using Kernel = void(*)(std::span<const int32_t>, std::span<int32_t>);
+
+	// [begin, end) chunk indices, packed so owner takes and thief steals are both one CAS
+	struct alignas(64) WorkRange
+	{
+		std::atomic<uint64_t> range = 0;
+	};
+
+	static uint64_t packRange(uint64_t begin, uint64_t end) noexcept
+	{
+		return begin | (end << 32);
+	}
+
+	static void touchPages(std::span<const int32_t>, std::span<int32_t> output) noexcept
+	{
+		constexpr size_t valuesPerPage = 4096 / sizeof(int32_t);
+		for (size_t index = 0; index < output.size(); index += valuesPerPage)
+		{
+			output[index] = 0;
+		}
+	}
+
+	void run(Kernel kernel, std::span<const int32_t> input, std::span<int32_t> output, size_t chunkValues) noexcept
+	{
+		const std::scoped_lock lock(jobMutex);
+		const ScopedCorePin pin(callerCore);
+
+		const size_t valueCount = std::min(input.size(), output.size());
+		// Chunk indices are packed into 32 bits
+		chunkValues = std::max<size_t>({ chunkValues, 1, valueCount / 0xFFFFFFFF + 1 });
+		const uint64_t chunkCount = (valueCount + chunkValues - 1) / chunkValues;
+
+		for (size_t participant = 0; participant < participantCount; ++participant)
+		{
+			ranges[participant].range.store(packRange(chunkCount * participant / participantCount, chunkCount * (participant + 1) / participantCount), std::memory_order_relaxed);
+		}
+		jobKernel = kernel;
+		jobInput = input.first(valueCount);
+		jobOutput = output.first(valueCount);
+		jobChunkValues = chunkValues;
+		finishedWorkers.store(0, std::memory_order_relaxed);
+
+		generation.fetch_add(1, std::memory_order_release);
+		generation.notify_all();
+
+		participate(0);
+
+		// Workers touch the job until they check in, so it can't be replaced before then
+		for (size_t finished = finishedWorkers.load(std::memory_order_acquire); finished != participantCount - 1; finished = finishedWorkers.load(std::memory_order_acquire))
+		{
+			finishedWorkers.wait(finished, std::memory_order_acquire);
+		}
+	}
+
+	void workerLoop(size_t participant) noexcept
+	{
+		uint32_t seenGeneration = 0;
+		for (;;)
+		{
+			generation.wait(seenGeneration, std::memory_order_acquire);
+			seenGeneration = generation.load(std::memory_order_acquire);
+			if (stopping.load(std::memory_order_relaxed))
+			{
+				return;
+			}
+
+			participate(participant);
+
+			finishedWorkers.fetch_add(1, std::memory_order_release);
+			finishedWorkers.notify_one();
+		}
+	}
+
+	void participate(size_t participant) noexcept
+	{
+		uint64_t chunk = 0;
+		while (takeOwnChunk(participant, chunk) || (stealChunks(participant) && takeOwnChunk(participant, chunk)))
+		{
+			const size_t begin = static_cast<size_t>(chunk) * jobChunkValues;
+			const size_t count = std::min(jobChunkValues, jobOutput.size() - begin);
+			jobKernel(jobInput.subspan(begin, count), jobOutput.subspan(begin, count));
+		}
+	}
+
+	bool takeOwnChunk(size_t participant, uint64_t& chunk) noexcept
+	{
+		std::atomic<uint64_t>& own = ranges[participant].range;
+		uint64_t range = own.load(std::memory_order_acquire);
+		for (;;)
+		{
+			const uint64_t begin = range & 0xFFFFFFFF;
+			const uint64_t end = range >> 32;
+			if (begin >= end)
+			{
+				return false;
+			}
+			if (own.compare_exchange_weak(range, packRange(begin + 1, end), std::memory_order_acq_rel))
+			{
+				chunk = begin;
+				return true;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Moves the upper half of the fullest other range into this participant's (empty) range.
+	/// </summary>
+	/// <param name="participant"></param>
+	/// <returns>False once every range is empty</returns>
+	bool stealChunks(size_t participant) noexcept
+	{
+		for (;;)
+		{
+			size_t victim = participant;
+			uint64_t victimRange = 0;
+			uint64_t mostRemaining = 0;
+			for (size_t other = 0; other < participantCount; ++other)
+			{
+				const uint64_t range = ranges[other].range.load(std::memory_order_acquire);
+				const uint64_t remaining = (range >> 32) - std::min(range >> 32, range & 0xFFFFFFFF);
+				if (other != participant && remaining > mostRemaining)
+				{
+					victim = other;
+					victimRange = range;
+					mostRemaining = remaining;
+				}
+			}
+			if (mostRemaining == 0)
+			{
+				return false;
+			}
+
+			const uint64_t begin = victimRange & 0xFFFFFFFF;
+			const uint64_t end = victimRange >> 32;
+			const uint64_t split = end - (mostRemaining + 1) / 2;
+			if (ranges[victim].range.compare_exchange_strong(victimRange, packRange(begin, split), std::memory_order_acq_rel))
+			{
+				ranges[participant].range.store(packRange(split, end), std::memory_order_release);
+				return true;
+			}
+		}
+	}
+
+	const size_t participantCount;
+	// Where the calling thread runs while it's participant 0; SIZE_MAX when the pool isn't pinned
+	const size_t callerCore;
+	std::unique_ptr<WorkRange[]> ranges;
+
+	std::mutex jobMutex;
+	Kernel jobKernel = nullptr;
+	std::span<const int32_t> jobInput;
+	std::span<int32_t> jobOutput;
+	size_t jobChunkValues = 0;
+
+	alignas(64) std::atomic<uint32_t> generation = 0;
+	alignas(64) std::atomic<size_t> finishedWorkers = 0;
+	std::atomic<bool> stopping = false;
+
+	// Last, so the threads are joined before anything they use is destroyed
+	std::vector<std::jthread> workers;
+};
+
+/// <summary>
+/// Reverses min(input.size(), output.size()) values on a process wide pool with a thread per available core,
+///		created on first use. Below a few hundred thousand values a single thread is usually faster; measure with bench-parallel.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+inline void reverseDigits_Parallel(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+	static ReverseThreadPool pool;
+	pool.reverseDigits(input, output);
+}
@@ -0,0 +1,197 @@
+/*******************************************************************
+* Parallel batch reverse scaling from L1 sized to memory bound arrays.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "BenchmarkTiming.h"
+#include "ParallelReverse.h"
+#include "ParallelReverseBenchmark.h"
+#include "ReverseDigits.h"
+#include "ThreadAffinity.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#endif
+
+namespace
+{
+	constexpr size_t minElements = 1 << 10;
+	constexpr size_t maxDefaultElements = size_t(1) << 30;
+	// When physical memory can't be queried; the two arrays take 512 MiB
+	constexpr size_t fallbackDefaultElements = size_t(1) << 26;
+	// Values processed per timing sample, so small arrays are timed over many calls
+	constexpr size_t valuesPerSample = 1 << 24;
+	// Values checked per array size and method
+	constexpr size_t spotCheckCount = 1 << 20;
+
+	/// <summary>
+	/// medianTimePerCall with each sample averaging enough calls to cover valuesPerSample.
+	/// </summary>
+	/// <param name="valueCount"></param>
+	/// <param name="call"></param>
+	/// <returns></returns>
+	template<typename Call>
+	std::chrono::duration<double, std::nano> timePerCall(size_t valueCount, Call&& call)
+	{
+		return medianTimePerCall(call, valuesPerSample / valueCount);
+	}
+
+	bool spotCheck(std::span<const int32_t> input, std::span<const int32_t> output)
+	{
+		const size_t step = std::max<size_t>(input.size() / spotCheckCount, 1);
+		for (size_t index = 0; index < input.size(); index += step)
+		{
+			if (output[index] != reverseDigits_ModuloLookup(input[index]))
+			{
+				return false;
+			}
+		}
+		return output.back() == reverseDigits_ModuloLookup(input.back());
+	}
+}
+
+size_t defaultParallelBenchmarkElements() noexcept
+{
+	uint64_t physicalBytes = 0;
+#if defined(__linux__)
+	const long pageCount = sysconf(_SC_PHYS_PAGES);
+	const long pageSize = sysconf(_SC_PAGESIZE);
+	if (pageCount > 0 && pageSize > 0)
+	{
+		physicalBytes = static_cast<uint64_t>(pageCount) * static_cast<uint64_t>(pageSize);
+	}
+#elif defined(_WIN32)
+	MEMORYSTATUSEX status = {};
+	status.dwLength = sizeof(status);
+	if (GlobalMemoryStatusEx(&status))
+	{
+		physicalBytes = status.ullTotalPhys;
+	}
+#endif
+	if (physicalBytes == 0)
+	{
+		return fallbackDefaultElements;
+	}
+
+	// Input and output together take 8 bytes per value; keep them to a quarter of physical memory
+	const uint64_t elements = physicalBytes / 4 / (2 * sizeof(int32_t));
+	return static_cast<size_t>(std::clamp<uint64_t>(elements, minElements, maxDefaultElements));
+}
+
+int runParallelReverseBenchmark(size_t maxElements)
+{
+	const std::vector<size_t> cores = availableCores();
+
+	std::vector<std::unique_ptr<ReverseThreadPool>> pools;
+	for (size_t threadCount = 1; threadCount < cores.size(); threadCount *= 2)
+	{
+		pools.push_back(std::make_unique<ReverseThreadPool>(threadCount, cores));
+	}
+	pools.push_back(std::make_unique<ReverseThreadPool>(cores.size(), cores));
+	ReverseThreadPool& allCores = *pools.back();
+
+	maxElements = std::max(maxElements, minElements);
+	std::println("Up to {:L} values on {} cores, {}; times are per value, speedup is against one thread of the batch kernel\n", maxElements, cores.size(), toString(batchSimdLevel()));
+
+	std::print("{:>14} {:>12} {:>18}", "values", "1 thread", "transform par");
+	for (const std::unique_ptr<ReverseThreadPool>& pool : pools)
+	{
+		std::print(" {:>18}", std::format("pool {}", pool->threadCount()));
+	}
+	std::print("\n");
+
+	bool allCorrect = true;
+	size_t crossover = 0;
+	size_t largestTimed = 0;
+	for (size_t valueCount = minElements; valueCount <= maxElements; valueCount *= 4)
+	{
+		// Fresh arrays per size, first touched with this size's split of the work; pages placed for an earlier size
+		//	would only match the threads that fill them at that size. Stop, rather than fail, at a size that doesn't fit
+		const std::unique_ptr<int32_t[]> inputStorage(new (std::nothrow) int32_t[valueCount]);
+		const std::unique_ptr<int32_t[]> outputStorage(new (std::nothrow) int32_t[valueCount]);
+		if (!inputStorage || !outputStorage)
+		{
+			std::println("{:>14L} values don't fit in memory, stopping", valueCount);
+			break;
+		}
+		const std::span<int32_t> input(inputStorage.get(), valueCount);
+		const std::span<int32_t> out(outputStorage.get(), valueCount);
+		allCores.firstTouch(input);
+		allCores.firstTouch(out);
+		for (size_t index = 0; index < input.size(); ++index)
+		{
+			// Knuth's multiplicative hash, a cheap spread over every digit count and sign
+			input[index] = static_cast<int32_t>(static_cast<uint32_t>(index) * 2654435761u);
+		}
+		const std::span<const int32_t> in = input;
+		const auto perValue = [&](std::chrono::duration<double, std::nano> perCall) { return perCall.count() / static_cast<double>(valueCount); };
+
+		const double serial = perValue(timePerCall(valueCount, [&]() { reverseDigits(in, out); }));
+		allCorrect &= spotCheck(in, out);
+		std::print("{:>14L} {:>10.3f}ns", valueCount, serial);
+
+		std::ranges::fill(out, 0);
+		const double transform = perValue(timePerCall(valueCount, [&]()
+		{
+			std::transform(std::execution::par_unseq, in.begin(), in.end(), out.begin(), [](int32_t value) { return reverseDigits_ModuloLookup(value); });
+		}));
+		allCorrect &= spotCheck(in, out);
+		std::print(" {:>8.3f}ns {:>6.2f}x", transform, serial / transform);
+
+		double allCoresTime = 0.0;
+		for (const std::unique_ptr<ReverseThreadPool>& pool : pools)
+		{
+			std::ranges::fill(out, 0);
+			allCoresTime = perValue(timePerCall(valueCount, [&]() { pool->reverseDigits(in, out); }));
+			allCorrect &= spotCheck(in, out);
+			std::print(" {:>8.3f}ns {:>6.2f}x", allCoresTime, serial / allCoresTime);
+		}
+		std::print("\n");
+
+		// The crossover is where every core starts and then keeps beating one thread
+		if (allCoresTime >= serial)
+		{
+			crossover = 0;
+		}
+		else if (crossover == 0)
+		{
+			crossover = valueCount;
+		}
+		largestTimed = valueCount;
+	}
+
+	if (largestTimed == 0)
+	{
+		std::println(stderr, "Failed to allocate {} values", minElements);
+		return 1;
+	}
+	if (!allCorrect)
+	{
+		std::println("\n!!!! WRONG RESULTS");
+		return 1;
+	}
+	if (cores.size() == 1)
+	{
+		std::println("\nOnly one core available, so there's no crossover to find");
+	}
+	else if (crossover == 0)
+	{
+		std::println("\n{} threads never beat one thread up to {:L} values", cores.size(), largestTimed);
+	}
+	else
+	{
+		std::println("\n{} threads beat one thread from about {:L} values", cores.size(), crossover);
+	}
+	return 0;
+}
@@ -0,0 +1,24 @@
+/*******************************************************************
+* Scaling curve of the parallel batch reverse against one thread
+*	and against the standard library's parallel algorithms.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary>
+/// Times the batch kernel on one thread, std::transform(par_unseq) over reverseDigits_ModuloLookup and
+///		ReverseThreadPool at 1, 2, 4, ... threads up to every core, on arrays from 1K values up to maxElements
+///		in steps of 4x, then prints where the pool starts beating a single thread.
+/// </summary>
+/// <param name="maxElements">Largest array; needs 8 bytes of memory per value, and stops short if that can't be allocated</param>
+/// <returns>Non-zero on wrong results</returns>
+int runParallelReverseBenchmark(size_t maxElements);
+
+/// <summary>
+/// bench-parallel's default largest array: 1G values, or fewer so the input and output take at most a quarter of physical memory.
+///		64M values if physical memory can't be queried.
+/// </summary>
+/// <returns></returns>
+size_t defaultParallelBenchmarkElements() noexcept;
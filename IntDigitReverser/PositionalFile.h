@@ -0,0 +1,234 @@
+/*******************************************************************
+* Minimal RAII file handle with positional (pread / pwrite style)
+*	reads and writes, so several threads or an io_uring can
+*	share one handle without a file position. Linux and Windows only.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <span>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class PositionalFile
+{
+public:
+	PositionalFile() noexcept = default;
+
+	PositionalFile(PositionalFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	PositionalFile& operator=(PositionalFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+#if defined(_WIN32)
+			std::swap(fileHandle, other.fileHandle);
+#else
+			std::swap(fileDescriptor, other.fileDescriptor);
+#endif
+		}
+		return *this;
+	}
+
+	PositionalFile(const PositionalFile&) = delete;
+	PositionalFile& operator=(const PositionalFile&) = delete;
+
+	~PositionalFile()
+	{
+		close();
+	}
+
+	/// <summary>
+	/// Opens an existing file for reading.
+	/// </summary>
+	/// <param name="path"></param>
+	/// <returns>The file, or a description of what failed</returns>
+	static std::expected<PositionalFile, std::string> openRead(const std::filesystem::path& path)
+	{
+		PositionalFile file;
+#if defined(_WIN32)
+		file.fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file.fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return std::unexpected(std::format("Failed to open {} (error {})", path.string(), GetLastError()));
+		}
+#else
+		file.fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file.fileDescriptor < 0)
+		{
+			return std::unexpected(std::format("Failed to open {}: {}", path.string(), std::strerror(errno)));
+		}
+#endif
+		return file;
+	}
+
+	/// <summary>
+	/// Creates or truncates path for writing.
+	/// </summary>
+	/// <param name="path"></param>
+	/// <returns>The file, or a description of what failed</returns>
+	static std::expected<PositionalFile, std::string> create(const std::filesystem::path& path)
+	{
+		PositionalFile file;
+#if defined(_WIN32)
+		file.fileHandle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file.fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return std::unexpected(std::format("Failed to open {} for writing (error {})", path.string(), GetLastError()));
+		}
+#else
+		file.fileDescriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (file.fileDescriptor < 0)
+		{
+			return std::unexpected(std::format("Failed to open {} for writing: {}", path.string(), std::strerror(errno)));
+		}
+#endif
+		return file;
+	}
+
+	/// <summary>
+	/// Size of the file in bytes, or -1 on failure.
+	/// </summary>
+	/// <returns></returns>
+	int64_t size() const noexcept
+	{
+#if defined(_WIN32)
+		LARGE_INTEGER fileSize = {};
+		return GetFileSizeEx(fileHandle, &fileSize) ? fileSize.QuadPart : -1;
+#else
+		struct stat fileStat = {};
+		return ::fstat(fileDescriptor, &fileStat) == 0 ? fileStat.st_size : -1;
+#endif
+	}
+
+	/// <summary>
+	/// Reads into bytes starting at offset, retrying short reads. Safe to call from several threads at once.
+	/// </summary>
+	/// <param name="bytes"></param>
+	/// <param name="offset"></param>
+	/// <returns>False on errors or if the file ends first</returns>
+	bool readAt(std::span<char> bytes, uint64_t offset) const noexcept
+	{
+		while (!bytes.empty())
+		{
+#if defined(_WIN32)
+			OVERLAPPED position = {};
+			position.Offset = static_cast<DWORD>(offset);
+			position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+			DWORD transferred = 0;
+			const DWORD request = static_cast<DWORD>(std::min<size_t>(bytes.size(), 1u << 30));
+			if (!ReadFile(fileHandle, bytes.data(), request, &transferred, &position) || transferred == 0)
+			{
+				return false;
+			}
+#else
+			const ssize_t transferred = ::pread(fileDescriptor, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+			if (transferred < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (transferred <= 0)
+			{
+				return false;
+			}
+#endif
+			bytes = bytes.subspan(static_cast<size_t>(transferred));
+			offset += static_cast<uint64_t>(transferred);
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// Writes bytes starting at offset, retrying short writes. Safe to call from several threads at once.
+	/// </summary>
+	/// <param name="bytes"></param>
+	/// <param name="offset"></param>
+	/// <returns>False on errors</returns>
+	bool writeAt(std::span<const char> bytes, uint64_t offset) const noexcept
+	{
+		while (!bytes.empty())
+		{
+#if defined(_WIN32)
+			OVERLAPPED position = {};
+			position.Offset = static_cast<DWORD>(offset);
+			position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+			DWORD transferred = 0;
+			const DWORD request = static_cast<DWORD>(std::min<size_t>(bytes.size(), 1u << 30));
+			if (!WriteFile(fileHandle, bytes.data(), request, &transferred, &position) || transferred == 0)
+			{
+				return false;
+			}
+#else
+			const ssize_t transferred = ::pwrite(fileDescriptor, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+			if (transferred < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (transferred <= 0)
+			{
+				return false;
+			}
+#endif
+			bytes = bytes.subspan(static_cast<size_t>(transferred));
+			offset += static_cast<uint64_t>(transferred);
+		}
+		return true;
+	}
+
+#if !defined(_WIN32)
+	int descriptor() const noexcept
+	{
+		return fileDescriptor;
+	}
+#endif
+
+private:
+	void close() noexcept
+	{
+#if defined(_WIN32)
+		if (fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(fileHandle);
+		}
+		fileHandle = INVALID_HANDLE_VALUE;
+#else
+		if (fileDescriptor >= 0)
+		{
+			::close(fileDescriptor);
+		}
+		fileDescriptor = -1;
+#endif
+	}
+
+#if defined(_WIN32)
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+#else
+	int fileDescriptor = -1;
+#endif
+};
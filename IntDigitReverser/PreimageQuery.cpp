@@ -0,0 +1,191 @@
+/*******************************************************************
+* Inverse reversal queries and their verification.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "PreimageQuery.h"
+#include "ReversalPreimages.h"
+#include "ReverseDigits.h"
+#include "ReversedRangeStats.h"
+
+namespace
+{
+	constexpr size_t roundTripCount = 1'000'000;
+
+	template<typename Int>
+	void printPreimages(Int reversed, size_t maxPrinted)
+	{
+		const uint64_t count = countReversalPreimages(reversed);
+		std::println("{:L} values reverse to {} as {} bit values", count, reversed, sizeof(Int) * 8);
+
+		size_t printed = 0;
+		forEachReversalPreimage(reversed, [&](Int value)
+		{
+			if (printed == maxPrinted)
+			{
+				return false;
+			}
+			std::println("  {}", value);
+			++printed;
+			return true;
+		});
+		if (count > printed)
+		{
+			std::println("  ... and {:L} more", count - printed);
+		}
+	}
+
+	/// <summary>
+	/// Every int16_t grouped by its reverse, compared with the engine's answer for every int16_t y.
+	/// </summary>
+	/// <returns>Mismatch count</returns>
+	size_t verifyInt16Exhaustively()
+	{
+		constexpr int32_t lowest = std::numeric_limits<int16_t>::lowest();
+		constexpr int32_t highest = std::numeric_limits<int16_t>::max();
+
+		size_t mismatchCount = 0;
+		std::vector<std::vector<int16_t>> preimagesOf(highest - lowest + 1);
+		for (int32_t value = lowest; value <= highest; ++value)
+		{
+			// The int32_t reference can't overflow on 5 digits, so this is an independent int16_t reverse
+			const int32_t wideReversed = reverseDigits_Reference(value);
+			const int16_t expected = wideReversed > highest || wideReversed < -highest ? 0 : static_cast<int16_t>(wideReversed);
+			const int16_t reversed = reverseDigitsChecked(static_cast<int16_t>(value));
+			mismatchCount += reversed == expected ? 0 : 1;
+			preimagesOf[reversed - lowest].push_back(static_cast<int16_t>(value));
+		}
+
+		for (int32_t reversed = lowest; reversed <= highest; ++reversed)
+		{
+			std::vector<int16_t> expected = preimagesOf[reversed - lowest];
+			std::vector<int16_t> actual = reversalPreimages(static_cast<int16_t>(reversed));
+			std::ranges::sort(expected);
+			std::ranges::sort(actual);
+			if (actual != expected || countReversalPreimages(static_cast<int16_t>(reversed)) != expected.size())
+			{
+				if (++mismatchCount <= 8)
+				{
+					std::println("  int16_t {}: expected {} preimages, got {} (count {})", reversed, expected.size(), actual.size(), countReversalPreimages(static_cast<int16_t>(reversed)));
+				}
+			}
+		}
+		std::println("int16_t: every value and every preimage set checked, {} mismatches", mismatchCount);
+		return mismatchCount;
+	}
+
+	/// <summary>
+	/// Random x must be among the preimages of reverse(x), and every preimage must reverse back to it.
+	/// </summary>
+	/// <returns>Mismatch count</returns>
+	template<typename Int>
+	size_t verifyRoundTrips(std::mt19937_64& generator)
+	{
+		size_t mismatchCount = 0;
+		for (size_t trial = 0; trial < roundTripCount; ++trial)
+		{
+			// Spread over every digit count rather than mostly full length values
+			const Int value = static_cast<Int>(static_cast<int64_t>(generator()) >> (generator() % 64));
+			const Int reversed = reverseDigitsChecked(value);
+			if constexpr (std::is_same_v<Int, int32_t>)
+			{
+				mismatchCount += reversed == reverseDigits_ModuloLookup(value) ? 0 : 1;
+			}
+			if (reversed == 0)
+			{
+				continue;
+			}
+
+			bool found = false;
+			uint64_t visited = 0;
+			forEachReversalPreimage(reversed, [&](Int preimage)
+			{
+				found |= preimage == value;
+				mismatchCount += reverseDigitsChecked(preimage) == reversed ? 0 : 1;
+				++visited;
+			});
+			mismatchCount += found && visited == countReversalPreimages(reversed) ? 0 : 1;
+		}
+
+		// The overflowing preimages of 0 can be cross-checked against the range aggregates' overflow count
+		const uint64_t overflowCount = reversedRangeStats(std::numeric_limits<Int>::lowest(), std::numeric_limits<Int>::max()).overflowCount;
+		mismatchCount += countReversalPreimages(Int(0)) == overflowCount + 1 ? 0 : 1;
+
+		std::println("{} bit: {:L} round trips, {:L} preimages of 0, {} mismatches", sizeof(Int) * 8, roundTripCount, countReversalPreimages(Int(0)), mismatchCount);
+		return mismatchCount;
+	}
+
+	/// <summary>
+	/// Enumerates every int32_t preimage of 0 and checks them with the batch kernel.
+	/// </summary>
+	/// <returns>Mismatch count</returns>
+	size_t verifyInt32Zero()
+	{
+		constexpr size_t blockValues = 64 << 10;
+		std::vector<int32_t> block;
+		std::vector<int32_t> reversed(blockValues);
+		block.reserve(blockValues);
+
+		size_t mismatchCount = 0;
+		uint64_t visited = 0;
+		const auto checkBlock = [&]()
+		{
+			reverseDigits(block, reversed);
+			mismatchCount += static_cast<size_t>(std::ranges::count_if(std::span(reversed).first(block.size()), [](int32_t value) { return value != 0; }));
+			visited += block.size();
+			block.clear();
+		};
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		forEachReversalPreimage(int32_t(0), [&](int32_t preimage)
+		{
+			block.push_back(preimage);
+			if (block.size() == blockValues)
+			{
+				checkBlock();
+			}
+		});
+		checkBlock();
+		const std::chrono::duration<double> seconds = std::chrono::high_resolution_clock::now() - start;
+
+		mismatchCount += visited == countReversalPreimages(int32_t(0)) ? 0 : 1;
+		std::println("32 bit: enumerated all {:L} preimages of 0 in {:.2f}s ({:.0f}M per second), {} mismatches", visited, seconds.count(), static_cast<double>(visited) / seconds.count() / 1e6, mismatchCount);
+		return mismatchCount;
+	}
+}
+
+int runPreimageQuery(int64_t reversed, bool wide, size_t maxPrinted)
+{
+	if (wide)
+	{
+		printPreimages<int64_t>(reversed, maxPrinted);
+		return 0;
+	}
+	if (reversed < std::numeric_limits<int32_t>::lowest() || reversed > std::numeric_limits<int32_t>::max())
+	{
+		std::println(stderr, "{} doesn't fit int32_t, add 64 to treat values as int64_t", reversed);
+		return 1;
+	}
+	printPreimages<int32_t>(static_cast<int32_t>(reversed), maxPrinted);
+	return 0;
+}
+
+int runPreimageVerification()
+{
+	std::mt19937_64 generator(7);
+	size_t mismatchCount = verifyInt16Exhaustively();
+	mismatchCount += verifyRoundTrips<int32_t>(generator);
+	mismatchCount += verifyRoundTrips<int64_t>(generator);
+	mismatchCount += verifyInt32Zero();
+
+	if (mismatchCount != 0)
+	{
+		std::println("\n!!!! {} MISMATCHES", mismatchCount);
+		return 1;
+	}
+	std::println("\nPreimages match enumeration everywhere");
+	return 0;
+}
@@ -0,0 +1,25 @@
+/*******************************************************************
+* Command line front end for ReversalPreimages.h: one inverse
+*	query, and the exhaustive int16_t / randomized wider checks.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Prints how many x reverse to reversed and the first maxPrinted of them.
+/// </summary>
+/// <param name="reversed"></param>
+/// <param name="wide">Treat x as int64_t; reversed must fit int32_t otherwise</param>
+/// <param name="maxPrinted"></param>
+/// <returns>Non-zero if reversed doesn't fit</returns>
+int runPreimageQuery(int64_t reversed, bool wide, size_t maxPrinted);
+
+/// <summary>
+/// Checks the preimage engine against enumeration over every int16_t, then against round trips of random
+///		int32_t and int64_t values, and enumerates every int32_t preimage of 0 to check them all.
+/// </summary>
+/// <returns>Non-zero on any mismatch</returns>
+int runPreimageVerification();
@@ -0,0 +1,202 @@
+/*******************************************************************
+* Range aggregate queries and their verification.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "RangeStatsQuery.h"
+#include "ReversedRangeStats.h"
+
+namespace
+{
+	constexpr uint64_t maxEnumeratedValues = 100'000'000;
+	constexpr size_t maxReportedMismatches = 8;
+
+	template<typename Int>
+	std::string sumText(const ReversedRangeStats<Int>& stats)
+	{
+		if constexpr (std::is_same_v<typename ReversedRangeStats<Int>::Sum, Int128>)
+		{
+			return stats.sum.toString();
+		}
+		else
+		{
+			return std::format("{}", stats.sum);
+		}
+	}
+
+	template<typename Int>
+	void printStats(const ReversedRangeStats<Int>& stats)
+	{
+		std::println("  sum {}, min {}, max {}, {:L} overflowed to 0", sumText(stats), stats.min, stats.max, stats.overflowCount);
+		std::print("  reversed digit counts:");
+		for (size_t digitCount = 1; digitCount < stats.countByDigits.size(); ++digitCount)
+		{
+			if (stats.countByDigits[digitCount] != 0)
+			{
+				std::print(" {}:{:L}", digitCount, stats.countByDigits[digitCount]);
+			}
+		}
+		std::print("\n");
+	}
+
+	template<typename Int>
+	int queryRange(Int first, Int last)
+	{
+		// Repeat the (microsecond) query enough times to time it
+		constexpr size_t repeatCount = 1'000;
+		ReversedRangeStats<Int> stats;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (size_t repeat = 0; repeat < repeatCount; ++repeat)
+		{
+			stats = reversedRangeStats(first, last);
+		}
+		const auto dynamicProgramming = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start) / repeatCount;
+
+		std::println("reverse(x) over [{}, {}] as {} bit values:", first, last, sizeof(Int) * 8);
+		printStats(stats);
+		std::println("  digit DP: {:.2f}us", dynamicProgramming.count());
+
+		if (last < first)
+		{
+			std::println("  empty range");
+			return 0;
+		}
+
+		// Wraps to the right distance even across the whole int64_t range, where the count itself wouldn't fit
+		const uint64_t distance = static_cast<uint64_t>(static_cast<int64_t>(last)) - static_cast<uint64_t>(static_cast<int64_t>(first));
+		if (distance >= maxEnumeratedValues)
+		{
+			std::println("  enumeration skipped, more than {:L} values", maxEnumeratedValues);
+			return 0;
+		}
+
+		start = std::chrono::high_resolution_clock::now();
+		const ReversedRangeStats<Int> enumerated = reversedRangeStats_BruteForce(first, last);
+		const auto enumeration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start);
+		std::println("  enumeration: {:.2f}ms, {}", enumeration.count(), enumerated == stats ? "same result" : "!!!! DIFFERENT RESULT");
+		if (enumerated != stats)
+		{
+			printStats(enumerated);
+			return 1;
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// Range centres where the DP has edge cases: digit count changes, the overflow threshold's digits, and the type limits.
+	/// </summary>
+	template<typename Int>
+	std::vector<Int> interestingCentres()
+	{
+		std::vector<Int> centres = { 0, std::numeric_limits<Int>::max(), std::numeric_limits<Int>::lowest() };
+		for (Int tens = 10; tens <= std::numeric_limits<Int>::max() / 10; tens *= 10)
+		{
+			centres.push_back(tens);
+			centres.push_back(-tens);
+		}
+		// Values whose reverse lands just under the limit, and full length values that overflow or only just don't
+		if constexpr (std::is_same_v<Int, int32_t>)
+		{
+			centres.insert(centres.end(), { 1'463'847'412, -1'463'847'412, 1'000'000'002, 1'000'000'003, 2'000'000'002, -2'000'000'003 });
+		}
+		else
+		{
+			centres.insert(centres.end(), { 7'085'774'586'302'733'229, -7'085'774'586'302'733'229, 1'000'000'000'000'000'009, -1'000'000'000'000'000'008 });
+		}
+		return centres;
+	}
+
+	template<typename Int>
+	size_t verifyType(size_t trialCount, std::mt19937_64& generator)
+	{
+		constexpr std::array<int64_t, 4> widths = { 1, 100, 10'000, 300'000 };
+		const std::vector<Int> centres = interestingCentres<Int>();
+
+		size_t mismatchCount = 0;
+		size_t checkedCount = 0;
+		for (const int64_t width : widths)
+		{
+			for (size_t trial = 0; trial < trialCount; ++trial)
+			{
+				// Half the ranges near an edge case, half anywhere
+				Int centre = static_cast<Int>(generator());
+				if (trial % 2 == 0)
+				{
+					centre = centres[generator() % centres.size()];
+				}
+				const int64_t offset = static_cast<int64_t>(generator() % static_cast<uint64_t>(width * 2 + 1)) - width;
+				const int64_t length = static_cast<int64_t>(generator() % static_cast<uint64_t>(width));
+
+				// Clamp in 64 bits, saturating at the type limits
+				const auto clampToInt = [](int64_t value, int64_t shift)
+				{
+					const int64_t lowest = std::numeric_limits<Int>::lowest();
+					const int64_t highest = std::numeric_limits<Int>::max();
+					if (shift > 0 && value > highest - shift)
+					{
+						return static_cast<Int>(highest);
+					}
+					if (shift < 0 && value < lowest - shift)
+					{
+						return static_cast<Int>(lowest);
+					}
+					return static_cast<Int>(value + shift);
+				};
+				const Int first = clampToInt(static_cast<int64_t>(centre), offset);
+				const Int last = clampToInt(static_cast<int64_t>(first), length);
+
+				const ReversedRangeStats<Int> expected = reversedRangeStats_BruteForce(first, last);
+				const ReversedRangeStats<Int> actual = reversedRangeStats(first, last);
+				++checkedCount;
+				if (expected != actual)
+				{
+					if (++mismatchCount <= maxReportedMismatches)
+					{
+						std::println("  [{}, {}] as {} bit values: expected", first, last, sizeof(Int) * 8);
+						printStats(expected);
+						std::println("  but got");
+						printStats(actual);
+					}
+				}
+			}
+		}
+		std::println("{} bit: {:L} ranges checked, {:L} mismatches", sizeof(Int) * 8, checkedCount, mismatchCount);
+		return mismatchCount;
+	}
+}
+
+int runRangeStats(int64_t first, int64_t last, bool wide)
+{
+	if (wide)
+	{
+		return queryRange<int64_t>(first, last);
+	}
+	if (first < std::numeric_limits<int32_t>::lowest() || last > std::numeric_limits<int32_t>::max())
+	{
+		std::println(stderr, "[{}, {}] doesn't fit int32_t, add 64 to reverse as int64_t", first, last);
+		return 1;
+	}
+	return queryRange<int32_t>(static_cast<int32_t>(first), static_cast<int32_t>(last));
+}
+
+int runRangeStatsVerification(size_t trialCount)
+{
+	std::mt19937_64 generator(42);
+	size_t mismatchCount = verifyType<int32_t>(trialCount, generator);
+	mismatchCount += verifyType<int64_t>(trialCount, generator);
+
+	// The full int16_t range as a fixed case at both widths
+	mismatchCount += reversedRangeStats<int32_t>(-32'768, 32'767) == reversedRangeStats_BruteForce<int32_t>(-32'768, 32'767) ? 0 : 1;
+	mismatchCount += reversedRangeStats<int64_t>(-32'768, 32'767) == reversedRangeStats_BruteForce<int64_t>(-32'768, 32'767) ? 0 : 1;
+
+	if (mismatchCount != 0)
+	{
+		std::println("\n!!!! {} MISMATCHES", mismatchCount);
+		return 1;
+	}
+	std::println("\nDigit DP matches enumeration everywhere");
+	return 0;
+}
@@ -0,0 +1,27 @@
+/*******************************************************************
+* Command line front end for ReversedRangeStats.h: one range query,
+*	and a randomized check of the digit DP against enumeration.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Prints the aggregates of reverse(x) over [first, last] and how long the digit DP took. Ranges of up to
+///		100M values are also enumerated, timed and compared.
+/// </summary>
+/// <param name="first"></param>
+/// <param name="last"></param>
+/// <param name="wide">Reverse as int64_t, where values only overflow past INT64_MAX; first and last must fit int32_t otherwise</param>
+/// <returns>Non-zero if the DP and the enumeration disagreed, or the range doesn't fit</returns>
+int runRangeStats(int64_t first, int64_t last, bool wide);
+
+/// <summary>
+/// Compares reversedRangeStats against reversedRangeStats_BruteForce on trialCount random ranges of each width,
+///		centred near zero, powers of ten, the overflow thresholds and the type limits.
+/// </summary>
+/// <param name="trialCount">Per width</param>
+/// <returns>Non-zero on any mismatch</returns>
+int runRangeStatsVerification(size_t trialCount);
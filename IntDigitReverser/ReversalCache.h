@@ -0,0 +1,178 @@
+/*******************************************************************
+* Memoizing cache in front of the reversal kernels, for inputs that
+*	keep repeating a hot set of values.
+*	Part of the header-only library, next to ReverseDigits.h.
+*
+* Public API:
+*	ReversalCache<Ways>                 set-associative cache of reverse(x); one per thread
+*	reverseDigits_Cached(int32_t)       through a thread_local cache of the default size
+*	reverseDigits_Cached(span, span)    the same for a batch
+*	cachedReversalStats()               hits and misses of the calling thread's cache
+*
+* Each entry packs the value and its reversal into one uint64_t, so
+*	a lookup is one hash, one cache line and a compare per way. The
+*	table starts zeroed, which is already the correct entry for 0,
+*	so there is no separate valid flag. Reversal only takes a few
+*	nanoseconds, so measure with bench-cache before turning this on:
+*	it pays only while the hot set fits and the hit rate stays high.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "ReverseDigits.h"
+
+struct ReversalCacheStats
+{
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+
+	double hitRate() const noexcept
+	{
+		return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+	}
+};
+
+/// <summary>
+/// Set-associative cache of reverseDigits_ModuloLookup. Not synchronized: give every thread its own.
+///		Direct-mapped is the default: every extra way adds to each hit more than its fewer conflict misses save.
+/// </summary>
+/// <typeparam name="Ways">Entries per set; 1 is direct-mapped</typeparam>
+template<size_t Ways = 1>
+class ReversalCache
+{
+	static_assert(std::has_single_bit(Ways) && Ways <= 8, "Ways has to be a power of two, at most a cache line of entries");
+
+public:
+	// Half of a typical 512 KiB to 2 MiB L2, leaving room for the data being reversed
+	static constexpr size_t defaultBytes = 256 << 10;
+
+	/// <param name="bytes">Table size, rounded down to a power of two number of sets</param>
+	explicit ReversalCache(size_t bytes = defaultBytes)
+		: setMask(std::bit_floor(std::max<size_t>(bytes / (sizeof(uint64_t) * Ways), 1)) - 1)
+		, entries(std::make_unique<uint64_t[]>((setMask + 1) * Ways))
+	{
+	}
+
+	/// <summary>
+	/// reverseDigits_ModuloLookup(value), from the cache if it's there. A miss evicts the set's oldest entry.
+	/// </summary>
+	/// <param name="value"></param>
+	/// <returns></returns>
+	int32_t reverseDigits(int32_t value) noexcept
+	{
+		uint64_t* const set = entries.get() + setIndex(value) * Ways;
+
+		// Check every way without branching on which one matched, which would mispredict on nearly every hit
+		uint64_t found = 0;
+		bool hit = false;
+		for (size_t way = 0; way < Ways; ++way)
+		{
+			const bool matches = static_cast<uint32_t>(set[way]) == static_cast<uint32_t>(value);
+			found |= matches ? set[way] : 0;
+			hit |= matches;
+		}
+		if (hit)
+		{
+			++counters.hits;
+			return static_cast<int32_t>(found >> 32);
+		}
+
+		++counters.misses;
+		const int32_t reversed = reverseDigits_ModuloLookup(value);
+		// Newest first, so the last way is always the oldest
+		std::copy_backward(set, set + Ways - 1, set + Ways);
+		set[0] = static_cast<uint32_t>(value) | (static_cast<uint64_t>(static_cast<uint32_t>(reversed)) << 32);
+		return reversed;
+	}
+
+	/// <summary>
+	/// Reverses min(input.size(), output.size()) values through the cache.
+	/// </summary>
+	/// <param name="input"></param>
+	/// <param name="output"></param>
+	void reverseDigits(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+	{
+		const size_t count = std::min(input.size(), output.size());
+		for (size_t index = 0; index < count; ++index)
+		{
+			output[index] = reverseDigits(input[index]);
+		}
+	}
+
+	ReversalCacheStats stats() const noexcept
+	{
+		return counters;
+	}
+
+	size_t sizeInBytes() const noexcept
+	{
+		return (setMask + 1) * Ways * sizeof(uint64_t);
+	}
+
+	/// <summary>
+	/// Empties the cache and zeroes the counters.
+	/// </summary>
+	void clear() noexcept
+	{
+		std::fill_n(entries.get(), (setMask + 1) * Ways, uint64_t(0));
+		counters = {};
+	}
+
+private:
+	size_t setIndex(int32_t value) const noexcept
+	{
+		// Fibonacci hashing spreads sequential IDs, which would otherwise fill consecutive sets in step
+		return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(value)) * 0x9E37'79B9'7F4A'7C15) >> 32) & setMask;
+	}
+
+	const size_t setMask;
+	std::unique_ptr<uint64_t[]> entries;
+	ReversalCacheStats counters;
+};
+
+/// <summary>
+/// The calling thread's cache behind reverseDigits_Cached, created on first use.
+/// </summary>
+/// <returns></returns>
+inline ReversalCache<>& threadReversalCache() noexcept
+{
+	thread_local ReversalCache<> cache;
+	return cache;
+}
+
+/// <summary>
+/// reverseDigits_ModuloLookup(value) through the calling thread's cache. Only faster than computing it when
+///		the same values come back often; see bench-cache.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+inline int32_t reverseDigits_Cached(int32_t value) noexcept
+{
+	return threadReversalCache().reverseDigits(value);
+}
+
+/// <summary>
+/// Reverses min(input.size(), output.size()) values through the calling thread's cache.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+inline void reverseDigits_Cached(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+	threadReversalCache().reverseDigits(input, output);
+}
+
+/// <summary>
+/// Hits and misses of the calling thread's reverseDigits_Cached so far.
+/// </summary>
+/// <returns></returns>
+inline ReversalCacheStats cachedReversalStats() noexcept
+{
+	return threadReversalCache().stats();
+}
@@ -0,0 +1,166 @@
+/*******************************************************************
+* Where memoizing the reversal stops paying for itself.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "BenchmarkTiming.h"
+#include "ReversalCache.h"
+#include "ReversalCacheBenchmark.h"
+#include "ReverseDigits.h"
+
+namespace
+{
+	/// <summary>
+	/// sampleCount draws of value IDs whose rank k is picked with probability proportional to 1 / k^skew.
+	/// </summary>
+	/// <param name="distinctValues"></param>
+	/// <param name="skew"></param>
+	/// <param name="sampleCount"></param>
+	/// <returns></returns>
+	std::vector<int32_t> zipfSamples(size_t distinctValues, double skew, size_t sampleCount)
+	{
+		std::mt19937_64 random(distinctValues ^ static_cast<uint64_t>(skew * 1000));
+
+		// Random IDs rather than the ranks themselves, so hot values are spread over every digit count and set
+		std::vector<int32_t> ids(distinctValues);
+		for (int32_t& id : ids)
+		{
+			id = static_cast<int32_t>(static_cast<uint32_t>(random()));
+		}
+
+		std::vector<double> cumulative(distinctValues);
+		double total = 0.0;
+		for (size_t rank = 0; rank < distinctValues; ++rank)
+		{
+			total += 1.0 / std::pow(static_cast<double>(rank + 1), skew);
+			cumulative[rank] = total;
+		}
+
+		std::uniform_real_distribution<double> uniform(0.0, total);
+		std::vector<int32_t> samples(sampleCount);
+		for (int32_t& sample : samples)
+		{
+			const size_t rank = static_cast<size_t>(std::ranges::lower_bound(cumulative, uniform(random)) - cumulative.begin());
+			sample = ids[std::min(rank, distinctValues - 1)];
+		}
+		return samples;
+	}
+
+	/// <summary>
+	/// medianTimePerCall of a call over valueCount values, per value.
+	/// </summary>
+	template<typename Call>
+	double nanosecondsPerValue(size_t valueCount, Call&& call)
+	{
+		return medianTimePerCall(call).count() / static_cast<double>(valueCount);
+	}
+
+	struct CacheConfig
+	{
+		std::string_view name;
+		// Runs the cache over input into output, returning the hit rate of that run
+		std::function<double(std::span<const int32_t>, std::span<int32_t>)> run;
+	};
+
+	template<size_t Ways>
+	CacheConfig makeConfig(std::string_view name, size_t bytes)
+	{
+		auto cache = std::make_shared<ReversalCache<Ways>>(bytes);
+		return { name, [cache](std::span<const int32_t> input, std::span<int32_t> output)
+		{
+			const ReversalCacheStats before = cache->stats();
+			cache->reverseDigits(input, output);
+			const ReversalCacheStats after = cache->stats();
+			return ReversalCacheStats{ after.hits - before.hits, after.misses - before.misses }.hitRate();
+		} };
+	}
+}
+
+int runReversalCacheBenchmark(size_t sampleCount)
+{
+	constexpr size_t distinctValueCounts[] = { 1 << 10, 1 << 14, 1 << 18, 1 << 20, 1 << 22 };
+	constexpr double skews[] = { 0.8, 1.0, 1.2 };
+
+	sampleCount = std::max<size_t>(sampleCount, 1);
+	std::vector<int32_t> output(sampleCount);
+	bool allCorrect = true;
+
+	const auto makeConfigs = []()
+	{
+		return std::vector<CacheConfig>{
+			makeConfig<1>("direct 256K", 256 << 10),
+			makeConfig<2>("2-way 64K", 64 << 10),
+			makeConfig<2>("2-way 256K", 256 << 10),
+			makeConfig<4>("4-way 256K", 256 << 10),
+			makeConfig<2>("2-way 1M", 1 << 20),
+		};
+	};
+
+	std::println("{:L} Zipf distributed lookups per run, ns per value and hit rate; caches are warmed by one untimed run\n", sampleCount);
+	std::print("{:>10} {:>5} {:>9}", "distinct", "skew", "compute");
+	for (const CacheConfig& config : makeConfigs())
+	{
+		std::print(" {:>19}", config.name);
+	}
+	std::print("\n");
+
+	// The lowest hit rate at which a cache still won, and the highest at which it lost
+	double lowestWinningHitRate = 1.0;
+	double highestLosingHitRate = 0.0;
+	for (const size_t distinctValues : distinctValueCounts)
+	{
+		for (const double skew : skews)
+		{
+			const std::vector<int32_t> input = zipfSamples(distinctValues, skew, sampleCount);
+			std::vector<int32_t> expected(sampleCount);
+
+			const double computeTime = nanosecondsPerValue(sampleCount, [&]()
+			{
+				for (size_t index = 0; index < input.size(); ++index)
+				{
+					expected[index] = reverseDigits_ModuloLookup(input[index]);
+				}
+			});
+			std::print("{:>10L} {:>5.1f} {:>7.3f}ns", distinctValues, skew, computeTime);
+
+			for (CacheConfig& config : makeConfigs())
+			{
+				double hitRate = 0.0;
+				const double cacheTime = nanosecondsPerValue(sampleCount, [&]() { hitRate = config.run(input, output); });
+				allCorrect &= output == expected;
+				std::print(" {:>7.3f}ns {:>6.1f}% {}", cacheTime, 100.0 * hitRate, cacheTime < computeTime ? '+' : ' ');
+
+				if (cacheTime < computeTime)
+				{
+					lowestWinningHitRate = std::min(lowestWinningHitRate, hitRate);
+				}
+				else
+				{
+					highestLosingHitRate = std::max(highestLosingHitRate, hitRate);
+				}
+			}
+			std::print("\n");
+		}
+	}
+
+	std::println("\n+ marks a cache beating computation");
+	if (lowestWinningHitRate > highestLosingHitRate)
+	{
+		std::println("Caching paid at hit rates of {:.1f}% and up, and never below {:.1f}%", 100.0 * lowestWinningHitRate, 100.0 * highestLosingHitRate);
+	}
+	else
+	{
+		std::println("No clean cut-off: caches won at hit rates down to {:.1f}% and lost at up to {:.1f}%, so table size matters as much as hit rate",
+			100.0 * lowestWinningHitRate, 100.0 * highestLosingHitRate);
+	}
+
+	if (!allCorrect)
+	{
+		std::println("\n!!!! WRONG RESULTS");
+		return 1;
+	}
+	return 0;
+}
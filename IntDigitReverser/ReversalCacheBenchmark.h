@@ -0,0 +1,16 @@
+/*******************************************************************
+* ReversalCache against plain computation on Zipf skewed inputs.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary>
+/// For hot sets of 1K to 4M distinct values under Zipf skews 0.8 to 1.2, times reverseDigits_ModuloLookup
+///		against ReversalCache in several sizes and associativities, printing the hit rates and the hit rate below
+///		which the cache stops paying for itself.
+/// </summary>
+/// <param name="sampleCount">Lookups per measurement</param>
+/// <returns>Non-zero on wrong results</returns>
+int runReversalCacheBenchmark(size_t sampleCount);
@@ -0,0 +1,276 @@
+/*******************************************************************
+* Inverse of the digit reversal: every x with reverse(x) == y.
+*	Part of the header-only library, next to ReverseDigits.h.
+*
+* Public API:
+*	countReversalPreimages(y)               how many x map to y, without enumerating them
+*	forEachReversalPreimage(y, visit)       calls visit(x) for each of them, output sensitive
+*	reversalPreimages(y)                    the same, collected into a vector
+*	reverseDigitsChecked(x)                 reverse(x) for any of the supported widths
+*
+* Works for int16_t, int32_t and int64_t, each with
+*	reverseDigits_ModuloLookup's semantics at that width (sign kept,
+*	0 once the reversed magnitude passes the type's max), so the
+*	int16_t instance can be checked exhaustively.
+*
+* For y != 0 the preimages are reverse(|y|) followed by any number
+*	of zeros, while that fits: 21 <- 12, 120, 1200, ... . A y ending
+*	in 0 has none, and neither has a y whose magnitude reversed
+*	doesn't fit. y == 0 is 0 itself plus every full length x whose
+*	reverse overflows; those are enumerated by walking x's digits
+*	from the least significant one, only into branches a digit
+*	count table says still lead to an overflowing x in range.
+*******************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "ReverseDigits.h"
+
+template<typename Int>
+concept PreimageInteger = std::is_same_v<Int, int16_t> || std::is_same_v<Int, int32_t> || std::is_same_v<Int, int64_t>;
+
+/// <summary>
+/// reverse(x) at x's own width: sign kept, 0 if the reversed magnitude is larger than the type's max.
+///		reverseDigits_Reference64 at int64_t, and matches reverseDigits_ModuloLookup for int32_t.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+template<PreimageInteger Int>
+constexpr Int reverseDigitsChecked(Int value) noexcept
+{
+	if constexpr (std::is_same_v<Int, int64_t>)
+	{
+		return reverseDigits_Reference64(value);
+	}
+	else
+	{
+		// Narrower widths reverse in int64_t, where they can't overflow, and then check against their own max
+		const int64_t reversed = reverseDigits_Reference64(value);
+		constexpr int64_t max = std::numeric_limits<Int>::max();
+		return reversed < -max || reversed > max ? Int(0) : static_cast<Int>(reversed);
+	}
+}
+
+/// <summary>
+/// The x of one sign whose reverse overflows: full length magnitudes up to bound whose digits reversed exceed limit.
+///		Holds, per digit position and comparison state, how many ways the remaining digits can finish such an x.
+/// </summary>
+class OverflowPreimageTable
+{
+public:
+	/// <param name="bound">Largest magnitude of this sign, max or max + 1</param>
+	/// <param name="limit">Largest reversed magnitude that doesn't overflow, the type's max</param>
+	constexpr OverflowPreimageTable(uint64_t bound, uint64_t limit) noexcept
+		: digitCount(decimalDigitCount(bound))
+	{
+		// Split into digits once; the walk compares against them at every node
+		for (size_t position = 0; position < digitCount; ++position)
+		{
+			boundDigits[position] = static_cast<uint8_t>(bound / wideTensLookupTable[position] % 10);
+			limitDigits[position] = static_cast<uint8_t>(limit / wideTensLookupTable[digitCount - 1 - position] % 10);
+		}
+
+		for (size_t againstLimit = 0; againstLimit < 3; ++againstLimit)
+		{
+			for (size_t againstBound = 0; againstBound < 3; ++againstBound)
+			{
+				completions[digitCount][againstLimit][againstBound] = againstLimit == Greater && againstBound != Greater ? 1 : 0;
+			}
+		}
+
+		for (size_t position = digitCount; position-- > 0;)
+		{
+			for (size_t againstLimit = 0; againstLimit < 3; ++againstLimit)
+			{
+				for (size_t againstBound = 0; againstBound < 3; ++againstBound)
+				{
+					uint64_t total = 0;
+					for (uint64_t digit = firstDigit(position); digit < 10; ++digit)
+					{
+						total += completions[position + 1][nextAgainstLimit(position, againstLimit, digit)][nextAgainstBound(position, againstBound, digit)];
+					}
+					completions[position][againstLimit][againstBound] = total;
+				}
+			}
+		}
+	}
+
+	constexpr uint64_t count() const noexcept
+	{
+		return completions[0][Equal][Equal];
+	}
+
+	/// <summary>
+	/// Calls visit(magnitude) for each such x; every branch taken ends in one, so the cost is O(digits) per x.
+	/// </summary>
+	/// <param name="visit">Returns false to stop early</param>
+	/// <returns>False if visit stopped it</returns>
+	template<typename Visit>
+	constexpr bool forEach(Visit&& visit) const
+	{
+		return walk(0, Equal, Equal, 0, visit);
+	}
+
+private:
+	enum Compare : uint8_t
+	{
+		Less,
+		Equal,
+		Greater,
+	};
+
+	// The most significant digit can't be 0, or x wouldn't be full length
+	constexpr uint64_t firstDigit(size_t position) const noexcept
+	{
+		return position == digitCount - 1 ? 1 : 0;
+	}
+
+	// Digit position of x is digit (digitCount - 1 - position) of reverse(x), from the top, so the first difference decides
+	constexpr size_t nextAgainstLimit(size_t position, size_t againstLimit, uint64_t digit) const noexcept
+	{
+		const uint64_t limitDigit = limitDigits[position];
+		return againstLimit != Equal ? againstLimit : digit < limitDigit ? Less : digit > limitDigit ? Greater : Equal;
+	}
+
+	// x itself is built from the bottom, so each more significant difference overrides the ones before
+	constexpr size_t nextAgainstBound(size_t position, size_t againstBound, uint64_t digit) const noexcept
+	{
+		const uint64_t boundDigit = boundDigits[position];
+		return digit < boundDigit ? Less : digit > boundDigit ? Greater : againstBound;
+	}
+
+	template<typename Visit>
+	constexpr bool walk(size_t position, size_t againstLimit, size_t againstBound, uint64_t magnitude, Visit& visit) const
+	{
+		if (position == digitCount)
+		{
+			return visit(magnitude);
+		}
+
+		for (uint64_t digit = firstDigit(position); digit < 10; ++digit)
+		{
+			const size_t limitState = nextAgainstLimit(position, againstLimit, digit);
+			const size_t boundState = nextAgainstBound(position, againstBound, digit);
+			if (completions[position + 1][limitState][boundState] != 0
+				&& !walk(position + 1, limitState, boundState, magnitude + digit * wideTensLookupTable[position], visit))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	size_t digitCount;
+	// boundDigits[n] is digit n of bound from the bottom; limitDigits[n] is the digit of limit that digit n of x lines up with in reverse(x)
+	std::array<uint8_t, 20> boundDigits = {};
+	std::array<uint8_t, 20> limitDigits = {};
+	// [position][reverse(x) against limit][x against bound]
+	std::array<std::array<std::array<uint64_t, 3>, 3>, 20> completions = {};
+};
+
+/// <summary>
+/// Calls visit for every x with reverseDigitsChecked(x) == reversed, in O(digits) per x with no scan over the domain.
+///		y != 0 has at most digits preimages; 0 has about 1.8 billion for int32_t.
+/// </summary>
+/// <param name="reversed">y</param>
+/// <param name="visit">Callable with Int; returning bool, false stops the enumeration</param>
+template<PreimageInteger Int, typename Visit>
+constexpr void forEachReversalPreimage(Int reversed, Visit&& visit)
+{
+	const auto emit = [&](Int value)
+	{
+		if constexpr (std::is_same_v<std::invoke_result_t<Visit&, Int>, bool>)
+		{
+			return visit(value);
+		}
+		else
+		{
+			visit(value);
+			return true;
+		}
+	};
+
+	constexpr uint64_t limit = static_cast<uint64_t>(std::numeric_limits<Int>::max());
+
+	if (reversed == 0)
+	{
+		if (!emit(0))
+		{
+			return;
+		}
+		const bool completed = OverflowPreimageTable(limit, limit).forEach([&](uint64_t magnitude) { return emit(static_cast<Int>(magnitude)); });
+		if (completed)
+		{
+			OverflowPreimageTable(limit + 1, limit).forEach([&](uint64_t magnitude) { return emit(static_cast<Int>(-static_cast<int64_t>(magnitude - 1) - 1)); });
+		}
+		return;
+	}
+
+	// A reversed value never ends in 0 (that would have been a leading zero), and can't be the one magnitude past max
+	const uint64_t magnitude = reversed < 0 ? 0 - static_cast<uint64_t>(static_cast<int64_t>(reversed)) : static_cast<uint64_t>(reversed);
+	if (magnitude % 10 == 0 || magnitude > limit)
+	{
+		return;
+	}
+
+	const uint64_t bound = reversed < 0 ? limit + 1 : limit;
+	for (uint64_t preimage = reverseMagnitude(magnitude); preimage <= bound; preimage *= 10)
+	{
+		if (!emit(static_cast<Int>(reversed < 0 ? -static_cast<int64_t>(preimage - 1) - 1 : static_cast<int64_t>(preimage))))
+		{
+			return;
+		}
+		if (preimage > bound / 10)
+		{
+			return;
+		}
+	}
+}
+
+/// <summary>
+/// Number of x with reverseDigitsChecked(x) == reversed, in O(digits^2) at most.
+/// </summary>
+/// <param name="reversed">y</param>
+/// <returns></returns>
+template<PreimageInteger Int>
+constexpr uint64_t countReversalPreimages(Int reversed) noexcept
+{
+	constexpr uint64_t limit = static_cast<uint64_t>(std::numeric_limits<Int>::max());
+
+	if (reversed == 0)
+	{
+		return 1 + OverflowPreimageTable(limit, limit).count() + OverflowPreimageTable(limit + 1, limit).count();
+	}
+
+	const uint64_t magnitude = reversed < 0 ? 0 - static_cast<uint64_t>(static_cast<int64_t>(reversed)) : static_cast<uint64_t>(reversed);
+	if (magnitude % 10 == 0 || magnitude > limit)
+	{
+		return 0;
+	}
+
+	// One preimage per power of ten that still fits after reverse(|y|)
+	const uint64_t bound = reversed < 0 ? limit + 1 : limit;
+	const uint64_t smallest = reverseMagnitude(magnitude);
+	return smallest > bound ? 0 : decimalDigitCount(bound / smallest);
+}
+
+/// <summary>
+/// forEachReversalPreimage collected into a vector. Mind the size for 0.
+/// </summary>
+/// <param name="reversed"></param>
+/// <returns></returns>
+template<PreimageInteger Int>
+std::vector<Int> reversalPreimages(Int reversed)
+{
+	std::vector<Int> preimages;
+	preimages.reserve(static_cast<size_t>(countReversalPreimages(reversed)));
+	forEachReversalPreimage(reversed, [&](Int value) { preimages.push_back(value); });
+	return preimages;
+}
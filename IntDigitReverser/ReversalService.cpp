@@ -0,0 +1,415 @@
+/*******************************************************************
+* Reversal service: a reader thread per connection queues requests,
+*	one batcher thread gathers everything queued within the batch
+*	window into a single buffer for the batch kernel and scatters
+*	the replies, one send per connection per batch.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+#include <cstdio>
+
+#include "ClosedLoopLoad.h"
+#include "LocalSocket.h"
+#include "ReversalService.h"
+#include "ReverseDigits.h"
+
+namespace
+{
+	struct ServiceConnection
+	{
+		LocalSocket socket;
+		std::atomic<bool> closed = false;
+	};
+
+	struct PendingRequest
+	{
+		std::shared_ptr<ServiceConnection> connection;
+		std::vector<int32_t> values;
+	};
+
+	struct BatchStatistics
+	{
+		uint64_t batchCount = 0;
+		uint64_t requestCount = 0;
+		uint64_t valueCount = 0;
+	};
+
+	class BatchingServer
+	{
+	public:
+		/// <summary>
+		/// Starts accepting on listener right away.
+		/// </summary>
+		/// <param name="listener">From LocalSocket::listen(address)</param>
+		/// <param name="address">Used to wake the accept loop on stop</param>
+		/// <param name="batchWindow"></param>
+		BatchingServer(LocalSocket listener, std::string_view address, std::chrono::microseconds batchWindow)
+			: listener(std::move(listener))
+			, address(address)
+			, batchWindow(batchWindow)
+		{
+			batchThread = std::jthread([this]() { batchLoop(); });
+			acceptThread = std::jthread([this]() { acceptLoop(); });
+		}
+
+		~BatchingServer()
+		{
+			stop();
+		}
+
+		/// <summary>
+		/// Stops accepting, disconnects every client and waits for all threads. Queued requests are dropped.
+		/// </summary>
+		void stop()
+		{
+			{
+				std::scoped_lock lock(queueMutex);
+				if (stopping)
+				{
+					return;
+				}
+				stopping = true;
+			}
+			queueChanged.notify_all();
+
+			// accept has no portable way to be interrupted, so wake it with a connection of our own
+			if (std::expected<LocalSocket, std::string> wakeup = LocalSocket::connect(address))
+			{
+				acceptThread.join();
+			}
+			else
+			{
+				listener.shutdown();
+				acceptThread.join();
+			}
+
+			for (Session& session : sessions)
+			{
+				session.connection->socket.shutdown();
+			}
+			sessions.clear();
+			batchThread.join();
+		}
+
+		BatchStatistics statistics()
+		{
+			std::scoped_lock lock(queueMutex);
+			return batchStatistics;
+		}
+
+	private:
+		struct Session
+		{
+			std::shared_ptr<ServiceConnection> connection;
+			std::jthread reader;
+		};
+
+		void acceptLoop()
+		{
+			for (;;)
+			{
+				std::expected<LocalSocket, std::string> socket = listener.accept();
+				{
+					std::scoped_lock lock(queueMutex);
+					if (stopping)
+					{
+						return;
+					}
+				}
+				if (!socket)
+				{
+					std::println(stderr, "{}", socket.error());
+					continue;
+				}
+				if (!socket->setSendTimeout(serviceSendTimeout))
+				{
+					std::println(stderr, "Couldn't set a send timeout, dropping the connection");
+					continue;
+				}
+
+				// Finished sessions are joined here rather than piling up in a long running server
+				std::erase_if(sessions, [](const Session& session) { return session.connection->closed.load(); });
+
+				auto connection = std::make_shared<ServiceConnection>(std::move(*socket));
+				sessions.push_back({ connection, std::jthread([this, connection]() { readLoop(connection); }) });
+			}
+		}
+
+		void readLoop(const std::shared_ptr<ServiceConnection>& connection)
+		{
+			for (;;)
+			{
+				uint32_t count = 0;
+				if (!connection->socket.receiveAll(std::span(reinterpret_cast<char*>(&count), sizeof(count))) || count > maxServiceRequestValues)
+				{
+					break;
+				}
+
+				PendingRequest request = { connection, std::vector<int32_t>(count) };
+				if (!connection->socket.receiveAll(std::span(reinterpret_cast<char*>(request.values.data()), request.values.size() * sizeof(int32_t))))
+				{
+					break;
+				}
+
+				{
+					std::scoped_lock lock(queueMutex);
+					queuedValues += count;
+					queue.push_back(std::move(request));
+				}
+				queueChanged.notify_one();
+			}
+
+			connection->socket.shutdown();
+			connection->closed = true;
+		}
+
+		void batchLoop()
+		{
+			std::vector<PendingRequest> requests;
+			std::vector<int32_t> batch;
+			std::unordered_map<ServiceConnection*, std::vector<char>> replies;
+
+			for (;;)
+			{
+				{
+					std::unique_lock lock(queueMutex);
+					queueChanged.wait(lock, [this]() { return stopping || !queue.empty(); });
+					if (stopping)
+					{
+						return;
+					}
+
+					// Give concurrent clients a chance to join this batch, unless it is already big enough
+					if (batchWindow.count() > 0)
+					{
+						queueChanged.wait_for(lock, batchWindow, [this]() { return stopping || queuedValues >= maxServiceBatchValues; });
+					}
+
+					requests.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()));
+					queue.clear();
+					batchStatistics.batchCount += 1;
+					batchStatistics.requestCount += requests.size();
+					batchStatistics.valueCount += queuedValues;
+					queuedValues = 0;
+				}
+
+				// Gather into one contiguous run for the kernel...
+				batch.clear();
+				for (const PendingRequest& request : requests)
+				{
+					batch.insert(batch.end(), request.values.begin(), request.values.end());
+				}
+				reverseDigits(batch, batch);
+
+				// ...and scatter back out, in request order, grouped per connection
+				const int32_t* reversed = batch.data();
+				for (const PendingRequest& request : requests)
+				{
+					std::vector<char>& reply = replies[request.connection.get()];
+					const uint32_t count = static_cast<uint32_t>(request.values.size());
+					const char* const countBytes = reinterpret_cast<const char*>(&count);
+					const char* const valueBytes = reinterpret_cast<const char*>(reversed);
+					reply.insert(reply.end(), countBytes, countBytes + sizeof(count));
+					reply.insert(reply.end(), valueBytes, valueBytes + count * sizeof(int32_t));
+					reversed += count;
+				}
+
+				// A client too slow to take its reply within serviceSendTimeout is dropped, rather than holding up the rest
+				for (const PendingRequest& request : requests)
+				{
+					std::vector<char>& reply = replies[request.connection.get()];
+					if (!reply.empty() && !request.connection->socket.sendAll(reply))
+					{
+						request.connection->socket.shutdown();
+					}
+					reply.clear();
+				}
+
+				// Keep the buffers of connections that are still sending, forget the rest
+				std::erase_if(replies, [&](const auto& entry)
+				{
+					return std::ranges::none_of(requests, [&](const PendingRequest& request) { return request.connection.get() == entry.first; });
+				});
+				requests.clear();
+			}
+		}
+
+		LocalSocket listener;
+		std::string address;
+		std::chrono::microseconds batchWindow;
+
+		std::mutex queueMutex;
+		std::condition_variable queueChanged;
+		std::deque<PendingRequest> queue;
+		size_t queuedValues = 0;
+		bool stopping = false;
+		BatchStatistics batchStatistics;
+
+		// Only touched by the accept thread, and by stop after it has exited
+		std::vector<Session> sessions;
+
+		std::jthread batchThread;
+		std::jthread acceptThread;
+	};
+
+	/// <summary>
+	/// One connection to the service, as a closed loop client.
+	/// </summary>
+	struct SocketClient
+	{
+		LocalSocket socket;
+		std::vector<int32_t> request;
+		std::vector<int32_t> reply;
+
+		bool operator()(std::span<const int32_t> values, std::span<int32_t> reversed)
+		{
+			// [count][values...] for the request, the same shape comes back
+			const uint32_t count = static_cast<uint32_t>(values.size());
+			request.resize(values.size() + 1);
+			reply.resize(values.size() + 1);
+			std::memcpy(request.data(), &count, sizeof(count));
+			std::ranges::copy(values, request.begin() + 1);
+
+			if (!socket.sendAll(std::span(reinterpret_cast<const char*>(request.data()), request.size() * sizeof(int32_t)))
+				|| !socket.receiveAll(std::span(reinterpret_cast<char*>(reply.data()), reply.size() * sizeof(int32_t))))
+			{
+				return false;
+			}
+
+			uint32_t replyCount = 0;
+			std::memcpy(&replyCount, reply.data(), sizeof(replyCount));
+			std::ranges::copy(reply | std::views::drop(1), reversed.begin());
+			return replyCount == count;
+		}
+	};
+
+	/// <summary>
+	/// Connects connectionCount clients to address and runs the closed loop load over them.
+	/// </summary>
+	/// <param name="address"></param>
+	/// <param name="connectionCount"></param>
+	/// <param name="requestCount">Per connection</param>
+	/// <param name="valuesPerRequest">Already clamped to [1, maxServiceRequestValues] by the entry points</param>
+	/// <returns>The latency distribution, or a description of what failed</returns>
+	std::expected<LoadSummary, std::string> generateLoad(std::string_view address, size_t connectionCount, size_t requestCount, size_t valuesPerRequest)
+	{
+		std::vector<SocketClient> clients;
+		for (size_t connectionIndex = 0; connectionIndex < connectionCount; ++connectionIndex)
+		{
+			std::expected<LocalSocket, std::string> socket = LocalSocket::connect(address);
+			if (!socket)
+			{
+				return std::unexpected(socket.error());
+			}
+			clients.push_back({ std::move(*socket) });
+		}
+
+		std::expected<LoadSummary, std::string> summary = measureClosedLoop(std::span(clients), requestCount, valuesPerRequest);
+		if (!summary)
+		{
+			return std::unexpected(std::format("Connection to {} failed mid run", address));
+		}
+		return summary;
+	}
+}
+
+std::string defaultServiceAddress()
+{
+	return "unix:" + (std::filesystem::temp_directory_path() / "intdigitreverser.sock").string();
+}
+
+int runReversalServer(std::string_view address, std::chrono::microseconds batchWindow)
+{
+	std::expected<LocalSocket, std::string> listener = LocalSocket::listen(address);
+	if (!listener)
+	{
+		std::println(stderr, "{}", listener.error());
+		return 1;
+	}
+
+	std::println("Serving on {} with a {}us batch window, {}", address, batchWindow.count(), toString(batchSimdLevel()));
+	std::fflush(stdout);
+	BatchingServer server(std::move(*listener), address, batchWindow);
+
+	for (;;)
+	{
+		std::this_thread::sleep_for(std::chrono::seconds(10));
+
+		const BatchStatistics statistics = server.statistics();
+		std::println("{:L} requests in {:L} batches, {:.1f} requests and {:.1f} values per batch", statistics.requestCount, statistics.batchCount,
+			static_cast<double>(statistics.requestCount) / static_cast<double>(std::max<uint64_t>(statistics.batchCount, 1)),
+			static_cast<double>(statistics.valueCount) / static_cast<double>(std::max<uint64_t>(statistics.batchCount, 1)));
+		std::fflush(stdout);
+	}
+}
+
+int runReversalLoad(std::string_view address, size_t connectionCount, size_t requestCount, size_t valuesPerRequest)
+{
+	valuesPerRequest = std::clamp<size_t>(valuesPerRequest, 1, maxServiceRequestValues);
+	std::println("{} connections x {:L} requests of {} values against {}", connectionCount, requestCount, valuesPerRequest, address);
+
+	const std::expected<LoadSummary, std::string> summary = generateLoad(address, connectionCount, requestCount, valuesPerRequest);
+	if (!summary)
+	{
+		std::println(stderr, "{}", summary.error());
+		return 1;
+	}
+
+	printLoadSummary(*summary, valuesPerRequest);
+	return summary->wrongReplies == 0 ? 0 : 1;
+}
+
+std::expected<LoadSummary, std::string> measureReversalService(std::string_view address, std::chrono::microseconds batchWindow, size_t connectionCount, size_t requestCount, size_t valuesPerRequest)
+{
+	std::expected<LocalSocket, std::string> listener = LocalSocket::listen(address);
+	if (!listener)
+	{
+		return std::unexpected(listener.error());
+	}
+
+	BatchingServer server(std::move(*listener), address, batchWindow);
+	return generateLoad(address, connectionCount, requestCount, std::clamp<size_t>(valuesPerRequest, 1, maxServiceRequestValues));
+}
+
+int runReversalServiceBenchmark(std::string_view address, size_t connectionCount, size_t requestCount, size_t valuesPerRequest)
+{
+	constexpr std::chrono::microseconds batchWindows[] = {
+		std::chrono::microseconds(0),
+		std::chrono::microseconds(10),
+		std::chrono::microseconds(50),
+		std::chrono::microseconds(200),
+	};
+
+	valuesPerRequest = std::clamp<size_t>(valuesPerRequest, 1, maxServiceRequestValues);
+	std::println("{} connections x {:L} requests of {} values on {}, {}\n", connectionCount, requestCount, valuesPerRequest, address, toString(batchSimdLevel()));
+
+	bool allCorrect = true;
+	for (const std::chrono::microseconds batchWindow : batchWindows)
+	{
+		std::expected<LocalSocket, std::string> listener = LocalSocket::listen(address);
+		if (!listener)
+		{
+			std::println(stderr, "{}", listener.error());
+			return 1;
+		}
+
+		BatchingServer server(std::move(*listener), address, batchWindow);
+		const std::expected<LoadSummary, std::string> summary = generateLoad(address, connectionCount, requestCount, valuesPerRequest);
+		server.stop();
+		if (!summary)
+		{
+			std::println(stderr, "{}", summary.error());
+			return 1;
+		}
+
+		const BatchStatistics statistics = server.statistics();
+		std::println("Batch window {}us: {:.1f} requests per batch", batchWindow.count(),
+			static_cast<double>(statistics.requestCount) / static_cast<double>(std::max<uint64_t>(statistics.batchCount, 1)));
+		printLoadSummary(*summary, valuesPerRequest);
+		allCorrect &= summary->wrongReplies == 0;
+	}
+
+	return allCorrect ? 0 : 1;
+}
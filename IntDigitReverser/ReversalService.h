@@ -0,0 +1,78 @@
+/*******************************************************************
+* Local reversal service, so other processes don't each have to
+*	link the kernels: a server that coalesces concurrent requests
+*	into larger batches, and a load generating client.
+*
+*	Protocol, over a Unix domain socket or loopback TCP, in native
+*	byte order: a request is a uint32_t count followed by count
+*	int32_t values; the reply has the same shape with every value
+*	reversed. Requests on one connection may be pipelined and are
+*	answered in order.
+*******************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+
+struct LoadSummary;
+
+// Larger requests are treated as a protocol error and drop the connection
+inline constexpr uint32_t maxServiceRequestValues = 1 << 20;
+
+// The batcher stops waiting for more requests once it holds this many values
+inline constexpr size_t maxServiceBatchValues = 64 << 10;
+
+// The batcher sends every reply itself, so a client that stops reading would stall everyone's replies;
+//	a reply send blocked this long drops that client instead
+inline constexpr std::chrono::milliseconds serviceSendTimeout{ 100 };
+
+/// <summary>
+/// A Unix socket in the temp directory, used when no address is given.
+/// </summary>
+/// <returns></returns>
+std::string defaultServiceAddress();
+
+/// <summary>
+/// Serves reversal requests on address until the process is killed.
+/// </summary>
+/// <param name="address">"unix:&lt;path&gt;" or "tcp:&lt;port&gt;"</param>
+/// <param name="batchWindow">How long the batcher waits after the first queued request for others to join its batch</param>
+/// <returns>Non-zero if the server couldn't start</returns>
+int runReversalServer(std::string_view address, std::chrono::microseconds batchWindow);
+
+/// <summary>
+/// Closed loop load against a running server: connectionCount connections, each sending requestCount requests of
+///		valuesPerRequest random values one at a time. Checks every reply and prints p50 / p99 latency and requests/s.
+/// </summary>
+/// <param name="address"></param>
+/// <param name="connectionCount"></param>
+/// <param name="requestCount">Per connection</param>
+/// <param name="valuesPerRequest"></param>
+/// <returns>Non-zero on connection errors or wrong replies</returns>
+int runReversalLoad(std::string_view address, size_t connectionCount, size_t requestCount, size_t valuesPerRequest);
+
+/// <summary>
+/// Starts an in-process server on address and runs the runReversalLoad load against it.
+/// </summary>
+/// <param name="address"></param>
+/// <param name="batchWindow"></param>
+/// <param name="connectionCount"></param>
+/// <param name="requestCount">Per connection</param>
+/// <param name="valuesPerRequest"></param>
+/// <returns>The latency distribution, or a description of what failed</returns>
+std::expected<LoadSummary, std::string> measureReversalService(std::string_view address, std::chrono::microseconds batchWindow, size_t connectionCount, size_t requestCount, size_t valuesPerRequest);
+
+/// <summary>
+/// Starts an in-process server on address for each of a range of batch windows and runs the same load against it.
+/// </summary>
+/// <param name="address"></param>
+/// <param name="connectionCount"></param>
+/// <param name="requestCount">Per connection</param>
+/// <param name="valuesPerRequest"></param>
+/// <returns>Non-zero on errors or wrong replies</returns>
+int runReversalServiceBenchmark(std::string_view address, size_t connectionCount, size_t requestCount, size_t valuesPerRequest);
@@ -0,0 +1,603 @@
+/*******************************************************************
+* Reverse-and-add (x -> x + reverse(x) until a palindrome appears)
+*	on decimal digit arrays of any length, for Lychrel sweeps.
+*	Part of the header-only library, next to ReverseDigits.h.
+*
+* Public API:
+*	toDigitArray(value)                          least significant digit first, one digit per byte
+*	reverseAndAdd(digits)                        one step in place, picks the widest SIMD kernel
+*	isDigitArrayPalindrome(digits)
+*	reverseAndAddUntilPalindrome(seed, limit)    iterations for one seed
+*	sweepReverseAndAdd(options[, visit])         every seed in a range, on every core, memoized
+*
+* x + reverse(x) is symmetric before carries: digit i and digit
+*	n - 1 - i both get d[i] + d[n - 1 - i]. So a step is one pass
+*	adding the array to its mirror image, then one carry pass. The
+*	AVX2 carry pass is a carry-lookahead over 32 digits at a time:
+*	a digit above 9 generates a carry and a 9 propagates one, which
+*	is exactly the binary carry chain of G + (G | P) on bitmasks.
+*
+* Seeds collapse onto shared threads quickly (89 and 98 both go to
+*	187), so a sweep remembers how many steps every iterate that
+*	still fits uint64_t needed, in a lock-free table, and a seed
+*	landing on a known iterate stops there.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ReverseDigits.h"
+#include "ThreadAffinity.h"
+
+/// <summary>
+/// The digits of value, least significant first; 0 is the single digit 0.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+inline std::vector<uint8_t> toDigitArray(uint64_t value)
+{
+	std::vector<uint8_t> digits;
+	do
+	{
+		digits.push_back(static_cast<uint8_t>(value % 10));
+		value /= 10;
+	} while (value != 0);
+	return digits;
+}
+
+/// <summary>
+/// The value of a digit array, if it has at most 19 digits and so always fits uint64_t.
+/// </summary>
+/// <param name="digits">Least significant first</param>
+/// <returns></returns>
+inline std::optional<uint64_t> fromDigitArray(std::span<const uint8_t> digits) noexcept
+{
+	if (digits.size() > 19)
+	{
+		return std::nullopt;
+	}
+	uint64_t value = 0;
+	for (size_t index = digits.size(); index-- > 0;)
+	{
+		value = value * 10 + digits[index];
+	}
+	return value;
+}
+
+/// <summary>
+/// Most significant digit first, for printing.
+/// </summary>
+/// <param name="digits">Least significant first</param>
+/// <returns></returns>
+inline std::string digitArrayToString(std::span<const uint8_t> digits)
+{
+	std::string text(digits.size(), '0');
+	for (size_t index = 0; index < digits.size(); ++index)
+	{
+		text[digits.size() - 1 - index] = static_cast<char>('0' + digits[index]);
+	}
+	return text;
+}
+
+/// <summary>
+/// Whether the digits read the same both ways.
+/// </summary>
+/// <param name="digits"></param>
+/// <returns></returns>
+inline bool isDigitArrayPalindrome_Scalar(std::span<const uint8_t> digits) noexcept
+{
+	const size_t size = digits.size();
+	for (size_t low = 0; low < size / 2; ++low)
+	{
+		if (digits[low] != digits[size - 1 - low])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// One reverse-and-add step in place with plain byte arithmetic; the array grows by a digit on a final carry.
+/// </summary>
+/// <param name="digits">Least significant first, each 0-9</param>
+inline void reverseAndAdd_Scalar(std::vector<uint8_t>& digits)
+{
+	const size_t size = digits.size();
+	for (size_t low = 0; low < size / 2; ++low)
+	{
+		const uint8_t pairSum = static_cast<uint8_t>(digits[low] + digits[size - 1 - low]);
+		digits[low] = pairSum;
+		digits[size - 1 - low] = pairSum;
+	}
+	if (size % 2 == 1)
+	{
+		digits[size / 2] *= 2;
+	}
+
+	uint8_t carry = 0;
+	for (uint8_t& digit : digits)
+	{
+		const uint8_t sum = static_cast<uint8_t>(digit + carry);
+		carry = sum >= 10 ? 1 : 0;
+		digit = static_cast<uint8_t>(sum - carry * 10);
+	}
+	if (carry != 0)
+	{
+		digits.push_back(1);
+	}
+}
+
+#if REVERSEDIGITS_X86
+
+/// <summary>
+/// The 32 bytes in the opposite order.
+/// </summary>
+/// <param name="bytes"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m256i reverseBytes_AVX2(__m256i bytes) noexcept
+{
+	const __m256i reverseWithinLanes = _mm256_setr_epi8(
+		15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+		15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(bytes, reverseWithinLanes), 0b01'00'11'10);
+}
+
+/// <summary>
+/// Bit n of mask as byte n, 0 or 1.
+/// </summary>
+/// <param name="mask"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m256i expandBitsToBytes_AVX2(uint32_t mask) noexcept
+{
+	// Byte n takes mask byte n / 8, then keeps only its own bit of it
+	const __m256i spreadBytes = _mm256_setr_epi64x(0x0000'0000'0000'0000, 0x0101'0101'0101'0101, 0x0202'0202'0202'0202, 0x0303'0303'0303'0303);
+	const __m256i bitPerByte = _mm256_set1_epi64x(static_cast<int64_t>(0x8040'2010'0804'0201));
+	const __m256i spread = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int32_t>(mask)), spreadBytes);
+	return _mm256_min_epu8(_mm256_and_si256(spread, bitPerByte), _mm256_set1_epi8(1));
+}
+
+/// <summary>
+/// isDigitArrayPalindrome_Scalar comparing 32 digits from each end at a time. Only call this if the CPU supports AVX2.
+/// </summary>
+/// <param name="digits"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline bool isDigitArrayPalindrome_AVX2(std::span<const uint8_t> digits) noexcept
+{
+	const size_t size = digits.size();
+	size_t low = 0;
+	for (; 2 * low + 64 <= size; low += 32)
+	{
+		const __m256i front = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(digits.data() + low));
+		const __m256i back = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(digits.data() + size - low - 32));
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(front, reverseBytes_AVX2(back))) != -1)
+		{
+			return false;
+		}
+	}
+	return isDigitArrayPalindrome_Scalar(digits.subspan(low, size - 2 * low));
+}
+
+/// <summary>
+/// reverseAndAdd_Scalar 32 digits at a time: the pair sums from both ends at once, then the carries with
+///		a carry-lookahead on the digit masks instead of a digit by digit chain. Only call this if the CPU supports AVX2.
+/// </summary>
+/// <param name="digits">Least significant first, each 0-9</param>
+REVERSEDIGITS_TARGET_AVX2 inline void reverseAndAdd_AVX2(std::vector<uint8_t>& digits)
+{
+	const size_t size = digits.size();
+	uint8_t* const data = digits.data();
+
+	size_t low = 0;
+	for (; 2 * low + 64 <= size; low += 32)
+	{
+		const size_t high = size - low - 32;
+		const __m256i front = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + low));
+		const __m256i back = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + high));
+		const __m256i pairSums = _mm256_add_epi8(front, reverseBytes_AVX2(back));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + low), pairSums);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + high), reverseBytes_AVX2(pairSums));
+	}
+	for (; low < size / 2; ++low)
+	{
+		const uint8_t pairSum = static_cast<uint8_t>(data[low] + data[size - 1 - low]);
+		data[low] = pairSum;
+		data[size - 1 - low] = pairSum;
+	}
+	if (size % 2 == 1)
+	{
+		data[size / 2] *= 2;
+	}
+
+	// Every digit is now 0-18, so it takes a carry of at most 1 and passes at most 1 on
+	const __m256i nine = _mm256_set1_epi8(9);
+	const __m256i ten = _mm256_set1_epi8(10);
+	uint64_t carry = 0;
+	size_t index = 0;
+	for (; index + 32 <= size; index += 32)
+	{
+		const __m256i sums = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+		const uint64_t generates = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(sums, nine)));
+		const uint64_t propagates = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(sums, nine)));
+
+		const uint64_t chain = generates + (generates | propagates) + carry;
+		const uint32_t carriesIn = static_cast<uint32_t>(chain ^ generates ^ (generates | propagates));
+		carry = chain >> 32;
+
+		const __m256i withCarries = _mm256_add_epi8(sums, expandBitsToBytes_AVX2(carriesIn));
+		const __m256i digitsOut = _mm256_sub_epi8(withCarries, _mm256_and_si256(_mm256_cmpgt_epi8(withCarries, nine), ten));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + index), digitsOut);
+	}
+	for (; index < size; ++index)
+	{
+		const uint8_t sum = static_cast<uint8_t>(data[index] + carry);
+		carry = sum >= 10 ? 1 : 0;
+		data[index] = static_cast<uint8_t>(sum - carry * 10);
+	}
+	if (carry != 0)
+	{
+		digits.push_back(1);
+	}
+}
+
+#endif // REVERSEDIGITS_X86
+
+/// <summary>
+/// Whether the digits read the same both ways, with the widest kernel the CPU supports.
+/// </summary>
+/// <param name="digits"></param>
+/// <returns></returns>
+inline bool isDigitArrayPalindrome(std::span<const uint8_t> digits) noexcept
+{
+#if REVERSEDIGITS_X86
+	if (activeSimdLevel() >= SimdLevel::AVX2)
+	{
+		return isDigitArrayPalindrome_AVX2(digits);
+	}
+#endif
+	return isDigitArrayPalindrome_Scalar(digits);
+}
+
+/// <summary>
+/// digits = digits + reverse(digits) in place, with the widest kernel the CPU supports.
+/// </summary>
+/// <param name="digits">Least significant first, each 0-9</param>
+inline void reverseAndAdd(std::vector<uint8_t>& digits)
+{
+#if REVERSEDIGITS_X86
+	if (activeSimdLevel() >= SimdLevel::AVX2)
+	{
+		reverseAndAdd_AVX2(digits);
+		return;
+	}
+#endif
+	reverseAndAdd_Scalar(digits);
+}
+
+struct ReverseAndAddResult
+{
+	// Steps taken; the iteration limit if no palindrome appeared
+	uint32_t iterations = 0;
+	bool reachedPalindrome = false;
+
+	bool operator==(const ReverseAndAddResult&) const = default;
+};
+
+/// <summary>
+/// Steps until seed becomes a palindrome. At least one step is always taken, so a palindromic seed doesn't count.
+/// </summary>
+/// <param name="seed"></param>
+/// <param name="iterationLimit">Steps after which the seed counts as a Lychrel candidate</param>
+/// <param name="finalDigits">If not null, receives the last iterate</param>
+/// <returns></returns>
+inline ReverseAndAddResult reverseAndAddUntilPalindrome(uint64_t seed, uint32_t iterationLimit, std::vector<uint8_t>* finalDigits = nullptr)
+{
+	std::vector<uint8_t> digits = toDigitArray(seed);
+	ReverseAndAddResult result;
+	while (result.iterations < iterationLimit && !result.reachedPalindrome)
+	{
+		reverseAndAdd(digits);
+		++result.iterations;
+		result.reachedPalindrome = isDigitArrayPalindrome(digits);
+	}
+	if (finalDigits != nullptr)
+	{
+		*finalDigits = std::move(digits);
+	}
+	return result;
+}
+
+/// <summary>
+/// Lock-free map from an iterate that fits uint64_t to how its own iterations ended. Open addressing with
+///		a short probe; when that is full an insert is dropped, which only costs a later recomputation.
+/// </summary>
+class ReverseAndAddMemo
+{
+public:
+	/// <param name="capacity">Rounded up to a power of two; 12 bytes each</param>
+	explicit ReverseAndAddMemo(size_t capacity)
+		: mask(std::bit_ceil(std::max<size_t>(capacity, 64)) - 1)
+		, keys(std::make_unique<std::atomic<uint64_t>[]>(mask + 1))
+		, results(std::make_unique<std::atomic<uint32_t>[]>(mask + 1))
+	{
+	}
+
+	/// <summary>
+	/// How iterating value ended, if some thread has recorded it.
+	/// </summary>
+	/// <param name="value"></param>
+	/// <returns>Exact steps if it reached a palindrome, otherwise how many steps are known to have none</returns>
+	std::optional<ReverseAndAddResult> find(uint64_t value) const noexcept
+	{
+		const uint64_t key = value + 1;
+		for (size_t probe = 0, slot = hash(key); probe < maxProbes; ++probe, slot = (slot + 1) & mask)
+		{
+			const uint64_t stored = keys[slot].load(std::memory_order_acquire);
+			if (stored == 0)
+			{
+				return std::nullopt;
+			}
+			if (stored == key)
+			{
+				// The key is claimed before its result is written, so 0 here means still in flight
+				const uint32_t packed = results[slot].load(std::memory_order_acquire);
+				if (packed == 0)
+				{
+					return std::nullopt;
+				}
+				return ReverseAndAddResult{ packed & ~unresolvedBit, (packed & unresolvedBit) == 0 };
+			}
+		}
+		return std::nullopt;
+	}
+
+	void insert(uint64_t value, ReverseAndAddResult result) noexcept
+	{
+		const uint64_t key = value + 1;
+		const uint32_t packed = result.iterations | (result.reachedPalindrome ? 0 : unresolvedBit);
+		for (size_t probe = 0, slot = hash(key); probe < maxProbes; ++probe, slot = (slot + 1) & mask)
+		{
+			uint64_t stored = keys[slot].load(std::memory_order_relaxed);
+			if (stored == 0 && keys[slot].compare_exchange_strong(stored, key, std::memory_order_acq_rel))
+			{
+				stored = key;
+			}
+			if (stored == key)
+			{
+				results[slot].store(packed, std::memory_order_release);
+				return;
+			}
+		}
+	}
+
+private:
+	static constexpr size_t maxProbes = 16;
+	static constexpr uint32_t unresolvedBit = 0x8000'0000;
+
+	size_t hash(uint64_t key) const noexcept
+	{
+		return static_cast<size_t>((key * 0x9E37'79B9'7F4A'7C15) >> 32) & mask;
+	}
+
+	// Keys are value + 1, so 0 marks an empty slot; 10^19 - 1 + 1 still fits
+	const size_t mask;
+	std::unique_ptr<std::atomic<uint64_t>[]> keys;
+	std::unique_ptr<std::atomic<uint32_t>[]> results;
+};
+
+struct ReverseAndAddSweepOptions
+{
+	uint64_t first = 1;
+	uint64_t last = 100'000;
+	uint32_t iterationLimit = 500;
+	// 0 for every available core, each pinned to its own
+	size_t threadCount = 0;
+	// 0 turns memoization off
+	size_t memoCapacity = size_t(1) << 22;
+};
+
+struct ReverseAndAddThreadStats
+{
+	uint64_t seeds = 0;
+	// Steps actually computed, and the digits they touched
+	uint64_t iterations = 0;
+	uint64_t digitSteps = 0;
+	// Seeds cut short by the memo, and the steps that saved
+	uint64_t memoHits = 0;
+	uint64_t iterationsSaved = 0;
+	std::chrono::duration<double> busy = {};
+};
+
+struct ReverseAndAddSweepReport
+{
+	uint64_t palindromeSeeds = 0;
+	uint64_t lychrelCandidates = 0;
+	// The seed needing the most steps to a palindrome, the smallest on ties
+	uint64_t slowestSeed = 0;
+	uint32_t slowestIterations = 0;
+	std::vector<ReverseAndAddThreadStats> threads;
+	std::chrono::duration<double> elapsed = {};
+};
+
+namespace ReverseAndAddDetail
+{
+	// Iterates that fit uint64_t, recorded for the memo; the threads leave that range within a few dozen steps
+	constexpr size_t maxRecordedChain = 64;
+
+	/// <summary>
+	/// reverseAndAddUntilPalindrome with the memo consulted and filled along the way.
+	/// </summary>
+	inline ReverseAndAddResult iterateSeed(uint64_t seed, uint32_t iterationLimit, std::vector<uint8_t>& digits, ReverseAndAddMemo* memo, ReverseAndAddThreadStats& stats)
+	{
+		digits.clear();
+		do
+		{
+			digits.push_back(static_cast<uint8_t>(seed % 10));
+			seed /= 10;
+		} while (seed != 0);
+
+		std::array<uint64_t, maxRecordedChain> chain;
+		size_t chainLength = 0;
+
+		ReverseAndAddResult result;
+		while (result.iterations < iterationLimit)
+		{
+			reverseAndAdd(digits);
+			++result.iterations;
+			++stats.iterations;
+			stats.digitSteps += digits.size();
+			if (isDigitArrayPalindrome(digits))
+			{
+				result.reachedPalindrome = true;
+				break;
+			}
+
+			const std::optional<uint64_t> value = memo != nullptr && chainLength < maxRecordedChain ? fromDigitArray(digits) : std::nullopt;
+			if (!value)
+			{
+				continue;
+			}
+			if (const std::optional<ReverseAndAddResult> known = memo->find(*value))
+			{
+				// Known to end in a palindrome, or known to have none for at least as far as this seed may go
+				if (known->reachedPalindrome || result.iterations + known->iterations >= iterationLimit)
+				{
+					const uint32_t remaining = known->reachedPalindrome ? known->iterations : iterationLimit - result.iterations;
+					const uint32_t total = std::min(result.iterations + remaining, iterationLimit);
+					++stats.memoHits;
+					stats.iterationsSaved += total - result.iterations;
+					result = { total, known->reachedPalindrome && result.iterations + remaining <= iterationLimit };
+					break;
+				}
+			}
+			chain[chainLength++] = *value;
+		}
+
+		// Iterate n of the chain was reached after n + 1 steps
+		if (memo != nullptr)
+		{
+			for (size_t index = 0; index < chainLength; ++index)
+			{
+				memo->insert(chain[index], { result.iterations - static_cast<uint32_t>(index + 1), result.reachedPalindrome });
+			}
+		}
+		return result;
+	}
+}
+
+/// <summary>
+/// Runs every seed in [first, last] on a thread per core, seeds handed out in blocks from a shared counter.
+/// </summary>
+/// <param name="options"></param>
+/// <param name="visit">Called as visit(seed, ReverseAndAddResult) from the worker threads, concurrently</param>
+/// <returns></returns>
+template<typename Visit>
+ReverseAndAddSweepReport sweepReverseAndAdd(const ReverseAndAddSweepOptions& options, Visit&& visit)
+{
+	constexpr uint64_t seedsPerBlock = 1024;
+
+	const std::vector<size_t> cores = availableCores();
+	const size_t threadCount = options.threadCount != 0 ? options.threadCount : cores.size();
+	const uint64_t seedCount = options.last >= options.first ? options.last - options.first + 1 : 0;
+	const uint64_t blockCount = seedCount / seedsPerBlock + (seedCount % seedsPerBlock != 0 ? 1 : 0);
+
+	std::unique_ptr<ReverseAndAddMemo> memo = options.memoCapacity != 0 ? std::make_unique<ReverseAndAddMemo>(options.memoCapacity) : nullptr;
+	std::atomic<uint64_t> nextBlock = 0;
+
+	struct alignas(64) ThreadResult
+	{
+		ReverseAndAddThreadStats stats;
+		ReverseAndAddSweepReport partial;
+	};
+	std::vector<ThreadResult> threadResults(threadCount);
+
+	const auto work = [&](size_t thread)
+	{
+		if (options.threadCount == 0)
+		{
+			pinCurrentThreadToCore(cores[thread % cores.size()]);
+		}
+
+		ThreadResult& own = threadResults[thread];
+		std::vector<uint8_t> digits;
+		digits.reserve(options.iterationLimit / 2 + 32);
+
+		const auto start = std::chrono::steady_clock::now();
+		for (uint64_t block = nextBlock.fetch_add(1, std::memory_order_relaxed); block < blockCount; block = nextBlock.fetch_add(1, std::memory_order_relaxed))
+		{
+			const uint64_t blockFirst = options.first + block * seedsPerBlock;
+			const uint64_t blockSize = std::min(seedsPerBlock, seedCount - block * seedsPerBlock);
+			for (uint64_t offset = 0; offset < blockSize; ++offset)
+			{
+				const uint64_t seed = blockFirst + offset;
+				const ReverseAndAddResult result = ReverseAndAddDetail::iterateSeed(seed, options.iterationLimit, digits, memo.get(), own.stats);
+				++own.stats.seeds;
+				if (!result.reachedPalindrome)
+				{
+					++own.partial.lychrelCandidates;
+				}
+				else
+				{
+					++own.partial.palindromeSeeds;
+					if (result.iterations > own.partial.slowestIterations || (result.iterations == own.partial.slowestIterations && seed < own.partial.slowestSeed))
+					{
+						own.partial.slowestIterations = result.iterations;
+						own.partial.slowestSeed = seed;
+					}
+				}
+				visit(seed, result);
+			}
+		}
+		own.stats.busy = std::chrono::steady_clock::now() - start;
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+	{
+		// Every participant gets its own thread, so pinning never changes the caller's affinity
+		std::vector<std::jthread> workers;
+		workers.reserve(threadCount);
+		for (size_t thread = 0; thread < threadCount; ++thread)
+		{
+			workers.emplace_back(work, thread);
+		}
+	}
+
+	ReverseAndAddSweepReport report;
+	report.elapsed = std::chrono::steady_clock::now() - start;
+	for (const ThreadResult& threadResult : threadResults)
+	{
+		const ReverseAndAddSweepReport& partial = threadResult.partial;
+		report.palindromeSeeds += partial.palindromeSeeds;
+		report.lychrelCandidates += partial.lychrelCandidates;
+		if (partial.palindromeSeeds != 0 && (partial.slowestIterations > report.slowestIterations || (partial.slowestIterations == report.slowestIterations && partial.slowestSeed < report.slowestSeed)))
+		{
+			report.slowestIterations = partial.slowestIterations;
+			report.slowestSeed = partial.slowestSeed;
+		}
+		report.threads.push_back(threadResult.stats);
+	}
+	return report;
+}
+
+/// <summary>
+/// sweepReverseAndAdd without a per seed callback.
+/// </summary>
+/// <param name="options"></param>
+/// <returns></returns>
+inline ReverseAndAddSweepReport sweepReverseAndAdd(const ReverseAndAddSweepOptions& options)
+{
+	return sweepReverseAndAdd(options, [](uint64_t, ReverseAndAddResult) {});
+}
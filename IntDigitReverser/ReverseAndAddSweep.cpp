@@ -0,0 +1,192 @@
+/*******************************************************************
+* Lychrel sweeps on the reverse-and-add engine, and its checks.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "ReverseAndAdd.h"
+#include "ReverseAndAddSweep.h"
+#include "ReverseDigits.h"
+
+namespace
+{
+	constexpr size_t maxReportedMismatches = 8;
+
+	struct KnownSeed
+	{
+		uint64_t seed;
+		ReverseAndAddResult result;
+		// The palindrome it ends on, empty if not checked
+		std::string_view palindrome;
+	};
+
+	// 89, 10911 and 150296 each set the record for the most steps among smaller seeds, 1186060307891929990 holds it
+	//		at 261, and 196 is the smallest Lychrel candidate
+	constexpr KnownSeed knownSeeds[] = {
+		{ 89, { 24, true }, "8813200023188" },
+		{ 10911, { 55, true }, "4668731596684224866951378664" },
+		{ 150296, { 64, true }, "" },
+		{ 1'186'060'307'891'929'990, { 261, true }, "" },
+		{ 196, { 1000, false }, "" },
+		{ 0, { 1, true }, "0" },
+		{ 10, { 1, true }, "11" },
+	};
+}
+
+int runReverseAndAddSweep(uint64_t first, uint64_t last, uint32_t iterationLimit, size_t threadCount, bool memoize)
+{
+	if (last < first || iterationLimit == 0)
+	{
+		std::println(stderr, "Need first <= last and a non-zero iteration limit");
+		return 1;
+	}
+
+	ReverseAndAddSweepOptions options;
+	options.first = first;
+	options.last = last;
+	options.iterationLimit = iterationLimit;
+	options.threadCount = threadCount;
+	options.memoCapacity = memoize ? options.memoCapacity : 0;
+
+	std::println("Reverse-and-add over seeds [{:L}, {:L}], up to {} steps, {}, {}", first, last, iterationLimit, memoize ? "memoized" : "no memo", toString(batchSimdLevel()));
+	const ReverseAndAddSweepReport report = sweepReverseAndAdd(options);
+
+	std::println("  {:L} reach a palindrome, {:L} Lychrel candidates", report.palindromeSeeds, report.lychrelCandidates);
+	if (report.palindromeSeeds != 0)
+	{
+		std::println("  slowest: {:L} after {} steps", report.slowestSeed, report.slowestIterations);
+	}
+
+	std::println("\n{:>8} {:>12} {:>16} {:>12} {:>14} {:>16} {:>14}", "thread", "seeds", "steps", "memo hits", "steps saved", "steps/s", "digits/s");
+	ReverseAndAddThreadStats total;
+	for (size_t thread = 0; thread < report.threads.size(); ++thread)
+	{
+		const ReverseAndAddThreadStats& stats = report.threads[thread];
+		const double seconds = std::max(stats.busy.count(), 1e-9);
+		std::println("{:>8} {:>12L} {:>16L} {:>12L} {:>14L} {:>16.0f} {:>14.3e}", thread, stats.seeds, stats.iterations, stats.memoHits, stats.iterationsSaved,
+			static_cast<double>(stats.iterations) / seconds, static_cast<double>(stats.digitSteps) / seconds);
+		total.seeds += stats.seeds;
+		total.iterations += stats.iterations;
+		total.digitSteps += stats.digitSteps;
+		total.memoHits += stats.memoHits;
+		total.iterationsSaved += stats.iterationsSaved;
+		total.busy += stats.busy;
+	}
+
+	const double seconds = std::max(report.elapsed.count(), 1e-9);
+	std::println("\n  {:.3f}s wall, {:.0f} steps/s in total, {:.0f} steps/s per core, {:.1f} digits per step on average",
+		seconds, static_cast<double>(total.iterations) / seconds, static_cast<double>(total.iterations) / std::max(total.busy.count(), 1e-9),
+		total.iterations != 0 ? static_cast<double>(total.digitSteps) / static_cast<double>(total.iterations) : 0.0);
+	if (memoize)
+	{
+		std::println("  the memo answered {:L} seeds early and saved {:L} steps, {:.1f}% of the work", total.memoHits, total.iterationsSaved,
+			100.0 * static_cast<double>(total.iterationsSaved) / std::max<double>(static_cast<double>(total.iterations + total.iterationsSaved), 1.0));
+	}
+	return 0;
+}
+
+int runReverseAndAddVerification()
+{
+	size_t mismatches = 0;
+	const auto report = [&](std::string_view check, std::string_view detail)
+	{
+		if (mismatches++ < maxReportedMismatches)
+		{
+			std::println("  MISMATCH {}: {}", check, detail);
+		}
+	};
+
+	// Random arrays of every length up to a few hundred digits, plus runs of 9s for long carry chains
+	std::mt19937_64 random(42);
+	size_t arraysChecked = 0;
+	for (size_t length = 1; length <= 400; ++length)
+	{
+		for (size_t trial = 0; trial < 32; ++trial)
+		{
+			std::vector<uint8_t> digits(length);
+			for (uint8_t& digit : digits)
+			{
+				digit = static_cast<uint8_t>(trial % 4 == 0 ? 9 - random() % 2 : random() % 10);
+			}
+			// Digit arrays never carry leading zeros
+			for (uint8_t* end : { &digits.front(), &digits.back() })
+			{
+				*end = *end == 0 ? static_cast<uint8_t>(1 + random() % 9) : *end;
+			}
+			if (trial % 8 == 1)
+			{
+				for (size_t index = 0; index < length / 2; ++index)
+				{
+					digits[length - 1 - index] = digits[index];
+				}
+			}
+
+			const std::optional<uint64_t> value = fromDigitArray(digits);
+			std::vector<uint8_t> scalar = digits;
+			reverseAndAdd_Scalar(scalar);
+			if (value && length <= 18 && scalar != toDigitArray(*value + fromDigitArray(std::vector<uint8_t>(digits.rbegin(), digits.rend())).value()))
+			{
+				report("scalar step vs uint64_t", digitArrayToString(digits));
+			}
+#if REVERSEDIGITS_X86
+			if (activeSimdLevel() >= SimdLevel::AVX2)
+			{
+				std::vector<uint8_t> simd = digits;
+				reverseAndAdd_AVX2(simd);
+				if (simd != scalar)
+				{
+					report("AVX2 step", digitArrayToString(digits));
+				}
+				if (isDigitArrayPalindrome_AVX2(digits) != isDigitArrayPalindrome_Scalar(digits))
+				{
+					report("AVX2 palindrome", digitArrayToString(digits));
+				}
+			}
+#endif
+			++arraysChecked;
+		}
+	}
+	std::println("Checked {:L} random digit arrays of 1 to 400 digits", arraysChecked);
+
+	for (const KnownSeed& known : knownSeeds)
+	{
+		std::vector<uint8_t> finalDigits;
+		const ReverseAndAddResult result = reverseAndAddUntilPalindrome(known.seed, 1000, &finalDigits);
+		if (result != known.result || (!known.palindrome.empty() && digitArrayToString(finalDigits) != known.palindrome))
+		{
+			report("known seed", std::format("{} took {} steps, {}", known.seed, result.iterations, result.reachedPalindrome ? "palindrome" : "none"));
+		}
+	}
+	std::println("Checked {} seeds with known step counts", std::size(knownSeeds));
+
+	constexpr uint64_t sweepLast = 200'000;
+	ReverseAndAddSweepOptions options;
+	options.first = 0;
+	options.last = sweepLast;
+	options.iterationLimit = 300;
+
+	std::vector<ReverseAndAddResult> memoized(sweepLast + 1);
+	std::vector<ReverseAndAddResult> plain(sweepLast + 1);
+	const ReverseAndAddSweepReport memoizedReport = sweepReverseAndAdd(options, [&](uint64_t seed, ReverseAndAddResult result) { memoized[seed] = result; });
+	options.memoCapacity = 0;
+	options.threadCount = 1;
+	sweepReverseAndAdd(options, [&](uint64_t seed, ReverseAndAddResult result) { plain[seed] = result; });
+	for (uint64_t seed = 0; seed <= sweepLast; ++seed)
+	{
+		if (memoized[seed] != plain[seed])
+		{
+			report("memoized sweep", std::format("seed {}: {} vs {} steps", seed, memoized[seed].iterations, plain[seed].iterations));
+		}
+	}
+	std::println("Compared a memoized sweep of [0, {:L}] seed by seed, {:L} Lychrel candidates", sweepLast, memoizedReport.lychrelCandidates);
+
+	if (mismatches != 0)
+	{
+		std::println("\n!!!! {} MISMATCHES", mismatches);
+		return 1;
+	}
+	std::println("\nAll reverse-and-add checks passed");
+	return 0;
+}
@@ -0,0 +1,29 @@
+/*******************************************************************
+* Reverse-and-add (Lychrel) sweeps over seed ranges, and checks of
+*	the digit array engine.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Iterates every seed in [first, last] until it becomes a palindrome or reaches iterationLimit steps, then prints
+///		the outcome counts, the slowest seed, and the steps per second of every thread.
+/// </summary>
+/// <param name="first"></param>
+/// <param name="last"></param>
+/// <param name="iterationLimit">Steps after which a seed counts as a Lychrel candidate</param>
+/// <param name="threadCount">0 for one pinned thread per available core</param>
+/// <param name="memoize">Remember the outcome of every iterate that fits uint64_t, shared by all threads</param>
+/// <returns>Non-zero on bad arguments</returns>
+int runReverseAndAddSweep(uint64_t first, uint64_t last, uint32_t iterationLimit, size_t threadCount, bool memoize);
+
+/// <summary>
+/// Checks the AVX2 step and palindrome test against the scalar ones on random digit arrays and against uint64_t
+///		arithmetic, known iteration counts (89, 10911, 150296, 1186060307891929990, 196), and a memoized multi-threaded sweep
+///		against an unmemoized single-threaded one seed by seed.
+/// </summary>
+/// <returns>Non-zero on any mismatch</returns>
+int runReverseAndAddVerification();
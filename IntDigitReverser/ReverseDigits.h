@@ -0,0 +1,1284 @@
+/*******************************************************************
+* Header-only digit reversal library. The benchmark, the fuzzers and
+*	outside code all use this one header, so what gets timed is what ships.
+*
+* Public API:
+*	reverseDigits(int32_t)                      recommended scalar kernel, constexpr
+*	reverseDigits(span<const int32_t>, span)    batch, dispatches to the widest SIMD kernel the CPU supports
+*	reverseDigits_*                             the individual scalar and batch kernels
+*	reverseDigits_Policy<Overflow*>(int32_t)    what to return when the reversal doesn't fit int32_t
+*	reverseDigits_Checked(span, span, bits)     batch that also returns a bitmask of the values that overflowed
+*	reverseDigits_Unrolled(int32_t / int64_t)   one jump on the digit count into a kernel unrolled for it
+*	reverseDigits_BatchDouble*                  experimental: digits extracted in double precision SIMD lanes
+*	reverseDigits_Reference / Reference64       obvious oracles for the verifiers, 32 and 64 bit
+*
+* Self-contained with regular includes rather than `import std;`
+*	so it can also be used from TUs built without std module support.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#define INTDIGITREVERSER_VERSION_MAJOR 1
+#define INTDIGITREVERSER_VERSION_MINOR 0
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define REVERSEDIGITS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define REVERSEDIGITS_X86 0
+#endif
+
+#if REVERSEDIGITS_X86 && (defined(__GNUC__) || defined(__clang__))
+// GCC and Clang only allow intrinsics in functions compiled for that instruction set; MSVC allows them anywhere
+#define REVERSEDIGITS_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define REVERSEDIGITS_TARGET_AVX2 __attribute__((target("avx2")))
+#define REVERSEDIGITS_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define REVERSEDIGITS_TARGET_SSE41
+#define REVERSEDIGITS_TARGET_AVX2
+#define REVERSEDIGITS_TARGET_AVX512
+#endif
+
+inline constexpr std::string_view longestPossibleIntString = "-2147483648";
+
+// Global buffer used for one of the string flip approaches
+//	Thread local so the parallel scaling benchmark doesn't race on it; each thread still re-uses its one allocation
+// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
+inline thread_local auto sharedCharArrayBuffer = std::make_unique<char[]>(longestPossibleIntString.size());
+
+
+/// <summary>
+/// Use (value / tens_place % 10) to extract the digits from the integer.
+///		This version uses an array to look up the possible 10s places instead of using multiplication or division.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int32_t reverseDigits_ModuloLookup(int32_t value) noexcept
+{
+	constexpr uint64_t tensLookupTable[] = {
+		1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000
+	};
+	constexpr size_t tensLookupCount = std::size(tensLookupTable);
+
+	if (value < 10 && value > -10)
+	{
+		return value;
+	}
+
+	const bool negate = value < 0;
+	// Store the value in uint64 to handle overflow without branching in the main loop
+	const uint64_t sourceValue = static_cast<uint64_t>(negate ? -static_cast<int64_t>(value) : static_cast<int64_t>(value));
+
+	// Should never be less than 10 given the above early return
+	size_t largestIndex = 1;
+	while (largestIndex < tensLookupCount && sourceValue >= tensLookupTable[largestIndex])
+	{
+		++largestIndex;
+	}
+	// Will always overshoot by 1
+	--largestIndex;
+
+	// If a power of 10, will always result in 1
+	if (sourceValue == tensLookupTable[largestIndex])
+	{
+		return negate ? -1 : 1;
+	}
+
+	uint64_t result = 0;
+
+	const size_t halfIndex = (largestIndex + 1) / 2;
+	for (size_t index = 0; index < halfIndex; ++index)
+	{
+		const size_t upperIndex = largestIndex - index;
+
+		const uint64_t lowerTens = tensLookupTable[index];
+		const uint64_t upperTens = tensLookupTable[upperIndex];
+
+		const uint64_t lower = (sourceValue / lowerTens) % 10;
+		const uint64_t upper = (sourceValue / upperTens) % 10;
+
+		result += (lower * upperTens) + (upper * lowerTens);
+	}
+
+	// For an odd number of digits (even index due to 0-based indexing), copy the middle digit over
+	if ((largestIndex & 1) == 0)
+	{
+		const uint64_t tens = tensLookupTable[halfIndex];
+		result += ((sourceValue / tens) % 10) * tens;
+	}
+
+	if (result > std::numeric_limits<int32_t>::max())
+	{
+		return 0;
+	}
+
+	return negate ? -static_cast<int32_t>(result) : static_cast<int32_t>(result);
+}
+
+
+/// <summary>
+/// Use (value / tens_place % 10) to extract the digits from the integer.
+///		This version uses multiplication / division to find the highest 10s place.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int32_t reverseDigits_ModuloMultiply(int32_t value) noexcept
+{
+	if (value < 10 && value > -10)
+	{
+		return value;
+	}
+
+	const bool negate = value < 0;
+	const uint64_t sourceValue = static_cast<uint64_t>(negate ? -static_cast<int64_t>(value) : static_cast<int64_t>(value));
+
+	// Should never drop below 10 given the early return at the top
+	uint64_t upperTens = 10;
+	while (sourceValue >= upperTens)
+	{
+		upperTens *= 10;
+	}
+	// Will overshoot by one
+	upperTens /= 10;
+
+	// If a power of 10, will always result in 1
+	if (sourceValue == upperTens)
+	{
+		return negate ? -1 : 1;
+	}
+
+	uint64_t result = 0;
+
+	uint64_t lowerTens = 1;
+	for (; lowerTens < upperTens; lowerTens *= 10, upperTens /= 10)
+	{
+		const uint64_t lower = (sourceValue / lowerTens) % 10;
+		const uint64_t upper = (sourceValue / upperTens) % 10;
+
+		result += (lower * upperTens) + (upper * lowerTens);
+	}
+
+	// The above loop will end if lowerTens == upperTens; we don't want to treat that the same as swapping the digits
+	if (lowerTens == upperTens)
+	{
+		result += ((sourceValue / lowerTens) % 10) * lowerTens;
+	}
+
+	if (result > std::numeric_limits<int32_t>::max())
+	{
+		return 0;
+	}
+
+	return negate ? -static_cast<int32_t>(result) : static_cast<int32_t>(result);
+}
+
+
+// reverseDigits_ModuloLookup's tensLookupTable, extended to every power of ten in uint64_t
+inline constexpr uint64_t wideTensLookupTable[] = {
+	1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000,
+	10'000'000'000, 100'000'000'000, 1'000'000'000'000, 10'000'000'000'000, 100'000'000'000'000,
+	1'000'000'000'000'000, 10'000'000'000'000'000, 100'000'000'000'000'000, 1'000'000'000'000'000'000,
+	10'000'000'000'000'000'000u
+};
+
+/// <summary>
+/// Number of decimal digits in value, 1 for 0.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr size_t decimalDigitCount(uint64_t value) noexcept
+{
+	// bit_width * log10(2), as 1233 / 4096, is the digit count or one short of it; one compare against the table settles which
+	const size_t estimate = (static_cast<size_t>(std::bit_width(value)) * 1233) >> 12;
+	return std::max<size_t>(estimate + (value >= wideTensLookupTable[estimate] ? 1 : 0), 1);
+}
+
+namespace UnrolledDetail
+{
+	template<size_t DigitCount, size_t... Index>
+	constexpr uint64_t reverseExactDigits(uint64_t magnitude, std::index_sequence<Index...>) noexcept
+	{
+		// Digit Index moves to position DigitCount - 1 - Index; every divisor and multiplier is a constant, and no digit waits on another
+		return (uint64_t(0) + ... + (magnitude / wideTensLookupTable[Index] % 10 * wideTensLookupTable[DigitCount - 1 - Index]));
+	}
+
+	/// <summary>
+	/// The DigitCount digits of magnitude reversed, as straight line code with no loop.
+	/// </summary>
+	template<size_t DigitCount>
+	constexpr uint64_t reverseExactDigits(uint64_t magnitude) noexcept
+	{
+		return reverseExactDigits<DigitCount>(magnitude, std::make_index_sequence<DigitCount>());
+	}
+
+	using ExactDigitsKernel = uint64_t(*)(uint64_t) noexcept;
+
+	template<size_t... Index>
+	constexpr std::array<ExactDigitsKernel, sizeof...(Index)> makeKernelTable(std::index_sequence<Index...>) noexcept
+	{
+		return { &reverseExactDigits<Index + 1>... };
+	}
+
+	// kernels[n - 1] reverses exactly n digits; up to 10 for int32_t, 19 for int64_t
+	inline constexpr auto kernels = makeKernelTable(std::make_index_sequence<19>());
+}
+
+/// <summary>
+/// Dispatches once on the digit count, through a jump table, into a kernel fully unrolled for that many digits;
+///		the modulo kernels instead run a loop whose trip count depends on the digit count.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int32_t reverseDigits_Unrolled(int32_t value) noexcept
+{
+	// All ones for negative values; (x ^ -1) - -1 == -x
+	const int64_t signMask = static_cast<int64_t>(value) >> 63;
+	const uint64_t magnitude = static_cast<uint64_t>((static_cast<int64_t>(value) ^ signMask) - signMask);
+
+	const uint64_t reversed = UnrolledDetail::kernels[decimalDigitCount(magnitude) - 1](magnitude);
+	const int64_t result = reversed > static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) ? 0 : static_cast<int64_t>(reversed);
+	return static_cast<int32_t>((result ^ signMask) - signMask);
+}
+
+/// <summary>
+/// reverseDigits_Unrolled at 64 bits: 19 generated kernels, sign kept, 0 once the reversed magnitude passes INT64_MAX.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int64_t reverseDigits_Unrolled(int64_t value) noexcept
+{
+	// Unsigned, so INT64_MIN's magnitude doesn't overflow
+	const uint64_t signMask = static_cast<uint64_t>(value >> 63);
+	const uint64_t magnitude = (static_cast<uint64_t>(value) ^ signMask) - signMask;
+
+	const uint64_t reversed = UnrolledDetail::kernels[decimalDigitCount(magnitude) - 1](magnitude);
+	const uint64_t result = reversed > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ? 0 : reversed;
+	return static_cast<int64_t>((result ^ signMask) - signMask);
+}
+
+/// <summary>
+/// Make a character buffer on the stack and reverse the character there.
+///		Using a manual swap loop instead of a standard algorithm
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+inline int32_t reverseDigits_CharArrayStack(int32_t value) noexcept
+{
+	if (value < 10 && value > -10)
+	{
+		return value;
+	}
+
+	// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
+	char buffer[longestPossibleIntString.size()];
+
+	const char* const endPtr = std::format_to(buffer, "{}", value);
+
+	const ptrdiff_t count = std::distance((const char*)buffer, endPtr);
+
+	const size_t offsetEnd = value < 0 ? 0 : 1;
+	const size_t skip = 1 - offsetEnd;
+
+	const size_t halfCount = (count + skip) / 2;
+
+	for (size_t index = skip; index < halfCount; ++index)
+	{
+		std::swap(buffer[index], buffer[count - index - offsetEnd]);
+	}
+
+	int32_t result = 0;
+	std::from_chars(buffer, endPtr, result);
+
+	return result;
+}
+
+/// <summary>
+/// Make a character buffer on the stack and reverse the character there.
+///		Using the std::ranges::reverse algorithm
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+inline int32_t reverseDigits_CharArrayStack_RangeAlgorithm(int32_t value) noexcept
+{
+	if (value < 10 && value > -10)
+	{
+		return value;
+	}
+
+	// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
+	char buffer[longestPossibleIntString.size()];
+
+	char* const endPtr = std::format_to(buffer, "{}", value);
+
+	const std::span<char> digitView = std::span<char>(value < 0 ? buffer+1 : buffer, endPtr);
+	std::ranges::reverse(digitView);
+
+	int32_t result = 0;
+	std::from_chars(buffer, endPtr, result);
+
+	return result;
+}
+
+
+/// <summary>
+/// Use a character buffer on the heap and reverse the character there.
+///		Uses a shared buffer that's re-used between runs.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+inline int32_t reverseDigits_CharArrayHeap_SharedAlloc(int32_t value) noexcept
+{
+	if (value < 10 && value > -10)
+	{
+		return value;
+	}
+
+	char* const buffer = sharedCharArrayBuffer.get();
+
+	char* const endPtr = std::format_to(buffer, "{}", value);
+
+	const std::span<char> digitView = std::span<char>(value < 0 ? buffer + 1 : buffer, endPtr);
+	std::ranges::reverse(digitView);
+
+	int32_t result = 0;
+	std::from_chars(buffer, endPtr, result);
+
+	return result;
+}
+
+
+/// <summary>
+/// Use a character buffer on the heap and reverse the character there.
+///		Uses a unique character buffere that is allocated every time this is called.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+inline int32_t reverseDigits_CharArrayHeap_AlwaysAlloc(int32_t value) noexcept
+{
+	if (value < 10 && value > -10)
+	{
+		return value;
+	}
+
+	// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
+	auto managedPtr = std::make_unique<char[]>(longestPossibleIntString.size());
+
+	char* const buffer = managedPtr.get();
+
+	char* const endPtr = std::format_to(buffer, "{}", value);
+
+	const std::span<char> digitView = std::span<char>(value < 0 ? buffer + 1 : buffer, endPtr);
+	std::ranges::reverse(digitView);
+
+	int32_t result = 0;
+	std::from_chars(buffer, endPtr, result);
+
+	return result;
+}
+
+
+/// <summary>
+/// The recommended scalar entry point; currently the lookup table modulo kernel.
+///		Still constexpr, so it can be used to build tables at compile time.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int32_t reverseDigits(int32_t value) noexcept
+{
+	return reverseDigits_ModuloLookup(value);
+}
+
+
+/*******************************************************************
+* Overflow policies
+*	The kernels above return 0 when the reversal doesn't fit, which
+*	can't be told apart from reversing 0. reverseDigits_Policy always
+*	computes the exact reversal in int64_t and lets the policy map it
+*	into its result type, with a select rather than a branch for all
+*	but OverflowExpected.
+*******************************************************************/
+
+enum class ReversalError : uint8_t
+{
+	Overflow,
+};
+
+constexpr std::string_view toString(ReversalError error) noexcept
+{
+	switch (error)
+	{
+	case ReversalError::Overflow: return "Overflow";
+	}
+	return "Unknown";
+}
+
+/// <summary>
+/// The exact reversal with the sign kept, which always fits int64_t: at most 10 digits.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int64_t reverseDigits_Wide(int32_t value) noexcept
+{
+	// All ones for negative values; (x ^ -1) - -1 == -x, so the sign is stripped and restored without a branch
+	const int64_t signMask = static_cast<int64_t>(value) >> 63;
+	const uint64_t magnitude = static_cast<uint64_t>((static_cast<int64_t>(value) ^ signMask) - signMask);
+
+	uint64_t reversed = 0;
+	for (uint64_t remaining = magnitude; remaining != 0; remaining /= 10)
+	{
+		reversed = reversed * 10 + remaining % 10;
+	}
+
+	return (static_cast<int64_t>(reversed) ^ signMask) - signMask;
+}
+
+constexpr bool fitsInt32(int64_t value) noexcept
+{
+	return value == static_cast<int32_t>(value);
+}
+
+// 0 on overflow, exactly like the kernels above
+struct OverflowToZero
+{
+	using Result = int32_t;
+
+	static constexpr Result apply(int64_t reversed) noexcept
+	{
+		return fitsInt32(reversed) ? static_cast<int32_t>(reversed) : 0;
+	}
+};
+
+// Clamped to INT32_MIN / INT32_MAX
+struct OverflowSaturate
+{
+	using Result = int32_t;
+
+	static constexpr Result apply(int64_t reversed) noexcept
+	{
+		return static_cast<int32_t>(std::clamp<int64_t>(reversed, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+	}
+};
+
+// The low 32 bits, as two's complement arithmetic would leave them
+struct OverflowWrap
+{
+	using Result = int32_t;
+
+	static constexpr Result apply(int64_t reversed) noexcept
+	{
+		return static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(reversed)));
+	}
+};
+
+// The exact reversal as int64_t; nothing overflows
+struct OverflowWiden
+{
+	using Result = int64_t;
+
+	static constexpr Result apply(int64_t reversed) noexcept
+	{
+		return reversed;
+	}
+};
+
+// ReversalError::Overflow instead of a value
+struct OverflowExpected
+{
+	using Result = std::expected<int32_t, ReversalError>;
+
+	static constexpr Result apply(int64_t reversed) noexcept
+	{
+		// The only policy that isn't a pure select: building the discriminant costs a branch, taken only on overflow
+		return fitsInt32(reversed) ? Result(static_cast<int32_t>(reversed)) : Result(std::unexpect, ReversalError::Overflow);
+	}
+};
+
+template<typename Policy>
+concept ReversalOverflowPolicy = requires(int64_t reversed)
+{
+	{ Policy::apply(reversed) } noexcept -> std::same_as<typename Policy::Result>;
+};
+
+/// <summary>
+/// reverse(value), with what happens when it doesn't fit int32_t picked at compile time:
+///		OverflowToZero, OverflowSaturate, OverflowWrap, OverflowWiden or OverflowExpected.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+template<ReversalOverflowPolicy Policy>
+constexpr typename Policy::Result reverseDigits_Policy(int32_t value) noexcept
+{
+	return Policy::apply(reverseDigits_Wide(value));
+}
+
+
+/*******************************************************************
+* Batch kernels
+*	All of them reverse min(input.size(), output.size()) values,
+*	and input and output may be the exact same span (in place).
+*******************************************************************/
+
+/// <summary>
+/// Batch reversal with the scalar kernel; the baseline for, and tail handler of, the SIMD versions.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+inline void reverseDigits_BatchScalar(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+	for (size_t index = 0; index < count; ++index)
+	{
+		output[index] = reverseDigits(input[index]);
+	}
+}
+
+#if REVERSEDIGITS_X86
+
+/// <summary>
+/// Reverses the digits of four int32 lanes at once.
+///		There's no vector integer division, so each digit is peeled off with the usual
+///		x / 10 == (x * 0xCCCCCCCD) >> 35 reciprocal multiply, which is exact for every uint32.
+///		Nine digits always fit the 32-bit accumulator; the tenth is only added if the result stays within int32.
+/// </summary>
+/// <param name="values"></param>
+/// <param name="overflows">All ones in the lanes whose reversal didn't fit int32_t and came back as 0</param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_SSE41 inline __m128i reverseDigitsLanesChecked_SSE41(__m128i values, __m128i& overflows) noexcept
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i divideByTenMagic = _mm_set1_epi32(static_cast<int32_t>(0xCCCCCCCD));
+
+	const __m128i negative = _mm_cmpgt_epi32(zero, values);
+	// abs(INT32_MIN) stays 0x80000000, which is the correct magnitude when treated as unsigned
+	__m128i remaining = _mm_abs_epi32(values);
+	__m128i result = zero;
+
+	for (int digit = 0; digit < 9; ++digit)
+	{
+		const __m128i evenQuotients = _mm_srli_epi64(_mm_mul_epu32(remaining, divideByTenMagic), 35);
+		// The odd lane quotients end up in the high half of each 64-bit product after the shift by 3 (35 - 32)
+		const __m128i oddQuotients = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(remaining, 32), divideByTenMagic), 3);
+		const __m128i quotients = _mm_blend_epi16(evenQuotients, oddQuotients, 0b1100'1100);
+
+		const __m128i tenQuotients = _mm_add_epi32(_mm_slli_epi32(quotients, 3), _mm_slli_epi32(quotients, 1));
+		const __m128i lowDigits = _mm_sub_epi32(remaining, tenQuotients);
+
+		// Lanes that already ran out of digits must not keep multiplying their result by 10
+		const __m128i hasDigits = _mm_cmpeq_epi32(_mm_cmpeq_epi32(remaining, zero), zero);
+		const __m128i shifted = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(result, 3), _mm_slli_epi32(result, 1)), lowDigits);
+		result = _mm_blendv_epi8(result, shifted, hasDigits);
+
+		remaining = quotients;
+	}
+
+	// Only 10 digit inputs have anything left, and their leading digit is at most 2, so only the 9 digit prefix decides overflow
+	const __m128i hasTenthDigit = _mm_cmpeq_epi32(_mm_cmpeq_epi32(remaining, zero), zero);
+	overflows = _mm_and_si128(hasTenthDigit, _mm_cmpgt_epi32(result, _mm_set1_epi32(214'748'364)));
+	const __m128i withTenth = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(result, 3), _mm_slli_epi32(result, 1)), remaining);
+	result = _mm_blendv_epi8(result, withTenth, hasTenthDigit);
+	result = _mm_andnot_si128(overflows, result);
+
+	// Conditional negate: (x ^ -1) - -1 == -x
+	return _mm_sub_epi32(_mm_xor_si128(result, negative), negative);
+}
+
+/// <summary>
+/// reverseDigitsLanesChecked_SSE41 without the overflow lanes; the compiler drops the unused output.
+/// </summary>
+/// <param name="values"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_SSE41 inline __m128i reverseDigitsLanes_SSE41(__m128i values) noexcept
+{
+	__m128i overflows;
+	return reverseDigitsLanesChecked_SSE41(values, overflows);
+}
+
+/// <summary>
+/// Eight lane AVX2 version of reverseDigitsLanesChecked_SSE41.
+/// </summary>
+/// <param name="values"></param>
+/// <param name="overflows">All ones in the lanes whose reversal didn't fit int32_t and came back as 0</param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m256i reverseDigitsLanesChecked_AVX2(__m256i values, __m256i& overflows) noexcept
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i divideByTenMagic = _mm256_set1_epi32(static_cast<int32_t>(0xCCCCCCCD));
+
+	const __m256i negative = _mm256_cmpgt_epi32(zero, values);
+	__m256i remaining = _mm256_abs_epi32(values);
+	__m256i result = zero;
+
+	for (int digit = 0; digit < 9; ++digit)
+	{
+		const __m256i evenQuotients = _mm256_srli_epi64(_mm256_mul_epu32(remaining, divideByTenMagic), 35);
+		const __m256i oddQuotients = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(remaining, 32), divideByTenMagic), 3);
+		const __m256i quotients = _mm256_blend_epi32(evenQuotients, oddQuotients, 0b1010'1010);
+
+		const __m256i tenQuotients = _mm256_add_epi32(_mm256_slli_epi32(quotients, 3), _mm256_slli_epi32(quotients, 1));
+		const __m256i lowDigits = _mm256_sub_epi32(remaining, tenQuotients);
+
+		const __m256i hasDigits = _mm256_xor_si256(_mm256_cmpeq_epi32(remaining, zero), _mm256_set1_epi32(-1));
+		const __m256i shifted = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(result, 3), _mm256_slli_epi32(result, 1)), lowDigits);
+		result = _mm256_blendv_epi8(result, shifted, hasDigits);
+
+		remaining = quotients;
+	}
+
+	const __m256i hasTenthDigit = _mm256_xor_si256(_mm256_cmpeq_epi32(remaining, zero), _mm256_set1_epi32(-1));
+	overflows = _mm256_and_si256(hasTenthDigit, _mm256_cmpgt_epi32(result, _mm256_set1_epi32(214'748'364)));
+	const __m256i withTenth = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(result, 3), _mm256_slli_epi32(result, 1)), remaining);
+	result = _mm256_blendv_epi8(result, withTenth, hasTenthDigit);
+	result = _mm256_andnot_si256(overflows, result);
+
+	return _mm256_sub_epi32(_mm256_xor_si256(result, negative), negative);
+}
+
+/// <summary>
+/// Eight lane AVX2 version of reverseDigitsLanes_SSE41.
+/// </summary>
+/// <param name="values"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m256i reverseDigitsLanes_AVX2(__m256i values) noexcept
+{
+	__m256i overflows;
+	return reverseDigitsLanesChecked_AVX2(values, overflows);
+}
+
+/// <summary>
+/// Batch reversal four values at a time with SSE4.1. Only call this if the CPU supports SSE4.1.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+REVERSEDIGITS_TARGET_SSE41 inline void reverseDigits_BatchSSE41(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+
+	size_t index = 0;
+	for (; index + 4 <= count; index += 4)
+	{
+		const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + index));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + index), reverseDigitsLanes_SSE41(values));
+	}
+
+	reverseDigits_BatchScalar(input.subspan(index, count - index), output.subspan(index));
+}
+
+/// <summary>
+/// Batch reversal eight values at a time with AVX2. Only call this if the CPU supports AVX2.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+REVERSEDIGITS_TARGET_AVX2 inline void reverseDigits_BatchAVX2(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+
+	size_t index = 0;
+	for (; index + 8 <= count; index += 8)
+	{
+		const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + index));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output.data() + index), reverseDigitsLanes_AVX2(values));
+	}
+
+	reverseDigits_BatchScalar(input.subspan(index, count - index), output.subspan(index));
+}
+
+#endif // REVERSEDIGITS_X86
+
+
+/*******************************************************************
+* Double precision kernels (experimental)
+*	Digits are peeled off with floating point instead of integer
+*	reciprocal multiplies, so AVX2 and AVX-512 can work on 4 and 8
+*	lanes with their double precision units:
+*		q = floor(m * 0.1), digit = m - 10 * q
+*	Every intermediate is an integer below 2^53, so the only rounding
+*	is in m * 0.1. The double 0.1 is slightly above a tenth, so the
+*	product never rounds below m / 10, and for m < 2^32 its error is
+*	far below the 0.1 gap to the next integer, so floor gives the
+*	exact quotient. The remainder and the result accumulation are
+*	then exact; the verifier confirms it over every int32_t.
+*******************************************************************/
+
+/// <summary>
+/// The double precision digit extraction one value at a time; states the method the SIMD versions vectorize.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+inline int32_t reverseDigits_DoubleReciprocal(int32_t value) noexcept
+{
+	// abs in double, where INT32_MIN's magnitude is representable
+	double remaining = std::abs(static_cast<double>(value));
+	double result = 0.0;
+	while (remaining != 0.0)
+	{
+		const double quotient = std::floor(remaining * 0.1);
+		// An FMA isn't needed for exactness: 10 * quotient is an integer below 2^36, so the product is exact too
+		result = result * 10.0 + (remaining - quotient * 10.0);
+		remaining = quotient;
+	}
+
+	if (result > std::numeric_limits<int32_t>::max())
+	{
+		return 0;
+	}
+	return static_cast<int32_t>(value < 0 ? -result : result);
+}
+
+#if REVERSEDIGITS_X86
+
+/// <summary>
+/// reverseDigits_DoubleReciprocal on four int32 lanes in four double lanes. Only call this if the CPU supports AVX2.
+/// </summary>
+/// <param name="values"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX2 inline __m128i reverseDigitsLanesDouble_AVX2(__m128i values) noexcept
+{
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d ten = _mm256_set1_pd(10.0);
+	const __m256d tenth = _mm256_set1_pd(0.1);
+	const __m256d signBit = _mm256_set1_pd(-0.0);
+
+	const __m256d signedValues = _mm256_cvtepi32_pd(values);
+	__m256d remaining = _mm256_andnot_pd(signBit, signedValues);
+	__m256d result = zero;
+
+	// 10 rounds covers every int32; a round on a lane that ran out of digits leaves it as it was
+	for (int digit = 0; digit < 10; ++digit)
+	{
+		const __m256d quotients = _mm256_floor_pd(_mm256_mul_pd(remaining, tenth));
+		const __m256d digits = _mm256_sub_pd(remaining, _mm256_mul_pd(quotients, ten));
+
+		const __m256d hasDigits = _mm256_cmp_pd(remaining, zero, _CMP_NEQ_OQ);
+		result = _mm256_blendv_pd(result, _mm256_add_pd(_mm256_mul_pd(result, ten), digits), hasDigits);
+
+		remaining = quotients;
+	}
+
+	const __m256d fits = _mm256_cmp_pd(result, _mm256_set1_pd(std::numeric_limits<int32_t>::max()), _CMP_LE_OQ);
+	result = _mm256_and_pd(result, fits);
+	// The input's sign bit; a 0 result becomes -0.0, which still converts to 0
+	result = _mm256_or_pd(result, _mm256_and_pd(signedValues, signBit));
+
+	return _mm256_cvttpd_epi32(result);
+}
+
+/// <summary>
+/// Batch reversal eight values at a time in double precision with AVX2. Only call this if the CPU supports AVX2.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+REVERSEDIGITS_TARGET_AVX2 inline void reverseDigits_BatchDoubleAVX2(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+
+	size_t index = 0;
+	for (; index + 8 <= count; index += 8)
+	{
+		// Two independent halves, so their dependency chains overlap
+		const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + index));
+		const __m128i low = reverseDigitsLanesDouble_AVX2(_mm256_castsi256_si128(values));
+		const __m128i high = reverseDigitsLanesDouble_AVX2(_mm256_extracti128_si256(values, 1));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output.data() + index), _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1));
+	}
+
+	reverseDigits_BatchScalar(input.subspan(index, count - index), output.subspan(index));
+}
+
+/// <summary>
+/// reverseDigits_DoubleReciprocal on eight int32 lanes in eight double lanes, with floor as a rounding mode of
+///		roundscale, the remainder and accumulation as FMAs and the lanes that ran out of digits masked off.
+///		Only call this if the CPU supports AVX-512F.
+/// </summary>
+/// <param name="values"></param>
+/// <returns></returns>
+REVERSEDIGITS_TARGET_AVX512 inline __m256i reverseDigitsLanesDouble_AVX512(__m256i values) noexcept
+{
+	const __m512d zero = _mm512_setzero_pd();
+	const __m512d ten = _mm512_set1_pd(10.0);
+	const __m512d tenth = _mm512_set1_pd(0.1);
+
+	const __m512d signedValues = _mm512_cvtepi32_pd(values);
+	const __mmask8 negative = _mm512_cmp_pd_mask(signedValues, zero, _CMP_LT_OQ);
+	__m512d remaining = _mm512_abs_pd(signedValues);
+	__m512d result = zero;
+
+	for (int digit = 0; digit < 10; ++digit)
+	{
+		const __m512d quotients = _mm512_roundscale_pd(_mm512_mul_pd(remaining, tenth), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+		// remaining - 10 * quotients
+		const __m512d digits = _mm512_fnmadd_pd(quotients, ten, remaining);
+
+		// result * 10 + digits, only in the lanes that still have digits
+		const __mmask8 hasDigits = _mm512_cmp_pd_mask(remaining, zero, _CMP_NEQ_OQ);
+		result = _mm512_mask_fmadd_pd(result, hasDigits, ten, digits);
+
+		remaining = quotients;
+	}
+
+	const __mmask8 overflows = _mm512_cmp_pd_mask(result, _mm512_set1_pd(std::numeric_limits<int32_t>::max()), _CMP_GT_OQ);
+	result = _mm512_mask_mov_pd(result, overflows, zero);
+	// Without AVX-512DQ there's no vector and_pd for the sign bit, so negate by subtracting under the mask
+	result = _mm512_mask_sub_pd(result, negative, zero, result);
+
+	return _mm512_cvttpd_epi32(result);
+}
+
+/// <summary>
+/// Batch reversal sixteen values at a time in double precision with AVX-512F. Only call this if the CPU supports AVX-512F.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+REVERSEDIGITS_TARGET_AVX512 inline void reverseDigits_BatchDoubleAVX512(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+	const size_t count = std::min(input.size(), output.size());
+
+	size_t index = 0;
+	for (; index + 16 <= count; index += 16)
+	{
+		const __m512i values = _mm512_loadu_si512(input.data() + index);
+		const __m256i low = reverseDigitsLanesDouble_AVX512(_mm512_castsi512_si256(values));
+		const __m256i high = reverseDigitsLanesDouble_AVX512(_mm512_extracti64x4_epi64(values, 1));
+		_mm512_storeu_si512(output.data() + index, _mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1));
+	}
+
+	reverseDigits_BatchScalar(input.subspan(index, count - index), output.subspan(index));
+}
+
+#endif // REVERSEDIGITS_X86
+
+enum class SimdLevel
+{
+	Scalar,
+	SSE41,
+	AVX2,
+	// AVX-512F; only the double precision kernel uses it, the integer dispatch stays on AVX2
+	AVX512,
+};
+
+constexpr std::string_view toString(SimdLevel level) noexcept
+{
+	switch (level)
+	{
+	case SimdLevel::Scalar: return "Scalar";
+	case SimdLevel::SSE41: return "SSE4.1";
+	case SimdLevel::AVX2: return "AVX2";
+	case SimdLevel::AVX512: return "AVX-512";
+	}
+	return "Unknown";
+}
+
+/// <summary>
+/// Asks the CPU (and on MSVC, the OS for AVX state) which batch kernels can run.
+/// </summary>
+/// <returns></returns>
+inline SimdLevel detectSimdLevel() noexcept
+{
+#if REVERSEDIGITS_X86 && defined(_MSC_VER) && !defined(__clang__)
+	int cpuInfo[4] = {};
+	__cpuid(cpuInfo, 0);
+	const int maxLeaf = cpuInfo[0];
+
+	__cpuid(cpuInfo, 1);
+	const bool hasSSE41 = (cpuInfo[2] & (1 << 19)) != 0;
+	const bool hasOSXSave = (cpuInfo[2] & (1 << 27)) != 0;
+	const bool hasAVX = (cpuInfo[2] & (1 << 28)) != 0;
+	// The OS has to save the YMM registers on context switches too
+	const bool osSavesYmm = hasOSXSave && (_xgetbv(0) & 0b110) == 0b110;
+
+	// And the opmask and ZMM registers for AVX-512
+	const bool osSavesZmm = osSavesYmm && (_xgetbv(0) & 0b1110'0000) == 0b1110'0000;
+
+	bool hasAVX2 = false;
+	bool hasAVX512F = false;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(cpuInfo, 7, 0);
+		hasAVX2 = (cpuInfo[1] & (1 << 5)) != 0;
+		hasAVX512F = (cpuInfo[1] & (1 << 16)) != 0;
+	}
+
+	if (hasAVX && hasAVX2 && hasAVX512F && osSavesZmm)
+	{
+		return SimdLevel::AVX512;
+	}
+	if (hasAVX && hasAVX2 && osSavesYmm)
+	{
+		return SimdLevel::AVX2;
+	}
+	return hasSSE41 ? SimdLevel::SSE41 : SimdLevel::Scalar;
+#elif REVERSEDIGITS_X86
+	// Also checks that the OS saves the YMM and ZMM state
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2"))
+	{
+		return SimdLevel::AVX512;
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return SimdLevel::AVX2;
+	}
+	return __builtin_cpu_supports("sse4.1") ? SimdLevel::SSE41 : SimdLevel::Scalar;
+#else
+	return SimdLevel::Scalar;
+#endif
+}
+
+/// <summary>
+/// The widest SIMD level the CPU supports; detected once per process.
+/// </summary>
+/// <returns></returns>
+inline SimdLevel activeSimdLevel() noexcept
+{
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+}
+
+/// <summary>
+/// The SIMD level the dispatching integer kernels actually run at: activeSimdLevel, except that AVX-512 runs the AVX2 kernels.
+/// </summary>
+/// <returns></returns>
+inline SimdLevel batchSimdLevel() noexcept
+{
+	return std::min(activeSimdLevel(), SimdLevel::AVX2);
+}
+
+/// <summary>
+/// The recommended batch entry point: reverses every value of input into output with the widest kernel the CPU supports.
+///		Reverses min(input.size(), output.size()) values; input and output may be the same span.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+inline void reverseDigits(std::span<const int32_t> input, std::span<int32_t> output) noexcept
+{
+#if REVERSEDIGITS_X86
+	switch (activeSimdLevel())
+	{
+	case SimdLevel::AVX512:
+	case SimdLevel::AVX2:
+		reverseDigits_BatchAVX2(input, output);
+		return;
+	case SimdLevel::SSE41:
+		reverseDigits_BatchSSE41(input, output);
+		return;
+	case SimdLevel::Scalar:
+		break;
+	}
+#endif
+	reverseDigits_BatchScalar(input, output);
+}
+
+
+
+/*******************************************************************
+* Checked batch kernels
+*	Batch reversal that also reports which values overflowed: bit
+*	(n % 64) of overflowBits[n / 64] is set when reverse(input[n])
+*	doesn't fit int32_t and output[n] came back as 0. That tells an
+*	overflow apart from a real 0 without a scalar pass over the
+*	output. They reverse min(input.size(), output.size(),
+*	overflowBits.size() * 64) values, write every mask word that
+*	covers them (the unused high bits of the last one cleared), and
+*	return how many overflowed.
+*******************************************************************/
+
+/// <summary>
+/// Number of overflowBits words needed for count values.
+/// </summary>
+/// <param name="count"></param>
+/// <returns></returns>
+constexpr size_t overflowMaskWords(size_t count) noexcept
+{
+	return (count + 63) / 64;
+}
+
+namespace CheckedBatchDetail
+{
+	inline size_t checkedCount(std::span<const int32_t> input, std::span<int32_t> output, std::span<uint64_t> overflowBits) noexcept
+	{
+		return std::min({ input.size(), output.size(), overflowBits.size() * 64 });
+	}
+
+	/// <summary>
+	/// Scalar remainder of a checked batch: reverses [index, count), continuing the partly filled mask word,
+	///		then stores the last word and counts the set bits.
+	/// </summary>
+	inline size_t finish(std::span<const int32_t> input, std::span<int32_t> output, std::span<uint64_t> overflowBits, size_t index, size_t count, uint64_t word) noexcept
+	{
+		for (; index < count; ++index)
+		{
+			const int64_t reversed = reverseDigits_Wide(input[index]);
+			const bool overflowed = !fitsInt32(reversed);
+			output[index] = overflowed ? 0 : static_cast<int32_t>(reversed);
+			word |= static_cast<uint64_t>(overflowed) << (index % 64);
+			if (index % 64 == 63)
+			{
+				overflowBits[index / 64] = word;
+				word = 0;
+			}
+		}
+		if (count % 64 != 0)
+		{
+			overflowBits[count / 64] = word;
+		}
+
+		size_t overflowCount = 0;
+		for (const uint64_t bits : overflowBits.first(overflowMaskWords(count)))
+		{
+			overflowCount += static_cast<size_t>(std::popcount(bits));
+		}
+		return overflowCount;
+	}
+}
+
+/// <summary>
+/// Checked batch reversal one value at a time; the baseline for the SIMD versions.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output">Same values as reverseDigits_BatchScalar writes</param>
+/// <param name="overflowBits">One bit per value, set where the reversal overflowed; see overflowMaskWords</param>
+/// <returns>The number of values that overflowed</returns>
+inline size_t reverseDigits_CheckedBatchScalar(std::span<const int32_t> input, std::span<int32_t> output, std::span<uint64_t> overflowBits) noexcept
+{
+	return CheckedBatchDetail::finish(input, output, overflowBits, 0, CheckedBatchDetail::checkedCount(input, output, overflowBits), 0);
+}
+
+#if REVERSEDIGITS_X86
+
+/// <summary>
+/// Checked batch reversal four values at a time with SSE4.1; the lane compare that zeroes overflowed lanes is also
+///		movemasked straight into the bitmask. Only call this if the CPU supports SSE4.1.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+/// <param name="overflowBits"></param>
+/// <returns>The number of values that overflowed</returns>
+REVERSEDIGITS_TARGET_SSE41 inline size_t reverseDigits_CheckedBatchSSE41(std::span<const int32_t> input, std::span<int32_t> output, std::span<uint64_t> overflowBits) noexcept
+{
+	const size_t count = CheckedBatchDetail::checkedCount(input, output, overflowBits);
+
+	uint64_t word = 0;
+	size_t index = 0;
+	for (; index + 4 <= count; index += 4)
+	{
+		__m128i overflows;
+		const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + index));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output.data() + index), reverseDigitsLanesChecked_SSE41(values, overflows));
+
+		// 64 is a multiple of the lane count, so a vector's bits never straddle two words
+		word |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(overflows))) << (index % 64);
+		if ((index + 4) % 64 == 0)
+		{
+			overflowBits[index / 64] = word;
+			word = 0;
+		}
+	}
+
+	return CheckedBatchDetail::finish(input, output, overflowBits, index, count, word);
+}
+
+/// <summary>
+/// Eight lane AVX2 version of reverseDigits_CheckedBatchSSE41. Only call this if the CPU supports AVX2.
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+/// <param name="overflowBits"></param>
+/// <returns>The number of values that overflowed</returns>
+REVERSEDIGITS_TARGET_AVX2 inline size_t reverseDigits_CheckedBatchAVX2(std::span<const int32_t> input, std::span<int32_t> output, std::span<uint64_t> overflowBits) noexcept
+{
+	const size_t count = CheckedBatchDetail::checkedCount(input, output, overflowBits);
+
+	uint64_t word = 0;
+	size_t index = 0;
+	for (; index + 8 <= count; index += 8)
+	{
+		__m256i overflows;
+		const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input.data() + index));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output.data() + index), reverseDigitsLanesChecked_AVX2(values, overflows));
+
+		word |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(overflows))) << (index % 64);
+		if ((index + 8) % 64 == 0)
+		{
+			overflowBits[index / 64] = word;
+			word = 0;
+		}
+	}
+
+	return CheckedBatchDetail::finish(input, output, overflowBits, index, count, word);
+}
+
+#endif // REVERSEDIGITS_X86
+
+/// <summary>
+/// The checked batch entry point: reverseDigits(input, output) plus one overflow bit per value, with the widest
+///		kernel the CPU supports. Size overflowBits with overflowMaskWords(input.size()).
+/// </summary>
+/// <param name="input"></param>
+/// <param name="output"></param>
+/// <param name="overflowBits">Bit (n % 64) of word n / 64 is set when value n overflowed</param>
+/// <returns>The number of values that overflowed</returns>
+inline size_t reverseDigits_Checked(std::span<const int32_t> input, std::span<int32_t> output, std::span<uint64_t> overflowBits) noexcept
+{
+#if REVERSEDIGITS_X86
+	switch (activeSimdLevel())
+	{
+	case SimdLevel::AVX512:
+	case SimdLevel::AVX2:
+		return reverseDigits_CheckedBatchAVX2(input, output, overflowBits);
+	case SimdLevel::SSE41:
+		return reverseDigits_CheckedBatchSSE41(input, output, overflowBits);
+	case SimdLevel::Scalar:
+		break;
+	}
+#endif
+	return reverseDigits_CheckedBatchScalar(input, output, overflowBits);
+}
+
+
+/// <summary>
+/// Reference oracle for the verifier. Deliberately the most obvious implementation (peel digits off the bottom, push onto the result)
+///		so it shares no logic with any of the variants under test.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int32_t reverseDigits_Reference(int32_t value) noexcept
+{
+	int64_t remaining = value < 0 ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+	int64_t result = 0;
+	while (remaining != 0)
+	{
+		result = result * 10 + remaining % 10;
+		remaining /= 10;
+	}
+
+	if (result > std::numeric_limits<int32_t>::max())
+	{
+		return 0;
+	}
+
+	return value < 0 ? -static_cast<int32_t>(result) : static_cast<int32_t>(result);
+}
+
+/// <summary>
+/// The digits of magnitude in the opposite order, dropping what were trailing zeros; the loop the 64 bit references share.
+///		Fits uint64_t for any magnitude up to 19 digits.
+/// </summary>
+/// <param name="magnitude"></param>
+/// <returns></returns>
+constexpr uint64_t reverseMagnitude(uint64_t magnitude) noexcept
+{
+	uint64_t result = 0;
+	for (; magnitude != 0; magnitude /= 10)
+	{
+		result = result * 10 + magnitude % 10;
+	}
+	return result;
+}
+
+/// <summary>
+/// Reverses a 64 bit value the way reverseDigits_Reference reverses a 32 bit one: sign kept, 0 on overflow.
+/// </summary>
+/// <param name="value"></param>
+/// <returns></returns>
+constexpr int64_t reverseDigits_Reference64(int64_t value) noexcept
+{
+	// |INT64_MIN| only fits unsigned, and no 19 digit magnitude reversed exceeds uint64_t
+	const uint64_t result = reverseMagnitude(value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value));
+	if (result > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+	{
+		return 0;
+	}
+
+	return value < 0 ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+}
+
+/// <summary>
+/// Every kernel under test, by display name. The exhaustive verifier and the fuzzers walk this list,
+///		so new kernels only need adding here to be covered.
+/// </summary>
+struct ReversalVariant
+{
+	std::string_view name;
+	int32_t(*func)(int32_t);
+};
+
+inline constexpr ReversalVariant reversalVariants[] = {
+	{ "Char Stack", &reverseDigits_CharArrayStack },
+	{ "Char Stack Algo", &reverseDigits_CharArrayStack_RangeAlgorithm },
+	{ "Char Shared", &reverseDigits_CharArrayHeap_SharedAlloc },
+	{ "Char Alloc", &reverseDigits_CharArrayHeap_AlwaysAlloc },
+	{ "Modulo Lookup", &reverseDigits_ModuloLookup },
+	{ "Modulo Multiply", &reverseDigits_ModuloMultiply },
+	{ "Policy Zero", &reverseDigits_Policy<OverflowToZero> },
+	{ "Unrolled", &reverseDigits_Unrolled },
+	{ "Double Reciprocal", &reverseDigits_DoubleReciprocal },
+};
+
+/// <summary>
+/// Every batch kernel under test; checked alongside reversalVariants by the verifier, the self test and the fuzzers.
+///		Skip entries whose isSupported() is false; their instructions may not exist on the running CPU.
+/// </summary>
+struct BatchReversalVariant
+{
+	std::string_view name;
+	void(*func)(std::span<const int32_t>, std::span<int32_t>);
+	SimdLevel requiredLevel = SimdLevel::Scalar;
+
+	bool isSupported() const noexcept
+	{
+		return requiredLevel <= activeSimdLevel();
+	}
+};
+
+inline constexpr BatchReversalVariant batchReversalVariants[] = {
+	{ "Batch Scalar", &reverseDigits_BatchScalar, SimdLevel::Scalar },
+#if REVERSEDIGITS_X86
+	{ "Batch SSE4.1", &reverseDigits_BatchSSE41, SimdLevel::SSE41 },
+	{ "Batch AVX2", &reverseDigits_BatchAVX2, SimdLevel::AVX2 },
+	{ "Batch AVX2 Double", &reverseDigits_BatchDoubleAVX2, SimdLevel::AVX2 },
+	{ "Batch AVX-512 Double", &reverseDigits_BatchDoubleAVX512, SimdLevel::AVX512 },
+#endif
+	{ "Batch Dispatch", static_cast<void(*)(std::span<const int32_t>, std::span<int32_t>)>(&reverseDigits), SimdLevel::Scalar },
+};
+
+/// <summary>
+/// Every checked batch kernel under test; the self test compares their output with the reference and their
+///		overflow bits with the exact reversal.
+/// </summary>
+struct CheckedBatchReversalVariant
+{
+	std::string_view name;
+	size_t(*func)(std::span<const int32_t>, std::span<int32_t>, std::span<uint64_t>);
+	SimdLevel requiredLevel = SimdLevel::Scalar;
+
+	bool isSupported() const noexcept
+	{
+		return requiredLevel <= activeSimdLevel();
+	}
+};
+
+inline constexpr CheckedBatchReversalVariant checkedBatchReversalVariants[] = {
+	{ "Checked Scalar", &reverseDigits_CheckedBatchScalar, SimdLevel::Scalar },
+#if REVERSEDIGITS_X86
+	{ "Checked SSE4.1", &reverseDigits_CheckedBatchSSE41, SimdLevel::SSE41 },
+	{ "Checked AVX2", &reverseDigits_CheckedBatchAVX2, SimdLevel::AVX2 },
+#endif
+	{ "Checked Dispatch", &reverseDigits_Checked, SimdLevel::Scalar },
+};
@@ -0,0 +1,442 @@
+/*******************************************************************
+* Aggregates of reverse(x) over a whole range [first, last] without
+*	enumerating it: the sum, min and max of the reversed values and
+*	how many reversed values have each digit count. Part of the
+*	header-only library, next to ReverseDigits.h.
+*
+* Public API:
+*	reversedRangeStats(int32_t, int32_t)             exact, O(digits^2), constexpr
+*	reversedRangeStats(int64_t, int64_t)             the same for 64 bit values
+*	reversedRangeStats_BruteForce(first, last)       enumerating oracle for the tests
+*
+* reverse(x) follows reverseDigits_ModuloLookup: the sign is kept,
+*	trailing zeros are dropped, and anything that overflows the type
+*	once reversed becomes 0.
+*
+* Each digit count L is handled separately: a digit DP walks the
+*	L digits of x from the least significant one, which is the most
+*	significant digit of reverse(x). That order decides the overflow
+*	comparison as soon as a digit differs from the limit's, while
+*	the comparisons of x against first and last are carried as
+*	"how does the suffix seen so far compare", since a more
+*	significant digit always overrides them.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "ReverseDigits.h"
+
+/// <summary>
+/// Just enough of a two's complement 128 bit integer to hold exact sums over 64 bit ranges.
+/// </summary>
+struct Int128
+{
+	uint64_t low = 0;
+	uint64_t high = 0;
+
+	static constexpr Int128 fromInt64(int64_t value) noexcept
+	{
+		return { static_cast<uint64_t>(value), value < 0 ? std::numeric_limits<uint64_t>::max() : 0 };
+	}
+
+	/// <summary>
+	/// Full 128 bit product of two unsigned 64 bit values, from 32 bit halves so it is portable and constexpr.
+	/// </summary>
+	/// <param name="left"></param>
+	/// <param name="right"></param>
+	/// <returns></returns>
+	static constexpr Int128 multiply(uint64_t left, uint64_t right) noexcept
+	{
+		const uint64_t lowLow = (left & 0xFFFFFFFF) * (right & 0xFFFFFFFF);
+		const uint64_t highLow = (left >> 32) * (right & 0xFFFFFFFF);
+		const uint64_t lowHigh = (left & 0xFFFFFFFF) * (right >> 32);
+		const uint64_t highHigh = (left >> 32) * (right >> 32);
+		const uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + (lowHigh & 0xFFFFFFFF);
+		return { (lowLow & 0xFFFFFFFF) | (middle << 32), highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32) };
+	}
+
+	constexpr Int128 operator+(const Int128& other) const noexcept
+	{
+		// Both halves are computed before the result is built, since it may be constructed straight into *this
+		const uint64_t sumLow = low + other.low;
+		const uint64_t sumHigh = high + other.high + (sumLow < low ? 1 : 0);
+		return { sumLow, sumHigh };
+	}
+
+	constexpr Int128 operator-() const noexcept
+	{
+		return Int128{ ~low, ~high } + Int128{ 1, 0 };
+	}
+
+	constexpr Int128 operator-(const Int128& other) const noexcept
+	{
+		return *this + -other;
+	}
+
+	constexpr bool operator==(const Int128&) const noexcept = default;
+
+	constexpr bool isNegative() const noexcept
+	{
+		return (high >> 63) != 0;
+	}
+
+	std::string toString() const
+	{
+		const Int128 magnitude = isNegative() ? -*this : *this;
+		// Most significant first, divided by 10 in place one digit at a time
+		std::array<uint64_t, 4> limbs = { magnitude.high >> 32, magnitude.high & 0xFFFFFFFF, magnitude.low >> 32, magnitude.low & 0xFFFFFFFF };
+
+		std::string text;
+		do
+		{
+			uint64_t remainder = 0;
+			for (uint64_t& limb : limbs)
+			{
+				const uint64_t current = (remainder << 32) | limb;
+				limb = current / 10;
+				remainder = current % 10;
+			}
+			text.push_back(static_cast<char>('0' + remainder));
+		} while (std::ranges::any_of(limbs, [](uint64_t limb) { return limb != 0; }));
+
+		if (isNegative())
+		{
+			text.push_back('-');
+		}
+		std::ranges::reverse(text);
+		return text;
+	}
+};
+
+/// <summary>
+/// Aggregates of reverse(x) for every x in a range.
+/// </summary>
+/// <typeparam name="Int">int32_t or int64_t</typeparam>
+template<typename Int>
+struct ReversedRangeStats
+{
+	static constexpr size_t maxDigits = std::numeric_limits<Int>::digits10 + 1;
+	// int64_t can't overflow for int32_t ranges; 64 bit ranges need all 128 bits
+	using Sum = std::conditional_t<sizeof(Int) <= sizeof(int32_t), int64_t, Int128>;
+
+	Sum sum = {};
+	// [n] counts the x whose reverse(x) has n digits, ignoring the sign; 0 counts as 1 digit. [0] is unused
+	std::array<uint64_t, maxDigits + 1> countByDigits = {};
+	// x whose reverse overflowed and became 0; also counted in countByDigits[1]
+	uint64_t overflowCount = 0;
+	Int min = 0;
+	Int max = 0;
+
+	constexpr bool operator==(const ReversedRangeStats&) const noexcept = default;
+};
+
+/// <summary>
+/// Aggregates over reversed magnitudes, before the sign is put back.
+/// </summary>
+struct ReversedMagnitudeStats
+{
+	// Of the reversed magnitudes that didn't overflow
+	Int128 sum;
+	std::array<uint64_t, 21> countByDigits = {};
+	uint64_t overflowCount = 0;
+	// Including the 0 an overflow turns into; only meaningful if not empty
+	uint64_t min = 0;
+	uint64_t max = 0;
+	bool empty = true;
+};
+
+/// <summary>
+/// Digit DP over the L digit magnitudes in [first, last], adding to stats.
+/// </summary>
+/// <param name="first">Has L digits (or is 0 for L = 1)</param>
+/// <param name="last">Has L digits, at least first</param>
+/// <param name="digitCount">L</param>
+/// <param name="limit">Largest reversed magnitude that doesn't overflow</param>
+/// <param name="stats"></param>
+constexpr void accumulateReversedMagnitudes(uint64_t first, uint64_t last, size_t digitCount, uint64_t limit, ReversedMagnitudeStats& stats) noexcept
+{
+	enum Compare : uint8_t
+	{
+		Less,
+		Equal,
+		Greater,
+	};
+
+	struct Partial
+	{
+		// min and max are only meaningful once count isn't 0
+		uint64_t count = 0;
+		Int128 sum;
+		uint64_t min = 0;
+		uint64_t max = 0;
+	};
+
+	const size_t limitDigits = decimalDigitCount(limit);
+
+	// [reverse(x) against limit][x against last][x against first], over the digits placed so far
+	using States = std::array<std::array<std::array<Partial, 3>, 3>, 3>;
+	States states = {};
+	states[digitCount < limitDigits ? Less : Equal][Equal][Equal] = Partial{ 1, {}, 0, 0 };
+
+	for (size_t position = 0; position < digitCount; ++position)
+	{
+		const uint64_t weight = wideTensLookupTable[digitCount - 1 - position];
+		const uint64_t limitDigit = digitCount == limitDigits ? limit / wideTensLookupTable[limitDigits - 1 - position] % 10 : 0;
+		const uint64_t firstDigit = first / wideTensLookupTable[position] % 10;
+		const uint64_t lastDigit = last / wideTensLookupTable[position] % 10;
+
+		States next = {};
+		for (size_t againstLimit = 0; againstLimit < 3; ++againstLimit)
+		{
+			for (size_t againstLast = 0; againstLast < 3; ++againstLast)
+			{
+				for (size_t againstFirst = 0; againstFirst < 3; ++againstFirst)
+				{
+					const Partial& partial = states[againstLimit][againstLast][againstFirst];
+					if (partial.count == 0)
+					{
+						continue;
+					}
+
+					for (uint64_t digit = 0; digit < 10; ++digit)
+					{
+						// The limit is compared from the top of reverse(x), so the first difference decides it;
+						//	x is compared from its bottom, so each more significant difference overrides the last
+						const size_t nextAgainstLimit = againstLimit != Equal ? againstLimit : digit < limitDigit ? Less : digit > limitDigit ? Greater : Equal;
+						const size_t nextAgainstLast = digit < lastDigit ? Less : digit > lastDigit ? Greater : againstLast;
+						const size_t nextAgainstFirst = digit < firstDigit ? Less : digit > firstDigit ? Greater : againstFirst;
+
+						Partial& target = next[nextAgainstLimit][nextAgainstLast][nextAgainstFirst];
+						const uint64_t added = digit * weight;
+						target.min = target.count == 0 ? partial.min + added : std::min(target.min, partial.min + added);
+						target.max = target.count == 0 ? partial.max + added : std::max(target.max, partial.max + added);
+						target.count += partial.count;
+						target.sum = target.sum + partial.sum + Int128::multiply(partial.count, added);
+					}
+				}
+			}
+		}
+		states = next;
+	}
+
+	for (size_t againstLimit = 0; againstLimit < 3; ++againstLimit)
+	{
+		for (size_t againstLast = 0; againstLast < 3; ++againstLast)
+		{
+			for (size_t againstFirst = 0; againstFirst < 3; ++againstFirst)
+			{
+				const Partial& partial = states[againstLimit][againstLast][againstFirst];
+				if (partial.count == 0 || againstLast == Greater || againstFirst == Less)
+				{
+					continue;
+				}
+
+				// Overflowing values all turn into 0
+				const bool overflowed = againstLimit == Greater;
+				const uint64_t partialMin = overflowed ? 0 : partial.min;
+				const uint64_t partialMax = overflowed ? 0 : partial.max;
+				stats.min = stats.empty ? partialMin : std::min(stats.min, partialMin);
+				stats.max = stats.empty ? partialMax : std::max(stats.max, partialMax);
+				stats.empty = false;
+
+				if (overflowed)
+				{
+					stats.overflowCount += partial.count;
+				}
+				else
+				{
+					stats.sum = stats.sum + partial.sum;
+				}
+			}
+		}
+	}
+
+	// reverse(x) has one digit fewer per trailing zero of x, so count the multiples of each power of ten
+	uint64_t nonZeroFirst = first;
+	if (first == 0)
+	{
+		++stats.countByDigits[1];
+		++nonZeroFirst;
+	}
+	if (nonZeroFirst <= last)
+	{
+		for (size_t trailingZeros = 0; trailingZeros < digitCount; ++trailingZeros)
+		{
+			const auto multiplesOf = [&](uint64_t step) { return last / step - (nonZeroFirst - 1) / step; };
+			stats.countByDigits[digitCount - trailingZeros] += multiplesOf(wideTensLookupTable[trailingZeros]) - multiplesOf(wideTensLookupTable[trailingZeros + 1]);
+		}
+	}
+}
+
+/// <summary>
+/// Aggregates over the reversed magnitudes of [first, last], one digit count at a time.
+/// </summary>
+/// <param name="first"></param>
+/// <param name="last"></param>
+/// <param name="limit">Largest reversed magnitude that doesn't overflow</param>
+/// <returns></returns>
+constexpr ReversedMagnitudeStats reversedMagnitudeStats(uint64_t first, uint64_t last, uint64_t limit) noexcept
+{
+	ReversedMagnitudeStats stats;
+	uint64_t lengthFirst = 0;
+	uint64_t lengthLast = 9;
+	for (size_t digitCount = 1; digitCount <= 19 && first <= last; ++digitCount)
+	{
+		const uint64_t clampedFirst = std::max(first, lengthFirst);
+		const uint64_t clampedLast = std::min(last, lengthLast);
+		if (clampedFirst <= clampedLast)
+		{
+			const uint64_t overflowBefore = stats.overflowCount;
+			accumulateReversedMagnitudes(clampedFirst, clampedLast, digitCount, limit, stats);
+
+			// Overflowing values are full length (no trailing zeros), but turn into the one digit 0
+			stats.countByDigits[digitCount] -= stats.overflowCount - overflowBefore;
+			stats.countByDigits[1] += stats.overflowCount - overflowBefore;
+		}
+		lengthFirst = lengthLast + 1;
+		lengthLast = lengthLast * 10 + 9;
+	}
+	return stats;
+}
+
+/// <summary>
+/// Exact aggregates of reverse(x) over [first, last] in O(digits^2), with reverseDigits_ModuloLookup's semantics.
+/// </summary>
+/// <typeparam name="Int">int32_t or int64_t</typeparam>
+/// <param name="first"></param>
+/// <param name="last">Inclusive; a range with last &lt; first is empty and gives all zero stats</param>
+/// <returns></returns>
+template<typename Int>
+	requires std::is_same_v<Int, int32_t> || std::is_same_v<Int, int64_t>
+constexpr ReversedRangeStats<Int> reversedRangeStats(Int first, Int last) noexcept
+{
+	using Stats = ReversedRangeStats<Int>;
+	constexpr uint64_t limit = static_cast<uint64_t>(std::numeric_limits<Int>::max());
+
+	Stats stats;
+	if (last < first)
+	{
+		return stats;
+	}
+
+	// Negative x reverse to the negated reverse of their magnitude; 0 goes with the positive side
+	ReversedMagnitudeStats negative;
+	if (first < 0)
+	{
+		const uint64_t magnitudeFirst = last < 0 ? 0 - static_cast<uint64_t>(static_cast<int64_t>(last)) : 1;
+		negative = reversedMagnitudeStats(magnitudeFirst, 0 - static_cast<uint64_t>(static_cast<int64_t>(first)), limit);
+	}
+	ReversedMagnitudeStats positive;
+	if (last >= 0)
+	{
+		positive = reversedMagnitudeStats(static_cast<uint64_t>(std::max<Int>(first, 0)), static_cast<uint64_t>(last), limit);
+	}
+
+	const Int128 sum = positive.sum - negative.sum;
+	if constexpr (std::is_same_v<typename Stats::Sum, Int128>)
+	{
+		stats.sum = sum;
+	}
+	else
+	{
+		stats.sum = static_cast<int64_t>(sum.low);
+	}
+
+	for (size_t digitCount = 1; digitCount <= Stats::maxDigits; ++digitCount)
+	{
+		stats.countByDigits[digitCount] = positive.countByDigits[digitCount] + negative.countByDigits[digitCount];
+	}
+	stats.overflowCount = positive.overflowCount + negative.overflowCount;
+
+	// Reversed magnitudes that didn't overflow are at most limit, so they fit Int either way round
+	if (negative.empty)
+	{
+		stats.min = static_cast<Int>(positive.min);
+	}
+	else
+	{
+		stats.min = -static_cast<Int>(negative.max);
+	}
+	if (positive.empty)
+	{
+		stats.max = -static_cast<Int>(negative.min);
+	}
+	else
+	{
+		stats.max = static_cast<Int>(positive.max);
+	}
+	return stats;
+}
+
+/// <summary>
+/// The same aggregates by reversing every value in [first, last]; the oracle reversedRangeStats is checked against.
+/// </summary>
+/// <typeparam name="Int">int32_t or int64_t</typeparam>
+/// <param name="first"></param>
+/// <param name="last"></param>
+/// <returns></returns>
+template<typename Int>
+	requires std::is_same_v<Int, int32_t> || std::is_same_v<Int, int64_t>
+constexpr ReversedRangeStats<Int> reversedRangeStats_BruteForce(Int first, Int last) noexcept
+{
+	using Stats = ReversedRangeStats<Int>;
+
+	Stats stats;
+	if (last < first)
+	{
+		return stats;
+	}
+
+	stats.min = std::numeric_limits<Int>::max();
+	stats.max = std::numeric_limits<Int>::lowest();
+	for (Int value = first;; ++value)
+	{
+		Int reversed = 0;
+		if constexpr (std::is_same_v<Int, int32_t>)
+		{
+			reversed = reverseDigits_Reference(value);
+		}
+		else
+		{
+			reversed = reverseDigits_Reference64(value);
+		}
+
+		if constexpr (std::is_same_v<typename Stats::Sum, Int128>)
+		{
+			stats.sum = stats.sum + Int128::fromInt64(reversed);
+		}
+		else
+		{
+			stats.sum += reversed;
+		}
+
+		// Only an overflow turns a non-zero value into 0
+		stats.overflowCount += reversed == 0 && value != 0 ? 1 : 0;
+
+		uint64_t magnitude = reversed < 0 ? 0 - static_cast<uint64_t>(static_cast<int64_t>(reversed)) : static_cast<uint64_t>(reversed);
+		size_t digitCount = 1;
+		while (magnitude >= 10)
+		{
+			magnitude /= 10;
+			++digitCount;
+		}
+		++stats.countByDigits[digitCount];
+
+		stats.min = std::min(stats.min, reversed);
+		stats.max = std::max(stats.max, reversed);
+
+		if (value == last)
+		{
+			break;
+		}
+	}
+	return stats;
+}
@@ -0,0 +1,316 @@
+/*******************************************************************
+* Always-on self test for the reversal kernels.
+*	Unlike assert, nothing here is compiled out by NDEBUG, so the
+*	Release builds we actually benchmark are checked too.
+*******************************************************************/
+
+#pragma once
+
+#include "DecimalText.h"
+#include "InPlaceTextReverser.h"
+#include "ReverseDigits.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hand-picked edge cases: sign handling, single digits, powers of ten, middle digits, and values that overflow once reversed
+inline constexpr int32_t selfTestSpotValues[] = {
+	-1'987'654'321, 256, -256, 12'345, 25, -25, 2, -2, 1, -1, 0, 10, 9,
+	1'000'000'003, -1'000'000'003,
+	std::numeric_limits<int32_t>::lowest(), std::numeric_limits<int32_t>::lowest() + 1,
+	std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max() - 1,
+	2'000'000'008, -2'000'000'008, 1'463'847'412, -1'463'847'412,
+};
+
+// Text fields besides the self test values' own text and its zero padded forms: stray signs and characters, and runs of zeros
+inline constexpr std::string_view selfTestSpotFields[] = {
+	"", "-", "-0", "+1", "1-", " 1", "1a", "--1", "0000000000", "00000000000", "-0000000000", "-00000000000", "02147483648", "2147483648",
+};
+
+enum class SelfTestCheck
+{
+	// The variant's result differs from reverseDigits_Reference
+	Reference,
+	// reverse(reverse(reverse(x))) != reverse(x); once the trailing zeros are gone, reversing must be its own inverse
+	//	Batch kernels do the second and third pass in place, which also covers input and output aliasing
+	RoundTrip,
+	// A checked batch kernel's overflow bit (expected and actual are 0 or 1) or count disagrees with whether the exact reversal fits int32_t
+	OverflowBit,
+	// reverseDecimalFieldInPlace disagrees with parseDecimalInt32 and reverseDigits_Reference on a text field;
+	//	expected and actual are the reversals, or whether each path accepted the field (0 or 1) if only one did
+	TextPaths,
+};
+
+constexpr std::string_view toString(SelfTestCheck check) noexcept
+{
+	switch (check)
+	{
+	case SelfTestCheck::Reference: return "Reference";
+	case SelfTestCheck::RoundTrip: return "Round Trip";
+	case SelfTestCheck::OverflowBit: return "Overflow Bit";
+	case SelfTestCheck::TextPaths: return "Text Paths";
+	}
+	return "Unknown";
+}
+
+struct SelfTestMismatch
+{
+	std::string_view variant;
+	SelfTestCheck check = SelfTestCheck::Reference;
+	int32_t value = 0;
+	int32_t expected = 0;
+	int32_t actual = 0;
+	// The field of a TextPaths mismatch, which stands in for value
+	std::string field;
+};
+
+struct SelfTestReport
+{
+	size_t checkedVariants = 0;
+	size_t checkedValues = 0;
+	size_t mismatchCount = 0;
+	// Capped so a completely broken kernel doesn't flood the report; mismatchCount still counts everything
+	std::vector<SelfTestMismatch> mismatches;
+
+	static constexpr size_t maxStoredMismatches = 32;
+
+	bool passed() const noexcept
+	{
+		return mismatchCount == 0;
+	}
+
+	void print() const
+	{
+		if (passed())
+		{
+			std::println("Self test passed: {} variants x {:L} values", checkedVariants, checkedValues);
+			return;
+		}
+
+		std::println("!!!! Self test FAILED: {:L} mismatches over {} variants x {:L} values", mismatchCount, checkedVariants, checkedValues);
+		for (const SelfTestMismatch& mismatch : mismatches)
+		{
+			if (mismatch.check == SelfTestCheck::TextPaths)
+			{
+				std::println("  [{}] {}: reverse(\"{}\") expected {} but got {}", mismatch.variant, toString(mismatch.check), mismatch.field, mismatch.expected, mismatch.actual);
+				continue;
+			}
+			std::println("  [{}] {}: reverse({}) expected {} but got {}", mismatch.variant, toString(mismatch.check), mismatch.value, mismatch.expected, mismatch.actual);
+		}
+		if (mismatches.size() < mismatchCount)
+		{
+			std::println("  ... and {:L} more", mismatchCount - mismatches.size());
+		}
+	}
+};
+
+/// <summary>
+/// The values the self test runs: the spot values, every power of ten and its neighbors in both signs,
+///		everything in [-1000, 1000], and an even stride over the full int32_t range.
+/// </summary>
+/// <returns></returns>
+inline std::vector<int32_t> selfTestValues()
+{
+	std::vector<int32_t> values(std::begin(selfTestSpotValues), std::end(selfTestSpotValues));
+
+	for (int64_t tens = 1; tens <= std::numeric_limits<int32_t>::max(); tens *= 10)
+	{
+		for (const int64_t value : { tens - 1, tens, tens + 1 })
+		{
+			if (value <= std::numeric_limits<int32_t>::max())
+			{
+				values.push_back(static_cast<int32_t>(value));
+				values.push_back(static_cast<int32_t>(-value));
+			}
+		}
+	}
+
+	for (int32_t value = -1'000; value <= 1'000; ++value)
+	{
+		values.push_back(value);
+	}
+
+	// An odd, non-round stride so the samples don't line up with powers of ten
+	constexpr int64_t stride = 65'537;
+	for (int64_t value = std::numeric_limits<int32_t>::lowest(); value <= std::numeric_limits<int32_t>::max(); value += stride)
+	{
+		values.push_back(static_cast<int32_t>(value));
+	}
+
+	// The sources overlap; don't report the same failure twice
+	std::ranges::sort(values);
+	const auto duplicates = std::ranges::unique(values);
+	values.erase(duplicates.begin(), duplicates.end());
+
+	return values;
+}
+
+/// <summary>
+/// Checks every variant in reversalVariants and every supported one in batchReversalVariants
+///		against the reference and the round trip property, and the supported checkedBatchReversalVariants'
+///		overflow bits against the exact reversal. The in place text reversal is checked against parsing the same fields,
+///		each value's text plain and zero padded to 10 and 11 digits, so both paths accept and reject the same input.
+///		Meant to run before any timing so a broken kernel is never benchmarked.
+/// </summary>
+/// <returns></returns>
+inline SelfTestReport runSelfTest()
+{
+	const std::vector<int32_t> values = selfTestValues();
+
+	SelfTestReport report = {};
+	report.checkedValues = values.size();
+
+	const auto recordMismatch = [&report](const SelfTestMismatch& mismatch)
+	{
+		++report.mismatchCount;
+		if (report.mismatches.size() < SelfTestReport::maxStoredMismatches)
+		{
+			report.mismatches.push_back(mismatch);
+		}
+	};
+
+	for (const ReversalVariant& variant : reversalVariants)
+	{
+		for (const int32_t value : values)
+		{
+			const int32_t expected = reverseDigits_Reference(value);
+			const int32_t result = variant.func(value);
+			if (result != expected)
+			{
+				recordMismatch({ variant.name, SelfTestCheck::Reference, value, expected, result });
+				continue;
+			}
+
+			const int32_t thirdResult = variant.func(variant.func(result));
+			if (thirdResult != result)
+			{
+				recordMismatch({ variant.name, SelfTestCheck::RoundTrip, value, result, thirdResult });
+			}
+		}
+		++report.checkedVariants;
+	}
+
+	std::vector<int32_t> results(values.size());
+	std::vector<int32_t> roundTrips(values.size());
+	for (const BatchReversalVariant& variant : batchReversalVariants)
+	{
+		if (!variant.isSupported())
+		{
+			continue;
+		}
+
+		variant.func(values, results);
+		roundTrips = results;
+		variant.func(roundTrips, roundTrips);
+		variant.func(roundTrips, roundTrips);
+
+		for (size_t index = 0; index < values.size(); ++index)
+		{
+			const int32_t expected = reverseDigits_Reference(values[index]);
+			if (results[index] != expected)
+			{
+				recordMismatch({ variant.name, SelfTestCheck::Reference, values[index], expected, results[index] });
+			}
+			else if (roundTrips[index] != results[index])
+			{
+				recordMismatch({ variant.name, SelfTestCheck::RoundTrip, values[index], results[index], roundTrips[index] });
+			}
+		}
+		++report.checkedVariants;
+	}
+
+	std::vector<uint64_t> overflowBits(overflowMaskWords(values.size()));
+	for (const CheckedBatchReversalVariant& variant : checkedBatchReversalVariants)
+	{
+		if (!variant.isSupported())
+		{
+			continue;
+		}
+
+		// Garbage in the mask has to be overwritten, not ORed into
+		std::ranges::fill(overflowBits, ~uint64_t(0));
+		const size_t overflowCount = variant.func(values, results, overflowBits);
+
+		size_t expectedCount = 0;
+		for (size_t index = 0; index < values.size(); ++index)
+		{
+			const int32_t expected = reverseDigits_Reference(values[index]);
+			const int32_t expectedBit = fitsInt32(reverseDigits_Wide(values[index])) ? 0 : 1;
+			const int32_t bit = static_cast<int32_t>((overflowBits[index / 64] >> (index % 64)) & 1);
+			expectedCount += static_cast<size_t>(expectedBit);
+			if (results[index] != expected)
+			{
+				recordMismatch({ variant.name, SelfTestCheck::Reference, values[index], expected, results[index] });
+			}
+			else if (bit != expectedBit)
+			{
+				recordMismatch({ variant.name, SelfTestCheck::OverflowBit, values[index], expectedBit, bit });
+			}
+		}
+
+		const uint64_t unusedBits = values.size() % 64 == 0 ? 0 : ~uint64_t(0) << (values.size() % 64);
+		if (overflowCount != expectedCount || (overflowBits.back() & unusedBits) != 0)
+		{
+			recordMismatch({ variant.name, SelfTestCheck::OverflowBit, 0, static_cast<int32_t>(expectedCount), static_cast<int32_t>(overflowCount) });
+		}
+		++report.checkedVariants;
+	}
+
+	std::vector<std::string> fields(std::begin(selfTestSpotFields), std::end(selfTestSpotFields));
+	for (const int32_t value : values)
+	{
+		char text[maxDecimalInt32Length];
+		const std::string_view digits(text, formatDecimalInt32(value, text));
+		const std::string_view sign = value < 0 ? "-" : "";
+		const std::string_view magnitude = digits.substr(sign.size());
+		fields.emplace_back(digits);
+		for (const size_t paddedLength : { size_t(10), size_t(11) })
+		{
+			if (magnitude.size() < paddedLength)
+			{
+				fields.push_back(std::string(sign) + std::string(paddedLength - magnitude.size(), '0') + std::string(magnitude));
+			}
+		}
+	}
+
+	constexpr std::string_view textVariantName = "In Place Text";
+	for (const std::string& field : fields)
+	{
+		int32_t parsed = 0;
+		const bool parseAccepted = parseDecimalInt32(field, parsed);
+
+		std::string rewritten = field;
+		const size_t rewrittenLength = reverseDecimalFieldInPlace(rewritten);
+		const bool inPlaceAccepted = rewrittenLength != 0;
+		if (parseAccepted != inPlaceAccepted)
+		{
+			recordMismatch({ textVariantName, SelfTestCheck::TextPaths, 0, parseAccepted ? 1 : 0, inPlaceAccepted ? 1 : 0, field });
+			continue;
+		}
+
+		if (!parseAccepted)
+		{
+			continue;
+		}
+
+		// Compared as text, so a non-canonical rewrite such as "-0" or a kept leading zero fails too
+		const int32_t expected = reverseDigits_Reference(parsed);
+		char expectedText[maxDecimalInt32Length];
+		const std::string_view expectedField(expectedText, formatDecimalInt32(expected, expectedText));
+		const std::string_view rewrittenField = std::string_view(rewritten).substr(0, rewrittenLength);
+		if (rewrittenField != expectedField)
+		{
+			int32_t actual = 0;
+			parseDecimalInt32(rewrittenField, actual);
+			recordMismatch({ textVariantName, SelfTestCheck::TextPaths, parsed, expected, actual, field });
+		}
+	}
+	++report.checkedVariants;
+
+	return report;
+}
@@ -0,0 +1,333 @@
+/*******************************************************************
+* Lock-free multi producer, single consumer ring of value blocks in
+*	memfd backed shared memory, for callers on the same host that
+*	can't afford a socket round trip. Producers (any thread of any
+*	process sharing the mapping) copy a block into a slot; a worker
+*	reverses it in place and hands the slot back. Waiting spins
+*	briefly, then sleeps on the slot's sequence word with a shared
+*	futex. Linux only; SHAREDRING_AVAILABLE is 0 everywhere else.
+*
+*	Each slot's sequence number (Vyukov's bounded queue) encodes its
+*	state for the ticket t that owns it this lap:
+*		t       free, waiting for the producer holding ticket t
+*		t + 1   submitted, waiting for the worker
+*		t + 2   reversed, waiting for the producer to copy it out
+*		t + N   released to the producer one lap later
+*******************************************************************/
+
+#pragma once
+
+#if defined(__linux__)
+#define SHAREDRING_AVAILABLE 1
+#else
+#define SHAREDRING_AVAILABLE 0
+#endif
+
+#if SHAREDRING_AVAILABLE
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "ReverseDigits.h"
+
+class SharedRing
+{
+public:
+	SharedRing(SharedRing&& other) noexcept
+		: memoryDescriptor(std::exchange(other.memoryDescriptor, -1))
+		, mapping(std::exchange(other.mapping, nullptr))
+		, mappingSize(other.mappingSize)
+	{
+	}
+
+	SharedRing(const SharedRing&) = delete;
+	SharedRing& operator=(const SharedRing&) = delete;
+	SharedRing& operator=(SharedRing&&) = delete;
+
+	~SharedRing()
+	{
+		if (mapping != nullptr)
+		{
+			::munmap(mapping, mappingSize);
+		}
+		if (memoryDescriptor >= 0)
+		{
+			::close(memoryDescriptor);
+		}
+	}
+
+	/// <summary>
+	/// Creates the ring in a new memfd. Other processes share it by inheriting the mapping across fork,
+	///		or by mapping descriptor() (e.g. through /proc/&lt;pid&gt;/fd) with attach.
+	/// </summary>
+	/// <param name="slotCount">Rounded up to a power of two, at least 4</param>
+	/// <param name="slotValues">Largest block a producer can submit</param>
+	/// <returns>The ring, or a description of what failed</returns>
+	static std::expected<SharedRing, std::string> create(uint32_t slotCount, uint32_t slotValues)
+	{
+		slotCount = std::bit_ceil(std::max<uint32_t>(slotCount, 4));
+		slotValues = std::max<uint32_t>(slotValues, 1);
+
+		const int descriptor = ::memfd_create("intdigitreverser-ring", MFD_CLOEXEC);
+		if (descriptor < 0)
+		{
+			return std::unexpected(std::format("memfd_create failed: {}", std::strerror(errno)));
+		}
+
+		SharedRing ring(descriptor);
+		ring.mappingSize = sizeof(Header) + slotCount * slotStride(slotValues);
+		if (::ftruncate(descriptor, static_cast<off_t>(ring.mappingSize)) != 0)
+		{
+			return std::unexpected(std::format("Failed to size the ring: {}", std::strerror(errno)));
+		}
+		if (std::expected<void, std::string> mapped = ring.map(); !mapped)
+		{
+			return std::unexpected(mapped.error());
+		}
+
+		// A fresh memfd reads as zeros, so only the non-zero fields need setting
+		Header& header = ring.header();
+		header.magic = ringMagic;
+		header.slotCount = slotCount;
+		header.slotValues = slotValues;
+		for (uint32_t slotIndex = 0; slotIndex < slotCount; ++slotIndex)
+		{
+			ring.slot(slotIndex).sequence.store(slotIndex, std::memory_order_relaxed);
+		}
+		return ring;
+	}
+
+	/// <summary>
+	/// Maps an existing ring, created by another process, from a descriptor to the same memfd.
+	/// </summary>
+	/// <param name="descriptor">Owned by the ring from here on</param>
+	/// <returns>The ring, or a description of what failed</returns>
+	static std::expected<SharedRing, std::string> attach(int descriptor)
+	{
+		SharedRing ring(descriptor);
+		const off_t size = ::lseek(descriptor, 0, SEEK_END);
+		if (size < static_cast<off_t>(sizeof(Header)))
+		{
+			return std::unexpected(std::string("not a ring"));
+		}
+		ring.mappingSize = static_cast<size_t>(size);
+		if (std::expected<void, std::string> mapped = ring.map(); !mapped)
+		{
+			return std::unexpected(mapped.error());
+		}
+		if (ring.header().magic != ringMagic || sizeof(Header) + ring.header().slotCount * slotStride(ring.header().slotValues) > ring.mappingSize)
+		{
+			return std::unexpected(std::string("not a ring"));
+		}
+		return ring;
+	}
+
+	int descriptor() const noexcept
+	{
+		return memoryDescriptor;
+	}
+
+	uint32_t slotValues() const noexcept
+	{
+		return header().slotValues;
+	}
+
+	/// <summary>
+	/// Producer side, safe from any number of threads and processes: one round trip through the worker.
+	/// </summary>
+	/// <param name="values">At most slotValues()</param>
+	/// <param name="reversed">At least values.size()</param>
+	/// <returns>False if values doesn't fit in a slot</returns>
+	bool reverse(std::span<const int32_t> values, std::span<int32_t> reversed) noexcept
+	{
+		if (values.size() > slotValues() || reversed.size() < values.size())
+		{
+			return false;
+		}
+
+		const uint32_t ticket = static_cast<uint32_t>(header().nextTicket.fetch_add(1, std::memory_order_relaxed));
+		Slot& claimed = slot(ticket);
+
+		waitForSequence(claimed, ticket);
+		claimed.count = static_cast<uint32_t>(values.size());
+		std::ranges::copy(values, claimed.values());
+		publishSequence(claimed, ticket + 1);
+
+		waitForSequence(claimed, ticket + 2);
+		std::ranges::copy(std::span<const int32_t>(claimed.values(), values.size()), reversed.begin());
+		publishSequence(claimed, ticket + header().slotCount);
+		return true;
+	}
+
+	/// <summary>
+	/// Worker side, from exactly one thread across all processes: reverses submitted slots in ticket order,
+	///		in place with the batch kernel, until requestStop.
+	/// </summary>
+	void serve() noexcept
+	{
+		for (uint32_t ticket = 0;; ++ticket)
+		{
+			Slot& submitted = slot(ticket);
+			waitForSequence(submitted, ticket + 1);
+
+			const bool isStop = submitted.count == stopCount;
+			if (!isStop)
+			{
+				const std::span<int32_t> values(submitted.values(), submitted.count);
+				reverseDigits(values, values);
+			}
+			publishSequence(submitted, ticket + 2);
+
+			if (isStop)
+			{
+				return;
+			}
+		}
+	}
+
+	/// <summary>
+	/// Makes serve return once everything submitted before this call has been reversed. Call once.
+	/// </summary>
+	void requestStop() noexcept
+	{
+		const uint32_t ticket = static_cast<uint32_t>(header().nextTicket.fetch_add(1, std::memory_order_relaxed));
+		Slot& claimed = slot(ticket);
+
+		waitForSequence(claimed, ticket);
+		claimed.count = stopCount;
+		publishSequence(claimed, ticket + 1);
+		waitForSequence(claimed, ticket + 2);
+		publishSequence(claimed, ticket + header().slotCount);
+	}
+
+private:
+	static constexpr uint32_t ringMagic = 0x474E4952; // "RING"
+	static constexpr uint32_t stopCount = UINT32_MAX;
+
+	// Spins before sleeping, about the cost of the futex round trip it saves. On a single hardware thread
+	//	the other side can't make progress while we spin, so sleep right away there
+	static int spinCount() noexcept
+	{
+		static const int count = std::thread::hardware_concurrency() > 1 ? 2048 : 0;
+		return count;
+	}
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free, "the ring's atomics have to be address free to work across processes");
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t slotCount;
+		uint32_t slotValues;
+		// Producers claim tickets here; on its own cache line since every producer hits it
+		alignas(64) std::atomic<uint64_t> nextTicket;
+	};
+
+	struct alignas(64) Slot
+	{
+		std::atomic<uint32_t> sequence;
+		// Threads asleep on sequence, so publishers only pay for FUTEX_WAKE when someone is there
+		std::atomic<uint32_t> sleepers;
+		uint32_t count;
+
+		int32_t* values() noexcept
+		{
+			return reinterpret_cast<int32_t*>(reinterpret_cast<char*>(this) + sizeof(Slot));
+		}
+	};
+
+	static size_t slotStride(uint32_t slotValues) noexcept
+	{
+		return sizeof(Slot) + (slotValues * sizeof(int32_t) + 63) / 64 * 64;
+	}
+
+	explicit SharedRing(int descriptor) noexcept
+		: memoryDescriptor(descriptor)
+	{
+	}
+
+	std::expected<void, std::string> map()
+	{
+		void* const address = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, memoryDescriptor, 0);
+		if (address == MAP_FAILED)
+		{
+			return std::unexpected(std::format("Failed to map the ring: {}", std::strerror(errno)));
+		}
+		mapping = static_cast<char*>(address);
+		return {};
+	}
+
+	Header& header() const noexcept
+	{
+		return *reinterpret_cast<Header*>(mapping);
+	}
+
+	Slot& slot(uint32_t ticket) const noexcept
+	{
+		const uint32_t slotIndex = ticket & (header().slotCount - 1);
+		return *reinterpret_cast<Slot*>(mapping + sizeof(Header) + slotIndex * slotStride(header().slotValues));
+	}
+
+	static void waitForSequence(Slot& waited, uint32_t sequence) noexcept
+	{
+		for (int spin = 0; spin < spinCount(); ++spin)
+		{
+			if (waited.sequence.load(std::memory_order_acquire) == sequence)
+			{
+				return;
+			}
+#if REVERSEDIGITS_X86
+			_mm_pause();
+#endif
+		}
+
+		for (;;)
+		{
+			// Registering as a sleeper before the final check pairs with publishSequence's store then check
+			waited.sleepers.fetch_add(1, std::memory_order_seq_cst);
+			const uint32_t current = waited.sequence.load(std::memory_order_seq_cst);
+			if (current != sequence)
+			{
+				::syscall(SYS_futex, &waited.sequence, FUTEX_WAIT, current, nullptr, nullptr, 0);
+			}
+			waited.sleepers.fetch_sub(1, std::memory_order_relaxed);
+
+			if (waited.sequence.load(std::memory_order_acquire) == sequence)
+			{
+				return;
+			}
+		}
+	}
+
+	static void publishSequence(Slot& published, uint32_t sequence) noexcept
+	{
+		published.sequence.store(sequence, std::memory_order_seq_cst);
+		if (published.sleepers.load(std::memory_order_seq_cst) != 0)
+		{
+			::syscall(SYS_futex, &published.sequence, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+		}
+	}
+
+	int memoryDescriptor = -1;
+	char* mapping = nullptr;
+	size_t mappingSize = 0;
+};
+
+#endif
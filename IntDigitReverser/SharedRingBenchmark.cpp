@@ -0,0 +1,128 @@
+/*******************************************************************
+* Shared memory ring vs socket vs in process round trips.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+#include <cstdio>
+
+#include "ClosedLoopLoad.h"
+#include "ReversalService.h"
+#include "ReverseDigits.h"
+#include "SharedRing.h"
+#include "SharedRingBenchmark.h"
+
+#if SHAREDRING_AVAILABLE
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// Slots in the ring; comfortably more than the producers, so claiming a slot never waits on a lap
+	constexpr uint32_t ringSlotCount = 64;
+
+	struct InProcessClient
+	{
+		bool operator()(std::span<const int32_t> values, std::span<int32_t> reversed) const
+		{
+			reverseDigits(values, reversed);
+			return true;
+		}
+	};
+
+#if SHAREDRING_AVAILABLE
+	struct SharedRingClient
+	{
+		SharedRing* ring;
+
+		bool operator()(std::span<const int32_t> values, std::span<int32_t> reversed) const
+		{
+			return ring->reverse(values, reversed);
+		}
+	};
+#endif
+
+	bool printRow(std::string_view name, const std::expected<LoadSummary, std::string>& summary, size_t valuesPerRequest)
+	{
+		if (!summary)
+		{
+			std::println(stderr, "{}: {}", name, summary.error());
+			return false;
+		}
+		std::println("{}", name);
+		printLoadSummary(*summary, valuesPerRequest);
+		return summary->wrongReplies == 0;
+	}
+}
+
+int runSharedRingBenchmark(size_t valuesPerRequest, size_t requestCount, size_t producerCount)
+{
+#if SHAREDRING_AVAILABLE
+	valuesPerRequest = std::clamp<size_t>(valuesPerRequest, 1, maxServiceRequestValues);
+	producerCount = std::clamp<size_t>(producerCount, 1, ringSlotCount / 2);
+
+	std::expected<SharedRing, std::string> ring = SharedRing::create(ringSlotCount, static_cast<uint32_t>(valuesPerRequest));
+	if (!ring)
+	{
+		std::println(stderr, "{}", ring.error());
+		return 1;
+	}
+
+	// The worker is a separate process sharing nothing with this one but the memfd mapping
+	std::fflush(stdout);
+	const pid_t parent = ::getpid();
+	const pid_t worker = ::fork();
+	if (worker < 0)
+	{
+		std::println(stderr, "fork failed: {}", std::strerror(errno));
+		return 1;
+	}
+	if (worker == 0)
+	{
+		// Don't outlive a parent that dies without requestStop; it may already have died before prctl took effect
+		if (::prctl(PR_SET_PDEATHSIG, SIGKILL) != 0 || ::getppid() != parent)
+		{
+			::_exit(1);
+		}
+		ring->serve();
+		::_exit(0);
+	}
+
+	std::println("{:L} requests of {} values per producer, {}", requestCount, valuesPerRequest, toString(batchSimdLevel()));
+
+	bool allCorrect = true;
+	for (const size_t producers : { size_t(1), producerCount })
+	{
+		std::println("\n{} producer{}:", producers, producers == 1 ? "" : "s");
+
+		std::vector<InProcessClient> inProcessClients(producers);
+		allCorrect &= printRow("In process call", measureClosedLoop(std::span(inProcessClients), requestCount, valuesPerRequest), valuesPerRequest);
+
+		std::vector<SharedRingClient> ringClients(producers, SharedRingClient{ &*ring });
+		allCorrect &= printRow("Shared memory ring, worker process", measureClosedLoop(std::span(ringClients), requestCount, valuesPerRequest), valuesPerRequest);
+
+		allCorrect &= printRow("Unix socket service, 0us batch window", measureReversalService(defaultServiceAddress(), std::chrono::microseconds(0), producers, requestCount, valuesPerRequest), valuesPerRequest);
+
+		if (producers == producerCount)
+		{
+			break;
+		}
+	}
+
+	ring->requestStop();
+	int workerStatus = 0;
+	::waitpid(worker, &workerStatus, 0);
+
+	return allCorrect ? 0 : 1;
+#else
+	(void)valuesPerRequest;
+	(void)requestCount;
+	(void)producerCount;
+	std::println(stderr, "The shared memory ring is only available on Linux");
+	return 1;
+#endif
+}
@@ -0,0 +1,20 @@
+/*******************************************************************
+* Round trip comparison of the ways a co-located caller can get
+*	values reversed: in process, through the shared memory ring to
+*	a worker process, and through the socket service.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary>
+/// Forks a worker process serving a SharedRing, then runs the same closed loop load with one producer and with
+///		producerCount producers against an in process call, the ring and the socket service, printing p50 / p99
+///		round trip latency and throughput for each. Linux only.
+/// </summary>
+/// <param name="valuesPerRequest"></param>
+/// <param name="requestCount">Per producer</param>
+/// <param name="producerCount"></param>
+/// <returns>Non-zero on errors or wrong results</returns>
+int runSharedRingBenchmark(size_t valuesPerRequest, size_t requestCount, size_t producerCount);
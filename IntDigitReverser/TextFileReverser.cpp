@@ -0,0 +1,326 @@
+/*******************************************************************
+* Streaming text file reverser: mmap in, SWAR parse, batch SIMD
+*	reverse, table driven format, one big buffered write out.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+#include <cstdio>
+
+#include "BufferedWriter.h"
+#include "DecimalText.h"
+#include "InPlaceTextReverser.h"
+#include "MappedFile.h"
+#include "ReverseDigits.h"
+#include "TextFileReverser.h"
+
+namespace
+{
+	// Values are parsed into a block this size, then reversed and formatted together
+	constexpr size_t valueBlockSize = 4096;
+
+	/// <summary>
+	/// count newline terminated random int32 values, from the same seed as generate-text.
+	/// </summary>
+	/// <param name="count"></param>
+	/// <returns></returns>
+	std::vector<char> generateRandomText(uint64_t count)
+	{
+		std::mt19937 generator(12345);
+		std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::lowest(), std::numeric_limits<int32_t>::max());
+
+		std::vector<char> text(count * (maxDecimalInt32Length + 1));
+		char* cursor = text.data();
+		for (uint64_t index = 0; index < count; ++index)
+		{
+			cursor = formatDecimalInt32(distribution(generator), cursor);
+			*cursor++ = '\n';
+		}
+		text.resize(static_cast<size_t>(cursor - text.data()));
+		return text;
+	}
+
+	/// <summary>
+	/// parse + batch reverse + format, the same path as runReverseTextFile but into memory.
+	/// </summary>
+	/// <param name="input"></param>
+	/// <param name="output">Must be at least as large as input</param>
+	/// <returns>Length of the output</returns>
+	size_t reverseTextViaBinary(std::string_view input, std::span<char> output)
+	{
+		std::array<int32_t, valueBlockSize> values;
+		size_t valueCount = 0;
+		char* cursor = output.data();
+
+		const auto flushValues = [&]()
+		{
+			const std::span<int32_t> block(values.data(), valueCount);
+			reverseDigits(block, block);
+			for (const int32_t value : block)
+			{
+				cursor = formatDecimalInt32(value, cursor);
+				*cursor++ = '\n';
+			}
+			valueCount = 0;
+		};
+
+		forEachDelimitedField(input, '\n', [&](const char* lineBegin, const char* lineEnd)
+		{
+			parseDecimalInt32(std::string_view(lineBegin, lineEnd), values[valueCount]);
+			if (++valueCount == values.size())
+			{
+				flushValues();
+			}
+			return true;
+		});
+		flushValues();
+
+		return static_cast<size_t>(cursor - output.data());
+	}
+
+	/// <summary>
+	/// The standard library path the CharArray kernels build on: std::from_chars, the scalar kernel, std::format_to.
+	/// </summary>
+	/// <param name="input"></param>
+	/// <param name="output">Must be at least as large as input</param>
+	/// <returns>Length of the output</returns>
+	size_t reverseTextViaStd(std::string_view input, std::span<char> output)
+	{
+		char* cursor = output.data();
+		const char* lineBegin = input.data();
+		const char* const inputEnd = input.data() + input.size();
+		while (lineBegin < inputEnd)
+		{
+			const char* const lineEnd = std::find(lineBegin, inputEnd, '\n');
+
+			int32_t value = 0;
+			std::from_chars(lineBegin, lineEnd, value);
+			cursor = std::format_to(cursor, "{}\n", reverseDigits_ModuloLookup(value));
+
+			lineBegin = lineEnd + 1;
+		}
+		return static_cast<size_t>(cursor - output.data());
+	}
+}
+
+int runReverseTextFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath)
+{
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	std::expected<MappedFile, std::string> input = MappedFile::openReadOnly(inputPath);
+	if (!input)
+	{
+		std::println(stderr, "{}", input.error());
+		return 1;
+	}
+
+	std::expected<BufferedWriter, std::string> output = BufferedWriter::open(outputPath);
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	std::array<int32_t, valueBlockSize> values;
+	size_t valueCount = 0;
+	uint64_t lineCount = 0;
+
+	const auto flushValues = [&]()
+	{
+		const std::span<int32_t> block(values.data(), valueCount);
+		reverseDigits(block, block);
+
+		char* cursor = output->reserve(valueCount * (maxDecimalInt32Length + 1));
+		for (const int32_t value : block)
+		{
+			cursor = formatDecimalInt32(value, cursor);
+			*cursor++ = '\n';
+		}
+		output->commit(cursor);
+
+		valueCount = 0;
+	};
+
+	const std::string_view text(input->chars().data(), input->size());
+	const bool parsedAll = forEachDelimitedField(text, '\n', [&](const char* lineBegin, const char* lineEnd)
+	{
+		++lineCount;
+
+		// Tolerate CRLF files
+		if (lineEnd != lineBegin && lineEnd[-1] == '\r')
+		{
+			--lineEnd;
+		}
+
+		const std::string_view line(lineBegin, lineEnd);
+		if (!parseDecimalInt32(line, values[valueCount]))
+		{
+			std::println(stderr, "{}:{}: '{}' is not a valid int32", inputPath.string(), lineCount, line);
+			return false;
+		}
+
+		if (++valueCount == values.size())
+		{
+			flushValues();
+		}
+		return true;
+	});
+
+	if (!parsedAll)
+	{
+		return 1;
+	}
+
+	flushValues();
+	const size_t outputBytes = output->bytesWritten();
+	if (!output->close())
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+	const double seconds = std::max(duration.count(), 1e-9);
+
+	std::println("Reversed {:L} lines ({:L} bytes in, {:L} bytes out) in {:.3f}s", lineCount, input->size(), outputBytes, seconds);
+	std::println("  {:.3f} GB/s in, {:.2f} Mlines/s", static_cast<double>(input->size()) / seconds / 1e9, static_cast<double>(lineCount) / seconds / 1e6);
+	return 0;
+}
+
+int runReverseTextFileInPlace(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath)
+{
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	std::expected<MappedFile, std::string> input = MappedFile::openCopyOnWrite(inputPath);
+	if (!input)
+	{
+		std::println(stderr, "{}", input.error());
+		return 1;
+	}
+
+	std::expected<BufferedWriter, std::string> output = BufferedWriter::open(outputPath);
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	const std::span<char> text = input->writableChars();
+	const InPlaceReversalResult result = reverseDecimalFieldsInPlace(text, '\n');
+	if (!result.valid)
+	{
+		std::println(stderr, "{}:{}: not a valid int32", inputPath.string(), result.fieldCount);
+		return 1;
+	}
+
+	output->write(text.first(result.length));
+	if (!output->close())
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+	const double seconds = std::max(duration.count(), 1e-9);
+
+	std::println("Reversed {:L} lines in place ({:L} bytes in, {:L} bytes out) in {:.3f}s", result.fieldCount, input->size(), result.length, seconds);
+	std::println("  {:.3f} GB/s in, {:.2f} Mlines/s", static_cast<double>(input->size()) / seconds / 1e9, static_cast<double>(result.fieldCount) / seconds / 1e6);
+	return 0;
+}
+
+int runTextPipelineBenchmark(uint64_t count)
+{
+	constexpr size_t repeatCount = 10;
+
+	const std::vector<char> input = generateRandomText(count);
+	const std::string_view inputText(input.data(), input.size());
+
+	std::println("Timing text pipelines {}x over {:L} values ({:L} bytes)...\n", repeatCount, count, input.size());
+
+	std::vector<char> work(input.size());
+	std::vector<char> output(input.size());
+
+	struct PipelineResult
+	{
+		std::string_view name;
+		std::vector<double> seconds;
+		std::string output;
+	};
+
+	const auto timePipeline = [&](std::string_view name, const auto& pipeline)
+	{
+		PipelineResult result = { name };
+		for (size_t repeatIndex = 0; repeatIndex < repeatCount; ++repeatIndex)
+		{
+			std::print(".");
+			// The in place pipeline destroys its input; refresh it outside of the timed region for every pipeline alike
+			std::ranges::copy(input, work.begin());
+
+			const auto startTime = std::chrono::high_resolution_clock::now();
+			const size_t length = pipeline();
+			const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - startTime);
+
+			result.seconds.push_back(duration.count());
+			if (repeatIndex == 0)
+			{
+				const char* const produced = name == "In Place Text" ? work.data() : output.data();
+				result.output.assign(produced, length);
+			}
+		}
+		std::print("\n");
+		std::ranges::sort(result.seconds);
+		return result;
+	};
+
+	const PipelineResult results[] = {
+		timePipeline("In Place Text", [&]() { return reverseDecimalFieldsInPlace(work, '\n').length; }),
+		timePipeline("Parse + Batch + Format", [&]() { return reverseTextViaBinary(std::string_view(work.data(), work.size()), output); }),
+		timePipeline("from_chars + Lookup + format_to", [&]() { return reverseTextViaStd(std::string_view(work.data(), work.size()), output); }),
+	};
+
+	std::print("\n");
+	bool allMatch = true;
+	for (const PipelineResult& result : results)
+	{
+		const double median = std::max(result.seconds[result.seconds.size() / 2], 1e-9);
+		const bool matches = result.output == results[0].output;
+		allMatch &= matches;
+
+		std::println("{:<32} median {:.2f}ms, {:.3f} GB/s, {:.2f} Mlines/s{}", result.name, median * 1'000.0,
+			static_cast<double>(inputText.size()) / median / 1e9, static_cast<double>(count) / median / 1e6, matches ? "" : "  !!!! OUTPUT DIFFERS");
+	}
+
+	return allMatch ? 0 : 1;
+}
+
+int runGenerateTextFile(const std::filesystem::path& outputPath, uint64_t count)
+{
+	std::expected<BufferedWriter, std::string> output = BufferedWriter::open(outputPath);
+	if (!output)
+	{
+		std::println(stderr, "{}", output.error());
+		return 1;
+	}
+
+	// Fixed seed so runs are comparable
+	std::mt19937 generator(12345);
+	std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<int32_t>::lowest(), std::numeric_limits<int32_t>::max());
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		char* cursor = output->reserve(maxDecimalInt32Length + 1);
+		cursor = formatDecimalInt32(distribution(generator), cursor);
+		*cursor++ = '\n';
+		output->commit(cursor);
+	}
+
+	if (!output->close())
+	{
+		std::println(stderr, "Failed writing {}", outputPath.string());
+		return 1;
+	}
+
+	std::println("Wrote {:L} values to {}", count, outputPath.string());
+	return 0;
+}
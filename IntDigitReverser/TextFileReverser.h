@@ -0,0 +1,43 @@
+/*******************************************************************
+* File modes for newline separated decimal integers.
+*******************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+/// <summary>
+/// Reverses the digits of every line of inputPath into outputPath, one value per line, and prints GB/s and lines/s.
+///		The input is memory mapped and parsed in place; values are reversed a block at a time with the batch kernel.
+/// </summary>
+/// <param name="inputPath"></param>
+/// <param name="outputPath"></param>
+/// <returns>Non-zero on I/O errors or lines that aren't a valid int32</returns>
+int runReverseTextFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath);
+
+/// <summary>
+/// Same as runReverseTextFile, but reverses the text without converting to binary:
+///		the input is mapped copy on write, every line is rewritten in place with reverseDecimalFieldsInPlace,
+///		and the compacted text is written out in one go. LF line endings only.
+/// </summary>
+/// <param name="inputPath"></param>
+/// <param name="outputPath"></param>
+/// <returns>Non-zero on I/O errors or lines that aren't a valid int32</returns>
+int runReverseTextFileInPlace(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath);
+
+/// <summary>
+/// Times the in place text reversal against parse + batch reverse + format and against the
+///		std::from_chars + reverseDigits_ModuloLookup + std::format_to path, over count random values in memory.
+/// </summary>
+/// <param name="count"></param>
+/// <returns>Non-zero if the pipelines disagree</returns>
+int runTextPipelineBenchmark(uint64_t count);
+
+/// <summary>
+/// Writes count uniformly distributed random int32 values, one per line, as input for runReverseTextFile.
+/// </summary>
+/// <param name="outputPath"></param>
+/// <param name="count"></param>
+/// <returns>Non-zero on I/O errors</returns>
+int runGenerateTextFile(const std::filesystem::path& outputPath, uint64_t count);
@@ -0,0 +1,137 @@
+/*******************************************************************
+* Thread placement helpers shared by the parallel batch API and the
+*	scaling benchmarks: which logical processors this process may
+*	use, and pinning the calling thread to one of them.
+*******************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#endif
+
+/// <summary>
+/// Lists the logical processors this process is allowed to run on.
+///		On Linux this honors the affinity mask (taskset, cgroups), elsewhere it falls back to hardware_concurrency.
+/// </summary>
+/// <returns></returns>
+inline std::vector<size_t> availableCores()
+{
+	std::vector<size_t> cores;
+
+#if defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+	{
+		for (size_t core = 0; core < CPU_SETSIZE; ++core)
+		{
+			if (CPU_ISSET(core, &cpuSet))
+			{
+				cores.push_back(core);
+			}
+		}
+	}
+#endif
+
+	if (cores.empty())
+	{
+		const size_t coreCount = std::max(1u, std::thread::hardware_concurrency());
+		for (size_t core = 0; core < coreCount; ++core)
+		{
+			cores.push_back(core);
+		}
+	}
+
+	return cores;
+}
+
+/// <summary>
+/// Pins the calling thread to a single logical processor.
+/// </summary>
+/// <param name="core"></param>
+/// <returns>False if the platform doesn't support pinning or the call failed</returns>
+inline bool pinCurrentThreadToCore(size_t core) noexcept
+{
+#if defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#elif defined(_WIN32)
+	if (core >= sizeof(DWORD_PTR) * 8)
+	{
+		return false;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core) != 0;
+#else
+	return false;
+#endif
+}
+
+/// <summary>
+/// Pins the calling thread to one logical processor for its lifetime and then restores the affinity the thread had,
+///		for borrowing a thread the caller owns (such as a pool's calling participant) without re-pinning it for good.
+/// </summary>
+class ScopedCorePin
+{
+public:
+	/// <param name="core">SIZE_MAX to leave the thread as it is</param>
+	explicit ScopedCorePin(size_t core) noexcept
+	{
+		if (core == SIZE_MAX)
+		{
+			return;
+		}
+
+#if defined(__linux__)
+		pinned = pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) == 0 && pinCurrentThreadToCore(core);
+#elif defined(_WIN32)
+		if (core < sizeof(DWORD_PTR) * 8)
+		{
+			previous = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << core);
+			pinned = previous != 0;
+		}
+#endif
+	}
+
+	ScopedCorePin(const ScopedCorePin&) = delete;
+	ScopedCorePin& operator=(const ScopedCorePin&) = delete;
+
+	~ScopedCorePin()
+	{
+		if (!pinned)
+		{
+			return;
+		}
+
+#if defined(__linux__)
+		pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+#elif defined(_WIN32)
+		SetThreadAffinityMask(GetCurrentThread(), previous);
+#endif
+	}
+
+private:
+	bool pinned = false;
+#if defined(__linux__)
+	cpu_set_t previous = {};
+#elif defined(_WIN32)
+	DWORD_PTR previous = 0;
+#endif
+};
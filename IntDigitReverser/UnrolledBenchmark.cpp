@@ -0,0 +1,156 @@
+/*******************************************************************
+* Whether dispatching once on the digit count beats a loop whose
+*	trip count is the digit count, and how that depends on the mix
+*	of digit counts in the input.
+*******************************************************************/
+
+import std;
+
+#include <cstdint>
+
+#include "BenchmarkTiming.h"
+#include "ReversalPreimages.h"
+#include "ReverseDigits.h"
+#include "UnrolledBenchmark.h"
+
+namespace
+{
+	/// <summary>
+	/// Uniform over the whole type, so about 90% of the values have the maximum digit count.
+	/// </summary>
+	template<typename Int>
+	std::vector<Int> uniformValues(size_t valueCount)
+	{
+		std::mt19937_64 random(valueCount);
+		std::vector<Int> values(valueCount);
+		for (Int& value : values)
+		{
+			value = static_cast<Int>(random());
+		}
+		return values;
+	}
+
+	/// <summary>
+	/// Digit count uniform from 1 to the type's maximum, then uniform within it, with a random sign.
+	///		The digit count, and with it the loop trip count and the kernel picked, changes unpredictably from value to value.
+	/// </summary>
+	template<typename Int>
+	std::vector<Int> logUniformValues(size_t valueCount)
+	{
+		constexpr uint64_t maxMagnitude = static_cast<uint64_t>(std::numeric_limits<Int>::max());
+		const size_t maxDigits = decimalDigitCount(maxMagnitude);
+
+		std::mt19937_64 random(valueCount + 1);
+		std::vector<Int> values(valueCount);
+		for (Int& value : values)
+		{
+			const size_t digitCount = 1 + static_cast<size_t>(random() % maxDigits);
+			const uint64_t lowest = digitCount == 1 ? 0 : wideTensLookupTable[digitCount - 1];
+			const uint64_t highest = std::min(wideTensLookupTable[digitCount] - 1, maxMagnitude);
+			const uint64_t magnitude = lowest + random() % (highest - lowest + 1);
+			value = static_cast<Int>((random() & 1) != 0 ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude));
+		}
+		return values;
+	}
+
+	/// <summary>
+	/// medianTimePerCall of a pass of kernel over input, per value, with the results in output.
+	/// </summary>
+	template<typename Int, typename Kernel>
+	double nanosecondsPerValue(const std::vector<Int>& input, std::vector<Int>& output, Kernel&& kernel)
+	{
+		const auto pass = [&]()
+		{
+			for (size_t index = 0; index < input.size(); ++index)
+			{
+				output[index] = kernel(input[index]);
+			}
+		};
+
+		return medianTimePerCall(pass).count() / static_cast<double>(input.size());
+	}
+
+	struct NamedKernel32
+	{
+		std::string_view name;
+		int32_t(*func)(int32_t);
+	};
+
+	struct NamedKernel64
+	{
+		std::string_view name;
+		int64_t(*func)(int64_t);
+	};
+
+	/// <summary>
+	/// One row per kernel, one column per distribution; the first kernel's output is the one the others have to match.
+	/// </summary>
+	template<typename Int, typename NamedKernel, size_t KernelCount>
+	bool printComparison(std::string_view title, const std::array<NamedKernel, KernelCount>& kernels, size_t valueCount)
+	{
+		const std::vector<Int> distributions[] = { uniformValues<Int>(valueCount), logUniformValues<Int>(valueCount) };
+
+		std::println("{}", title);
+		std::println("{:<20} {:>12} {:>12}", "ns per value", "uniform", "log-uniform");
+
+		bool allMatch = true;
+		std::array<std::vector<Int>, std::size(distributions)> expected;
+		std::vector<Int> output(valueCount);
+		for (const NamedKernel& kernel : kernels)
+		{
+			std::print("{:<20}", kernel.name);
+			for (size_t distribution = 0; distribution < std::size(distributions); ++distribution)
+			{
+				const double time = nanosecondsPerValue(distributions[distribution], output, kernel.func);
+				if (expected[distribution].empty())
+				{
+					expected[distribution] = output;
+				}
+				const bool matches = output == expected[distribution];
+				allMatch &= matches;
+				std::print(" {:>10.3f}ns{}", time, matches ? "" : "  !!!! OUTPUT DIFFERS");
+			}
+			std::print("\n");
+		}
+		std::print("\n");
+		return allMatch;
+	}
+
+	int64_t reverseDigitsChecked64(int64_t value) noexcept
+	{
+		return reverseDigitsChecked(value);
+	}
+}
+
+int runUnrolledBenchmark(size_t valueCount)
+{
+	valueCount = std::max<size_t>(valueCount, 1);
+	std::println("{:L} values per distribution, median of {} passes\n", valueCount, benchmarkSampleCount);
+
+	const std::array<NamedKernel32, 3> kernels32 = { {
+		{ "Modulo Lookup", &reverseDigits_ModuloLookup },
+		{ "Modulo Multiply", &reverseDigits_ModuloMultiply },
+		{ "Unrolled", &reverseDigits_Unrolled },
+	} };
+	bool allMatch = printComparison<int32_t>("int32_t, 1 to 10 digits", kernels32, valueCount);
+
+	const std::array<NamedKernel64, 2> kernels64 = { {
+		{ "Looped", &reverseDigitsChecked64 },
+		{ "Unrolled", &reverseDigits_Unrolled },
+	} };
+	allMatch &= printComparison<int64_t>("int64_t, 1 to 19 digits", kernels64, valueCount);
+
+	// The extremes of each width, which the random samples are unlikely to hit
+	for (const int64_t value : { std::numeric_limits<int64_t>::lowest(), std::numeric_limits<int64_t>::max(), int64_t(0), int64_t(-1),
+		int64_t(1'000'000'000'000'000'000), int64_t(-9'000'000'000'000'000'001), int64_t(8'085'774'586'302'733'229) })
+	{
+		allMatch &= reverseDigits_Unrolled(value) == reverseDigitsChecked(value);
+	}
+
+	if (!allMatch)
+	{
+		std::println("!!!! WRONG RESULTS");
+		return 1;
+	}
+	return 0;
+}
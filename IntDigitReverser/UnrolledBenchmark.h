@@ -0,0 +1,16 @@
+/*******************************************************************
+* Digit count dispatched unrolled kernels against the looped ones.
+*******************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/// <summary>
+/// Times reverseDigits_Unrolled against reverseDigits_ModuloLookup and reverseDigits_ModuloMultiply on uniformly
+///		distributed int32_t values (nearly all 9 or 10 digits) and on log-uniform ones (every digit count equally
+///		likely), then the int64_t overload against the looped reverseDigitsChecked&lt;int64_t&gt; the same way.
+/// </summary>
+/// <param name="valueCount">Values per distribution</param>
+/// <returns>Non-zero if the kernels disagree</returns>
+int runUnrolledBenchmark(size_t valueCount);
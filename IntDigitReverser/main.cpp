@@ -6,23 +6,33 @@
 import std;
 
 #include <cstdint>
-#include <cassert>
 
 #if defined(_MSC_VER)
 // Define a FORCEINLINE macro so we can try to minimize as much of the timing function boilerplate overhead as possible
 #define FORCEINLINE __forceinline
 #elif defined(__GNUG__)
-// I think this works, but don't feel like checking
-#define FORCEINLINE __attribute__((always_inline))
+// always_inline is only honored on functions that are also declared inline
+#define FORCEINLINE inline __attribute__((always_inline))
 #else
 #define FORCEINLINE inline
 #endif
 
-constexpr std::string_view longestPossibleIntString = "-2147483648";
-
-// Global buffer used for one of the string flip approaches
-// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
-auto sharedCharArrayBuffer = std::make_unique<char[]>(longestPossibleIntString.size());
+#include "AsyncReverserBenchmark.h"
+#include "ColumnFileReverser.h"
+#include "FixedWidthTextFile.h"
+#include "PalindromeBenchmark.h"
+#include "ParallelReverseBenchmark.h"
+#include "PreimageQuery.h"
+#include "RangeStatsQuery.h"
+#include "ReversalCacheBenchmark.h"
+#include "ReversalService.h"
+#include "ReverseAndAddSweep.h"
+#include "ReverseDigits.h"
+#include "SelfTest.h"
+#include "SharedRingBenchmark.h"
+#include "TextFileReverser.h"
+#include "ThreadAffinity.h"
+#include "UnrolledBenchmark.h"
 
 struct TimingResult
 {
@@ -38,326 +48,637 @@ struct TimingResult
 };
 
 
+
+
 /// <summary>
-/// Use (value / tens_place % 10) to extract the digits from the integer.
-///		This version uses an array to look up the possible 10s places instead of using multiplication or division.
+/// Outputs the results of the various methods to the console for eyeballing.
+///		Parity is enforced by runSelfTest, which also survives NDEBUG.
 /// </summary>
 /// <param name="value"></param>
-/// <returns></returns>
-constexpr int32_t reverseDigits_ModuloLookup(int32_t value) noexcept
+void validateDifferentOutputs(int32_t value) noexcept
 {
-	constexpr uint64_t tensLookupTable[] = {
-		1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000
-	};
-	constexpr size_t tensLookupCount = std::size(tensLookupTable);
+	const int32_t charStackResult = reverseDigits_CharArrayStack(value);
+	const int32_t charStackAlgoResult = reverseDigits_CharArrayStack_RangeAlgorithm(value);
+	const int32_t charHeapSharedResult = reverseDigits_CharArrayHeap_SharedAlloc(value);
+	const int32_t charHeapAllocResult = reverseDigits_CharArrayHeap_AlwaysAlloc(value);
+	const int32_t moduloLookupResult = reverseDigits_ModuloLookup(value);
+	const int32_t moduloMultiplyResult = reverseDigits_ModuloMultiply(value);
+	const int32_t unrolledResult = reverseDigits_Unrolled(value);
+	const int32_t doubleResult = reverseDigits_DoubleReciprocal(value);
 
-	if (value < 10 && value > -10)
-	{
-		return value;
-	}
 
-	const bool negate = value < 0;
-	// Store the value in uint64 to handle overflow without branching in the main loop
-	const uint64_t sourceValue = static_cast<uint64_t>(negate ? -static_cast<int64_t>(value) : static_cast<int64_t>(value));
+	std::println("[Char Stack     ] Inverting {} = {}", value, charStackResult);
+	std::println("[Char Stack Algo] Inverting {} = {}", value, charStackAlgoResult);
+	std::println("[Char Shared    ] Inverting {} = {}", value, charHeapSharedResult);
+	std::println("[Char Alloc     ] Inverting {} = {}", value, charHeapAllocResult);
+	std::println("[Modulo Lookup  ] Inverting {} = {}", value, moduloLookupResult);
+	std::println("[Modulo Multiply] Inverting {} = {}", value, moduloMultiplyResult);
+	std::println("[Unrolled       ] Inverting {} = {}", value, unrolledResult);
+	std::println("[Double Recip   ] Inverting {} = {}", value, doubleResult);
+	std::print("\n");
+}
 
-	// Should never be less than 10 given the above early return
-	size_t largestIndex = 1;
-	while (largestIndex < tensLookupCount && sourceValue >= tensLookupTable[largestIndex])
-	{
-		++largestIndex;
-	}
-	// Will always overshoot by 1
-	--largestIndex;
+/// <summary>
+/// How the timing loop feeds values into the function under test.
+/// </summary>
+enum class TimingMode
+{
+	// Every call gets an independent input, so out-of-order execution is free to overlap consecutive calls
+	Throughput,
+	// Every call's input depends on the previous call's output, so calls execute back-to-back
+	Latency,
+};
 
-	// If a power of 10, will always result in 1
-	if (sourceValue == tensLookupTable[largestIndex])
+constexpr std::string_view toString(TimingMode mode) noexcept
+{
+	switch (mode)
 	{
-		return negate ? -1 : 1;
+	case TimingMode::Throughput: return "Throughput";
+	case TimingMode::Latency: return "Latency";
 	}
+	return "Unknown";
+}
 
-	uint64_t result = 0;
+// Written once per timing cycle so the compiler can't discard the results of the timed calls
+volatile int32_t timingSink = 0;
 
-	const size_t halfIndex = (largestIndex + 1) / 2;
-	for (size_t index = 0; index < halfIndex; ++index)
+template<int32_t(*Func)(int32_t), TimingMode Mode, int32_t ValueRange, size_t RepeatCount>
+FORCEINLINE TimingResult timeFunction()
+{
+	using namespace std::chrono_literals;
+
+	auto managedTimes = std::make_unique<std::chrono::milliseconds[]>(RepeatCount);
+	const auto timingList = std::span<std::chrono::milliseconds>(managedTimes.get(), RepeatCount);
+
+	TimingResult result = {};
+	for (size_t repeatIndex = 0; repeatIndex < RepeatCount; ++repeatIndex)
 	{
-		const size_t upperIndex = largestIndex - index;
+		std::print(".");
 
-		const uint64_t lowerTens = tensLookupTable[index];
-		const uint64_t upperTens = tensLookupTable[upperIndex];
+		int32_t accumulator = 0;
 
-		const uint64_t lower = (sourceValue / lowerTens) % 10;
-		const uint64_t upper = (sourceValue / upperTens) % 10;
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		for (int32_t testValue = -ValueRange; testValue <= ValueRange; ++testValue)
+		{
+			if constexpr (Mode == TimingMode::Throughput)
+			{
+				// The xor only depends on the call result, never the other way around,
+				//	so the next call can start before this one finishes.
+				accumulator ^= Func(testValue);
+			}
+			else
+			{
+				// Fold the low bit of the previous result into the next input. This keeps the inputs spread over the
+				//	same range as throughput mode (instead of collapsing into a Func(Func(x)) cycle)
+				//	while forcing each call to wait on the one before it.
+				accumulator = Func(testValue ^ (accumulator & 1));
+			}
+		}
+		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
 
-		result += (lower * upperTens) + (upper * lowerTens);
-	}
+		timingSink = accumulator;
 
-	// For an odd number of digits (even index due to 0-based indexing), copy the middle digit over
-	if ((largestIndex & 1) == 0)
-	{
-		const uint64_t tens = tensLookupTable[halfIndex];
-		result += ((sourceValue / tens) % 10) * tens;
+		timingList[repeatIndex] = duration;
+		result.mean += duration;
 	}
 
-	if (result > std::numeric_limits<int32_t>::max())
-	{
-		return 0;
-	}
+	std::ranges::sort(timingList);
 
-	return negate ? -static_cast<int32_t>(result) : static_cast<int32_t>(result);
+	result.min = timingList[0];
+	result.max = timingList[RepeatCount -1];
+	result.median = timingList[RepeatCount /2];
+	result.mean /= RepeatCount;
+	std::print("\n");
+	return result;
 }
 
-
 /// <summary>
-/// Use (value / tens_place % 10) to extract the digits from the integer.
-///		This version uses multiplication / division to find the highest 10s place.
+/// reverseDigits_Policy folded into an int32_t so every policy fits the timing loop: the halves of a widened
+///		result xored together, -1 for an error.
 /// </summary>
 /// <param name="value"></param>
 /// <returns></returns>
-constexpr int32_t reverseDigits_ModuloMultiply(int32_t value) noexcept
+template<ReversalOverflowPolicy Policy>
+int32_t reverseDigits_PolicyTimed(int32_t value) noexcept
 {
-	if (value < 10 && value > -10)
+	const typename Policy::Result result = reverseDigits_Policy<Policy>(value);
+	if constexpr (std::is_same_v<typename Policy::Result, int64_t>)
 	{
-		return value;
+		return static_cast<int32_t>(result ^ (result >> 32));
 	}
-
-	const bool negate = value < 0;
-	const uint64_t sourceValue = static_cast<uint64_t>(negate ? -static_cast<int64_t>(value) : static_cast<int64_t>(value));
-
-	// Should never drop below 10 given the early return at the top
-	uint64_t upperTens = 10;
-	while (sourceValue >= upperTens)
+	else if constexpr (std::is_same_v<typename Policy::Result, int32_t>)
 	{
-		upperTens *= 10;
+		return result;
 	}
-	// Will overshoot by one
-	upperTens /= 10;
-
-	// If a power of 10, will always result in 1
-	if (sourceValue == upperTens)
+	else
 	{
-		return negate ? -1 : 1;
+		return result.value_or(-1);
 	}
+}
 
-	uint64_t result = 0;
-
-	uint64_t lowerTens = 1;
-	for (; lowerTens < upperTens; lowerTens *= 10, upperTens /= 10)
-	{
-		const uint64_t lower = (sourceValue / lowerTens) % 10;
-		const uint64_t upper = (sourceValue / upperTens) % 10;
+struct VariantTimingResult
+{
+	TimingResult throughput = {};
+	TimingResult latency = {};
+};
 
-		result += (lower * upperTens) + (upper * lowerTens);
-	}
+template<int32_t(*Func)(int32_t), int32_t ValueRange, size_t RepeatCount>
+VariantTimingResult timeVariant(std::string_view name)
+{
+	VariantTimingResult result = {};
 
-	// The above loop will end if lowerTens == upperTens; we don't want to treat that the same as swapping the digits
-	if (lowerTens == upperTens)
-	{
-		result += ((sourceValue / lowerTens) % 10) * lowerTens;
-	}
+	std::println("Timing '{}' function ({})...", name, toString(TimingMode::Throughput));
+	result.throughput = timeFunction<Func, TimingMode::Throughput, ValueRange, RepeatCount>();
 
-	if (result > std::numeric_limits<int32_t>::max())
-	{
-		return 0;
-	}
+	std::println("Timing '{}' function ({})...", name, toString(TimingMode::Latency));
+	result.latency = timeFunction<Func, TimingMode::Latency, ValueRange, RepeatCount>();
 
-	return negate ? -static_cast<int32_t>(result) : static_cast<int32_t>(result);
+	return result;
 }
 
 /// <summary>
-/// Make a character buffer on the stack and reverse the character there.
-///		Using a manual swap loop instead of a standard algorithm
+/// Throughput timing of a batch kernel over the whole value range at once.
+///		The input array is built before timing starts; there's no latency mode since a batch has no chain between elements.
 /// </summary>
-/// <param name="value"></param>
+/// <param name="func">Callable as void(std::span&lt;const int32_t&gt; input, std::span&lt;int32_t&gt; output)</param>
 /// <returns></returns>
-int32_t reverseDigits_CharArrayStack(int32_t value) noexcept
+template<int32_t ValueRange, size_t RepeatCount, typename BatchFunc>
+TimingResult timeBatchFunction(const BatchFunc& func)
 {
-	if (value < 10 && value > -10)
-	{
-		return value;
-	}
+	constexpr size_t valueCount = static_cast<size_t>(ValueRange) * 2 + 1;
 
-	// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
-	char buffer[longestPossibleIntString.size()];
+	std::vector<int32_t> input(valueCount);
+	std::ranges::iota(input, -ValueRange);
+	std::vector<int32_t> output(valueCount);
 
-	const char* const endPtr = std::format_to(buffer, "{}", value);
+	auto managedTimes = std::make_unique<std::chrono::milliseconds[]>(RepeatCount);
+	const auto timingList = std::span<std::chrono::milliseconds>(managedTimes.get(), RepeatCount);
 
-	const ptrdiff_t count = std::distance((const char*)buffer, endPtr);
+	TimingResult result = {};
+	for (size_t repeatIndex = 0; repeatIndex < RepeatCount; ++repeatIndex)
+	{
+		std::print(".");
 
-	const size_t offsetEnd = value < 0 ? 0 : 1;
-	const size_t skip = 1 - offsetEnd;
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		func(input, output);
+		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
 
-	const size_t halfCount = (count + skip) / 2;
+		timingSink = output[repeatIndex % valueCount];
 
-	for (size_t index = skip; index < halfCount; ++index)
-	{
-		std::swap(buffer[index], buffer[count - index - offsetEnd]);
+		timingList[repeatIndex] = duration;
+		result.mean += duration;
 	}
 
-	int32_t result = 0;
-	std::from_chars(buffer, endPtr, result);
+	std::ranges::sort(timingList);
 
+	result.min = timingList[0];
+	result.max = timingList[RepeatCount - 1];
+	result.median = timingList[RepeatCount / 2];
+	result.mean /= RepeatCount;
+	std::print("\n");
 	return result;
 }
 
+void printVariantResult(std::string_view paddedName, const VariantTimingResult& result)
+{
+	std::println("{} Throughput ({})", paddedName, result.throughput.toString());
+	std::println("{} Latency    ({})", paddedName, result.latency.toString());
+}
+
+void printVariantCsv(std::string_view name, const VariantTimingResult& result)
+{
+	// csv,<variant>,<mode>,<mean ms>,<median ms>,<min ms>,<max ms>
+	std::println("csv,{},{},{},{},{},{}", name, toString(TimingMode::Throughput), result.throughput.mean.count(), result.throughput.median.count(), result.throughput.min.count(), result.throughput.max.count());
+	std::println("csv,{},{},{},{},{},{}", name, toString(TimingMode::Latency), result.latency.mean.count(), result.latency.median.count(), result.latency.min.count(), result.latency.max.count());
+}
+
 /// <summary>
-/// Make a character buffer on the stack and reverse the character there.
-///		Using the std::ranges::reverse algorithm
+/// Single threaded timing of every variant in both throughput and latency modes.
 /// </summary>
-/// <param name="value"></param>
+/// <param name="printCsv">Also print the results as csv lines after the table</param>
 /// <returns></returns>
-int32_t reverseDigits_CharArrayStack_RangeAlgorithm(int32_t value) noexcept
+template<int32_t ValueRange, size_t RepeatCount>
+int runTimingBenchmark(bool printCsv)
 {
-	if (value < 10 && value > -10)
+	std::println("\nTiming functions {0}x over range [-{1:L}, {1:L}] in both throughput and latency modes. The functions will be called 1x per iteration", RepeatCount, ValueRange);
+	std::println("Beginning function timing...\n");
+
+
+
+	const VariantTimingResult charArrayStackResult = timeVariant<&reverseDigits_CharArrayStack, ValueRange, RepeatCount>("Char Array Stack");
+
+	const VariantTimingResult charArrayStackAlgoResult = timeVariant<&reverseDigits_CharArrayStack_RangeAlgorithm, ValueRange, RepeatCount>("Char Array Stack - Range Algorithm");
+
+	const VariantTimingResult charArrayHeapSharedResult = timeVariant<&reverseDigits_CharArrayHeap_SharedAlloc, ValueRange, RepeatCount>("Char Array Heap - Shared Alloc");
+
+	const VariantTimingResult charArrayHeapAllocResult = timeVariant<&reverseDigits_CharArrayHeap_AlwaysAlloc, ValueRange, RepeatCount>("Char Array Heap - Always Alloc");
+
+	const VariantTimingResult moduloLookupResult = timeVariant<&reverseDigits_ModuloLookup, ValueRange, RepeatCount>("Modulo Lookup");
+
+	const VariantTimingResult moduloMultiplyResult = timeVariant<&reverseDigits_ModuloMultiply, ValueRange, RepeatCount>("Modulo Multiply");
+
+	const VariantTimingResult unrolledResult = timeVariant<&reverseDigits_Unrolled, ValueRange, RepeatCount>("Unrolled");
+
+	const VariantTimingResult doubleReciprocalResult = timeVariant<&reverseDigits_DoubleReciprocal, ValueRange, RepeatCount>("Double Reciprocal");
+
+	// The same int64_t reversal under each overflow policy, to show what telling overflow apart costs
+	const std::pair<std::string_view, VariantTimingResult> policyResults[] = {
+		{ "Policy Zero", timeVariant<&reverseDigits_PolicyTimed<OverflowToZero>, ValueRange, RepeatCount>("Policy Zero") },
+		{ "Policy Saturate", timeVariant<&reverseDigits_PolicyTimed<OverflowSaturate>, ValueRange, RepeatCount>("Policy Saturate") },
+		{ "Policy Wrap", timeVariant<&reverseDigits_PolicyTimed<OverflowWrap>, ValueRange, RepeatCount>("Policy Wrap") },
+		{ "Policy Widen", timeVariant<&reverseDigits_PolicyTimed<OverflowWiden>, ValueRange, RepeatCount>("Policy Widen") },
+		{ "Policy Expected", timeVariant<&reverseDigits_PolicyTimed<OverflowExpected>, ValueRange, RepeatCount>("Policy Expected") },
+	};
+
+	std::vector<std::pair<std::string_view, TimingResult>> batchResults;
+	for (const BatchReversalVariant& variant : batchReversalVariants)
+	{
+		if (variant.isSupported())
+		{
+			std::println("Timing '{}' function ({})...", variant.name, toString(TimingMode::Throughput));
+			batchResults.emplace_back(variant.name, timeBatchFunction<ValueRange, RepeatCount>(variant.func));
+		}
+	}
+
+	// The same batch with the overflow bitmask filled in, to show what the extra movemask and store cost
+	std::vector<uint64_t> overflowBits(overflowMaskWords(static_cast<size_t>(ValueRange) * 2 + 1));
+	for (const CheckedBatchReversalVariant& variant : checkedBatchReversalVariants)
 	{
-		return value;
+		if (variant.isSupported())
+		{
+			std::println("Timing '{}' function ({})...", variant.name, toString(TimingMode::Throughput));
+			const auto reverseChecked = [&overflowBits, func = variant.func](std::span<const int32_t> input, std::span<int32_t> output)
+			{
+				timingSink = static_cast<int32_t>(func(input, output, overflowBits));
+			};
+			batchResults.emplace_back(variant.name, timeBatchFunction<ValueRange, RepeatCount>(reverseChecked));
+		}
 	}
 
-	// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
-	char buffer[longestPossibleIntString.size()];
+	std::println("\n=====================================");
+	std::println("  Results");
+	std::println("=====================================\n");
 
-	char* const endPtr = std::format_to(buffer, "{}", value);
+	
+	printVariantResult("Char Stack              ", charArrayStackResult);
+	printVariantResult("Char Stack - Range Algo ", charArrayStackAlgoResult);
+	printVariantResult("Char Heap - Shared Alloc", charArrayHeapSharedResult);
+	printVariantResult("Char Heap - Always Alloc", charArrayHeapAllocResult);
+	printVariantResult("Modulo Lookup           ", moduloLookupResult);
+	printVariantResult("Modulo Multiply         ", moduloMultiplyResult);
+	printVariantResult("Unrolled                ", unrolledResult);
+	printVariantResult("Double Reciprocal       ", doubleReciprocalResult);
+	for (const auto& [name, result] : policyResults)
+	{
+		printVariantResult(std::format("{:<24}", name), result);
+	}
+	for (const auto& [name, timing] : batchResults)
+	{
+		std::println("{:<24} Throughput ({})", name, timing.toString());
+	}
+	std::println("(Batch dispatch picked {})", toString(batchSimdLevel()));
 
-	const std::span<char> digitView = std::span<char>(value < 0 ? buffer+1 : buffer, endPtr);
-	std::ranges::reverse(digitView);
+	std::print("\n");
+	std::println("## NOTE: These times are not representative of a single function call, but 1 function call per iteration over a negative -> positive value range.");
+	std::println("## Throughput lets independent calls overlap; latency chains each call's input off the previous call's output.");
+	std::println("## As such, the functions have been called {:L} times per timing cycle.", (static_cast<uint64_t>(ValueRange) * 2ull + 1ull));
 
-	int32_t result = 0;
-	std::from_chars(buffer, endPtr, result);
+	if (printCsv)
+	{
+		// Machine readable copy of the results, used by cmake/PgoReport.cmake
+		std::print("\n");
+		printVariantCsv("Char Stack", charArrayStackResult);
+		printVariantCsv("Char Stack - Range Algo", charArrayStackAlgoResult);
+		printVariantCsv("Char Heap - Shared Alloc", charArrayHeapSharedResult);
+		printVariantCsv("Char Heap - Always Alloc", charArrayHeapAllocResult);
+		printVariantCsv("Modulo Lookup", moduloLookupResult);
+		printVariantCsv("Modulo Multiply", moduloMultiplyResult);
+		printVariantCsv("Unrolled", unrolledResult);
+		printVariantCsv("Double Reciprocal", doubleReciprocalResult);
+		for (const auto& [name, result] : policyResults)
+		{
+			printVariantCsv(name, result);
+		}
+		for (const auto& [name, timing] : batchResults)
+		{
+			std::println("csv,{},{},{},{},{},{}", name, toString(TimingMode::Throughput), timing.mean.count(), timing.median.count(), timing.min.count(), timing.max.count());
+		}
+	}
 
-	return result;
+	return 0;
 }
 
 
+
+
+
+
+
+
+
+
+// Every worker folds its accumulator in here once it's done, so the compiler can't discard the timed calls
+std::atomic<int32_t> parallelTimingSink = 0;
+
 /// <summary>
-/// Use a character buffer on the heap and reverse the character there.
-///		Uses a shared buffer that's re-used between runs.
+/// Throughput timing with the value range split evenly across threadCount threads, each pinned to its own core.
+///		Only the time between releasing the workers and the last one finishing is measured; thread creation and pinning aren't.
 /// </summary>
-/// <param name="value"></param>
+/// <param name="cores">Cores to pin to; worker N runs on cores[N]</param>
+/// <param name="threadCount"></param>
 /// <returns></returns>
-int32_t reverseDigits_CharArrayHeap_SharedAlloc(int32_t value) noexcept
+template<int32_t(*Func)(int32_t), int32_t ValueRange, size_t RepeatCount>
+TimingResult timeFunctionParallel(std::span<const size_t> cores, size_t threadCount)
 {
-	if (value < 10 && value > -10)
+	constexpr int64_t totalValues = static_cast<int64_t>(ValueRange) * 2 + 1;
+
+	auto managedTimes = std::make_unique<std::chrono::milliseconds[]>(RepeatCount);
+	const auto timingList = std::span<std::chrono::milliseconds>(managedTimes.get(), RepeatCount);
+
+	TimingResult result = {};
+	for (size_t repeatIndex = 0; repeatIndex < RepeatCount; ++repeatIndex)
 	{
-		return value;
-	}
+		std::print(".");
+
+		std::latch readyLatch(static_cast<ptrdiff_t>(threadCount));
+		std::latch startLatch(1);
+
+		std::vector<std::jthread> workers;
+		workers.reserve(threadCount);
+		for (size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+		{
+			const int32_t beginValue = static_cast<int32_t>(-ValueRange + totalValues * static_cast<int64_t>(threadIndex) / static_cast<int64_t>(threadCount));
+			const int32_t endValue = static_cast<int32_t>(-ValueRange + totalValues * static_cast<int64_t>(threadIndex + 1) / static_cast<int64_t>(threadCount));
+			const size_t core = cores[threadIndex];
+
+			workers.emplace_back([beginValue, endValue, core, &readyLatch, &startLatch]()
+			{
+				pinCurrentThreadToCore(core);
 
-	char* const buffer = sharedCharArrayBuffer.get();
+				readyLatch.count_down();
+				startLatch.wait();
 
-	char* const endPtr = std::format_to(buffer, "{}", value);
+				int32_t accumulator = 0;
+				for (int32_t testValue = beginValue; testValue < endValue; ++testValue)
+				{
+					accumulator ^= Func(testValue);
+				}
 
-	const std::span<char> digitView = std::span<char>(value < 0 ? buffer + 1 : buffer, endPtr);
-	std::ranges::reverse(digitView);
+				parallelTimingSink.fetch_xor(accumulator, std::memory_order_relaxed);
+			});
+		}
+
+		readyLatch.wait();
 
-	int32_t result = 0;
-	std::from_chars(buffer, endPtr, result);
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		startLatch.count_down();
+		workers.clear();
+		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
 
+		timingList[repeatIndex] = duration;
+		result.mean += duration;
+	}
+
+	std::ranges::sort(timingList);
+
+	result.min = timingList[0];
+	result.max = timingList[RepeatCount - 1];
+	result.median = timingList[RepeatCount / 2];
+	result.mean /= RepeatCount;
+	std::print("\n");
 	return result;
 }
 
-
 /// <summary>
-/// Use a character buffer on the heap and reverse the character there.
-///		Uses a unique character buffere that is allocated every time this is called.
+/// Times a function at 1, 2, 4, ... threads up to every available core and prints the aggregate throughput
+///		and the scaling efficiency relative to a single thread (1.0 means perfectly linear).
 /// </summary>
-/// <param name="value"></param>
-/// <returns></returns>
-int32_t reverseDigits_CharArrayHeap_AlwaysAlloc(int32_t value) noexcept
+/// <param name="name"></param>
+/// <param name="cores"></param>
+template<int32_t(*Func)(int32_t), int32_t ValueRange, size_t RepeatCount>
+void printScaling(std::string_view name, std::span<const size_t> cores)
 {
-	if (value < 10 && value > -10)
+	constexpr double callsPerCycle = static_cast<double>(ValueRange) * 2.0 + 1.0;
+
+	std::vector<size_t> threadCounts;
+	for (size_t threadCount = 1; threadCount < cores.size(); threadCount *= 2)
 	{
-		return value;
+		threadCounts.push_back(threadCount);
 	}
+	threadCounts.push_back(cores.size());
 
-	// Don't do size+1 as we don't care about the null terminator; format_to doesn't add it, and we process everything in ranges
-	auto managedPtr = std::make_unique<char[]>(longestPossibleIntString.size());
+	std::println("Scaling '{}' function...", name);
 
-	char* const buffer = managedPtr.get();
+	double singleThreadCallsPerSecond = 0.0;
+	for (const size_t threadCount : threadCounts)
+	{
+		const TimingResult timing = timeFunctionParallel<Func, ValueRange, RepeatCount>(cores, threadCount);
+
+		// Clamp to 1ms so a too-small range doesn't divide by zero
+		const double seconds = static_cast<double>(std::max<int64_t>(timing.median.count(), 1)) / 1'000.0;
+		const double callsPerSecond = callsPerCycle / seconds;
+		if (threadCount == 1)
+		{
+			singleThreadCallsPerSecond = callsPerSecond;
+		}
+		const double efficiency = callsPerSecond / (singleThreadCallsPerSecond * static_cast<double>(threadCount));
 
-	char* const endPtr = std::format_to(buffer, "{}", value);
+		std::println("  {:>3} threads: {:>10.2f} Mcalls/s, efficiency {:.2f} ({})", threadCount, callsPerSecond / 1'000'000.0, efficiency, timing.toString());
+	}
+	std::print("\n");
+}
 
-	const std::span<char> digitView = std::span<char>(value < 0 ? buffer + 1 : buffer, endPtr);
-	std::ranges::reverse(digitView);
+/// <summary>
+/// Parallel scaling mode: splits the value range across pinned std::jthreads and times every variant from 1 to all cores.
+/// </summary>
+/// <returns></returns>
+int runScalingBenchmark()
+{
+	constexpr int32_t valueTestRange = 20'000'000;
+	constexpr size_t repeatCount = 5;
 
-	int32_t result = 0;
-	std::from_chars(buffer, endPtr, result);
+	const std::vector<size_t> cores = availableCores();
 
-	return result;
+	std::println("\nScaling functions {0}x over range [-{1:L}, {1:L}] on up to {2} cores. The functions will be called 1x per value", repeatCount, valueTestRange, cores.size());
+	std::println("Beginning scaling timing...\n");
+
+	printScaling<&reverseDigits_CharArrayStack, valueTestRange, repeatCount>("Char Array Stack", cores);
+	printScaling<&reverseDigits_CharArrayStack_RangeAlgorithm, valueTestRange, repeatCount>("Char Array Stack - Range Algorithm", cores);
+	printScaling<&reverseDigits_CharArrayHeap_SharedAlloc, valueTestRange, repeatCount>("Char Array Heap - Shared Alloc", cores);
+	printScaling<&reverseDigits_CharArrayHeap_AlwaysAlloc, valueTestRange, repeatCount>("Char Array Heap - Always Alloc", cores);
+	printScaling<&reverseDigits_ModuloLookup, valueTestRange, repeatCount>("Modulo Lookup", cores);
+	printScaling<&reverseDigits_ModuloMultiply, valueTestRange, repeatCount>("Modulo Multiply", cores);
+	printScaling<&reverseDigits_Unrolled, valueTestRange, repeatCount>("Unrolled", cores);
+	printScaling<&reverseDigits_DoubleReciprocal, valueTestRange, repeatCount>("Double Reciprocal", cores);
+
+	return 0;
 }
 
 
+struct Mismatch
+{
+	int32_t value = 0;
+	int32_t expected = 0;
+	int32_t actual = 0;
+};
+
 /// <summary>
-/// Checks the outputs of the various methods and outputs them to the console.
-///		Weak form of testing the functions to ensure parity.
+/// Runs every int32_t through reverseBlock on all available cores and compares it against reverseDigits_Reference.
+///		The range is handed out in fixed size chunks so the slower (longer) values don't leave cores idle at the end,
+///		and each chunk is fed to reverseBlock a block at a time so batch kernels see realistic input sizes.
 /// </summary>
-/// <param name="value"></param>
-void validateDifferentOutputs(int32_t value) noexcept
+/// <param name="reverseBlock">Called with an input and an output span of the same size, like the batch kernels</param>
+/// <param name="cores"></param>
+/// <param name="maxReported">Only the lowest maxReported mismatching values are kept; all of them are counted</param>
+/// <param name="mismatchCount">Total number of mismatches found</param>
+/// <returns>Lowest mismatching values, sorted</returns>
+template<typename ReverseBlock>
+std::vector<Mismatch> verifyExhaustive(const ReverseBlock& reverseBlock, std::span<const size_t> cores, size_t maxReported, uint64_t& mismatchCount)
 {
-	const int32_t charStackResult = reverseDigits_CharArrayStack(value);
-	const int32_t charStackAlgoResult = reverseDigits_CharArrayStack_RangeAlgorithm(value);
-	const int32_t charHeapSharedResult = reverseDigits_CharArrayHeap_SharedAlloc(value);
-	const int32_t charHeapAllocResult = reverseDigits_CharArrayHeap_AlwaysAlloc(value);
-	const int32_t moduloLookupResult = reverseDigits_ModuloLookup(value);
-	const int32_t moduloMultiplyResult = reverseDigits_ModuloMultiply(value);
+	constexpr uint64_t totalValues = 1ull << 32;
+	constexpr uint64_t chunkSize = 1ull << 22;
+	constexpr uint64_t chunkCount = totalValues / chunkSize;
+	constexpr size_t blockSize = 1 << 16;
 
+	std::atomic<uint64_t> nextChunk = 0;
+	std::atomic<uint64_t> totalMismatches = 0;
+	std::vector<std::vector<Mismatch>> threadMismatches(cores.size());
 
-	std::println("[Char Stack     ] Inverting {} = {}", value, charStackResult);
-	std::println("[Char Stack Algo] Inverting {} = {}", value, charStackAlgoResult);
-	std::println("[Char Shared    ] Inverting {} = {}", value, charHeapSharedResult);
-	std::println("[Char Alloc     ] Inverting {} = {}", value, charHeapAllocResult);
-	std::println("[Modulo Lookup  ] Inverting {} = {}", value, moduloLookupResult);
-	std::println("[Modulo Multiply] Inverting {} = {}", value, moduloMultiplyResult);
+	{
+		std::vector<std::jthread> workers;
+		workers.reserve(cores.size());
+		for (size_t threadIndex = 0; threadIndex < cores.size(); ++threadIndex)
+		{
+			workers.emplace_back([&, threadIndex]()
+			{
+				pinCurrentThreadToCore(cores[threadIndex]);
+
+				std::vector<Mismatch>& mismatches = threadMismatches[threadIndex];
+				uint64_t localMismatches = 0;
+
+				std::vector<int32_t> inputBlock(blockSize);
+				std::vector<int32_t> outputBlock(blockSize);
+
+				for (uint64_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1))
+				{
+					// Walk the chunks from lowest to highest signed value so each thread's list stays sorted
+					const int64_t chunkBegin = static_cast<int64_t>(std::numeric_limits<int32_t>::lowest()) + static_cast<int64_t>(chunk * chunkSize);
+					const int64_t chunkEnd = chunkBegin + static_cast<int64_t>(chunkSize);
+
+					for (int64_t blockBegin = chunkBegin; blockBegin < chunkEnd; blockBegin += blockSize)
+					{
+						std::ranges::iota(inputBlock, static_cast<int32_t>(blockBegin));
+						reverseBlock(std::span<const int32_t>(inputBlock), std::span<int32_t>(outputBlock));
+
+						for (size_t index = 0; index < blockSize; ++index)
+						{
+							const int32_t value = inputBlock[index];
+							const int32_t expected = reverseDigits_Reference(value);
+							const int32_t actual = outputBlock[index];
+							if (expected != actual)
+							{
+								++localMismatches;
+								if (mismatches.size() < maxReported)
+								{
+									mismatches.push_back({ value, expected, actual });
+								}
+							}
+						}
+					}
+
+					if (threadIndex == 0)
+					{
+						std::print(".");
+					}
+				}
+
+				totalMismatches.fetch_add(localMismatches, std::memory_order_relaxed);
+			});
+		}
+	}
 	std::print("\n");
 
-	// Validate that the results all match
-	assert(charStackResult == charStackAlgoResult);
-	assert(charStackAlgoResult == charHeapSharedResult);
-	assert(charHeapSharedResult == charHeapAllocResult);
-	assert(charHeapAllocResult == moduloLookupResult);
-	assert(moduloLookupResult == moduloMultiplyResult);
+	std::vector<Mismatch> result;
+	for (const std::vector<Mismatch>& mismatches : threadMismatches)
+	{
+		result.insert(result.end(), mismatches.begin(), mismatches.end());
+	}
+	std::ranges::sort(result, {}, &Mismatch::value);
+	if (result.size() > maxReported)
+	{
+		result.resize(maxReported);
+	}
+
+	mismatchCount = totalMismatches.load();
+	return result;
 }
 
-template<int32_t(*Func)(int32_t), int32_t ValueRange, size_t RepeatCount>
-FORCEINLINE TimingResult timeFunction()
+/// <summary>
+/// Verifies one kernel exhaustively and prints the outcome.
+/// </summary>
+/// <param name="name"></param>
+/// <param name="reverseBlock"></param>
+/// <param name="cores"></param>
+/// <param name="maxReported"></param>
+/// <returns>True if the kernel matched the reference on every input</returns>
+template<typename ReverseBlock>
+bool verifyAndReport(std::string_view name, const ReverseBlock& reverseBlock, std::span<const size_t> cores, size_t maxReported)
 {
-	using namespace std::chrono_literals;
+	std::println("Verifying '{}' function...", name);
 
-	auto managedTimes = std::make_unique<std::chrono::milliseconds[]>(RepeatCount);
-	const auto timingList = std::span<std::chrono::milliseconds>(managedTimes.get(), RepeatCount);
+	const auto startTime = std::chrono::high_resolution_clock::now();
+	uint64_t mismatchCount = 0;
+	const std::vector<Mismatch> mismatches = verifyExhaustive(reverseBlock, cores, maxReported, mismatchCount);
+	const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
 
-	TimingResult result = {};
-	for (size_t repeatIndex = 0; repeatIndex < RepeatCount; ++repeatIndex)
+	if (mismatchCount == 0)
 	{
-		std::print(".");
+		std::println("  OK in {}\n", duration);
+		return true;
+	}
 
-		const auto startTime = std::chrono::high_resolution_clock::now();
-		for (int32_t testValue = -ValueRange; testValue <= ValueRange; ++testValue)
-		{
-			// Reversing digits may result in a value that doesn't reverse back to the original (namely on values with trailing zeros)
-			//	Unless you reverse at least once before-hand (i.e. 120 reverses to 21 reverses to 12 an back to 21)
-			// We use this property to both validate the function results AND provide a means to avoid optimizing away the function calls.
-			const int32_t result = Func(testValue);
-			const int32_t doubleResult = Func(result);
-			const int32_t thirdResult = Func(doubleResult);
+	std::println("  !!!! {:L} mismatches in {}, lowest {}:", mismatchCount, duration, mismatches.size());
+	for (const Mismatch& mismatch : mismatches)
+	{
+		std::println("    reverse({}) expected {} but got {}", mismatch.value, mismatch.expected, mismatch.actual);
+	}
+	std::print("\n");
+	return false;
+}
+
+/// <summary>
+/// Exhaustive verification mode: every scalar and supported batch kernel against the reference over all 2^32 inputs.
+/// </summary>
+/// <param name="maxReported">Number of mismatches to print per variant</param>
+/// <returns>Non-zero if any variant disagreed with the reference</returns>
+int runExhaustiveVerification(size_t maxReported)
+{
+	const std::vector<size_t> cores = availableCores();
+
+	std::println("\nVerifying every int32_t against the reference on {} cores...\n", cores.size());
 
-			// This has to be here to make use of the values and ensure they're not optimized out.
-			if (result != thirdResult)
+	bool allPassed = true;
+	for (const ReversalVariant& variant : reversalVariants)
+	{
+		const auto reverseBlock = [func = variant.func](std::span<const int32_t> input, std::span<int32_t> output)
+		{
+			for (size_t index = 0; index < input.size(); ++index)
 			{
-				std::println("!!!! Failed to maintain the value");
+				output[index] = func(input[index]);
 			}
-		}
-		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
-
-		timingList[repeatIndex] = duration;
-		result.mean += duration;
+		};
+		allPassed &= verifyAndReport(variant.name, reverseBlock, cores, maxReported);
 	}
 
-	std::ranges::sort(timingList);
+	for (const BatchReversalVariant& variant : batchReversalVariants)
+	{
+		if (variant.isSupported())
+		{
+			allPassed &= verifyAndReport(variant.name, variant.func, cores, maxReported);
+		}
+	}
 
-	result.min = timingList[0];
-	result.max = timingList[RepeatCount -1];
-	result.median = timingList[RepeatCount /2];
-	result.mean /= RepeatCount;
-	std::print("\n");
-	return result;
+	return allPassed ? 0 : 1;
 }
 
 
@@ -368,76 +689,368 @@ FORCEINLINE TimingResult timeFunction()
 
 
 
-int main ()
+/// <summary>
+/// Parses a whole command line argument as a number, so "12x" or "abc" is rejected rather than read as 12 or 0.
+/// </summary>
+/// <param name="argument"></param>
+/// <param name="value">Only written on success</param>
+/// <returns></returns>
+template<typename Int>
+bool parseNumberArgument(const char* argument, Int& value) noexcept
 {
-	// These serve as both validation and process warmup
-	validateDifferentOutputs(-1'987'654'321);
-	validateDifferentOutputs(256);
-	validateDifferentOutputs(-256);
-	validateDifferentOutputs(12'345);
-	validateDifferentOutputs(25);
-	validateDifferentOutputs(-25);
-	validateDifferentOutputs(2);
-	validateDifferentOutputs(-2);
-	validateDifferentOutputs(1);
-	validateDifferentOutputs(-1);
-	validateDifferentOutputs(0);
-	validateDifferentOutputs(10);
-	validateDifferentOutputs(9);
-	validateDifferentOutputs(1'000'000'003);
-	validateDifferentOutputs(-1'000'000'003);
-	validateDifferentOutputs(std::numeric_limits<int32_t>::lowest());
-	validateDifferentOutputs(std::numeric_limits<int32_t>::lowest()+1);
-	validateDifferentOutputs(std::numeric_limits<int32_t>::max());
-	validateDifferentOutputs(std::numeric_limits<int32_t>::max()-1);
-	validateDifferentOutputs(2'000'000'008);
-	validateDifferentOutputs(-2'000'000'008);
-	validateDifferentOutputs(1'463'847'412);
-	validateDifferentOutputs(-1'463'847'412);
-
-
-	constexpr int32_t valueTestRange = 2'000'000;
-	constexpr size_t repeatCount = 10;
-
-	std::println("\nTiming functions {0}x over range [-{1:L}, {1:L}]. The functions will be called 3x per iteration", repeatCount, valueTestRange);
-	std::println("Beginning function timing...\n");
+	const char* const end = argument + std::strlen(argument);
+	const std::from_chars_result parsed = std::from_chars(argument, end, value);
+	return parsed.ec == std::errc() && parsed.ptr == end;
+}
 
+int main (int argc, char* argv[])
+{
+	// Modes:
+	//	(none)   single threaded throughput and latency timing
+	//	selftest only run the self test
+	//	scaling  multi-threaded scaling timing with pinned threads
+	//	train    short timing run, used as the PGO training workload
+	//	csv      longer timing run that also prints csv results
+	//	verify   exhaustive check of every int32_t against a reference, optionally followed by how many mismatches to print (default 16)
+	//	reverse-text <input> <output>     reverse a file of newline separated integers
+	//	reverse-text-inplace <in> <out>   same, but reversing the text in place without converting to binary
+	//	bench-text [count]                time the in place text pipeline against parse + reverse + format (default 10M values)
+	//	generate-text <output> [count]    write count random integers (default 10M) for reverse-text
+	//	reverse-fixed <in> <out> <width>  reverse exactly width digits of every line, keeping the zero padding
+	//	generate-fixed <output> [count] [width]  write count random zero-padded IDs (default 10M of 8 digits) for reverse-fixed
+	//	bench-fixed [count] [width]       time the fixed-width kernels on a file of count IDs (default 10M of 8 digits)
+	//	reverse-file <in> <out> [blockKiB]  reverse a binary column file in blocks (default 256 KiB)
+	//	reverse-file-async <in> <out> [blockKiB] [queueDepth] [auto|io_uring|threads]  same, with reads, reversal and writes overlapping
+	//	generate-file <output> [count]    write count random integers (default 10M) as a column file for reverse-file
+	//	serve [address] [windowUs]        run the batching reversal service on unix:<path> or tcp:<port> (default 50us window)
+	//	load [address] [connections] [requests] [values]        load test a running service, printing p50 / p99 latency
+	//	bench-serve [address] [connections] [requests] [values] run the same load against an in-process service at several batch windows
+	//	bench-ring [values] [requests] [producers]  round trips through a shared memory ring to a worker process vs the socket service vs in process
+	//	bench-parallel [maxElements]  work-stealing parallel batch reverse vs one thread vs std::transform(par_unseq), 1K values up to maxElements
+	//	bench-async [awaits]  per await overhead of co_await AsyncReverser::reverseBatch vs direct calls, and the reverseStream generator
+	//	range-stats <first> <last> [64]  sum, min, max and digit counts of reverse(x) over a range by digit DP, as int32_t or int64_t
+	//	verify-range [trials]             check the range digit DP against enumeration on random ranges (default 200 per width)
+	//	preimage <y> [64]                 every x with reverse(x) == y, as int32_t or int64_t
+	//	verify-preimage                   check the preimage engine exhaustively over int16_t and by round trips wider
+	//	bench-palindrome [values] [range] palindrome checks (scalar, SIMD batch) and generation vs reverseDigits_ModuloMultiply(x) == x
+	//	lychrel <first> <last> [limit] [threads] [nomemo]  reverse-and-add every seed until a palindrome, on digit arrays, steps/s per core
+	//	verify-lychrel                    check the reverse-and-add engine against scalar, uint64_t and known step counts
+	//	bench-cache [samples]             ReversalCache sizes and associativities vs reverseDigits_ModuloLookup on Zipf skewed inputs
+	//	bench-unrolled [values]           digit count dispatched unrolled kernels vs the looped ones on uniform and log-uniform inputs
+	const std::string_view mode = argc > 1 ? argv[1] : "";
+
+	// Runs in every build configuration; a kernel that disagrees with the reference is never timed
+	const SelfTestReport selfTestReport = runSelfTest();
+	selfTestReport.print();
+	if (!selfTestReport.passed())
+	{
+		return 1;
+	}
+	if (mode == "selftest")
+	{
+		return 0;
+	}
+	std::print("\n");
 
+	// File modes; these skip the spot check printout
+	if (mode == "reverse-text")
+	{
+		if (argc < 4)
+		{
+			std::println(stderr, "Usage: {} reverse-text <input> <output>", argv[0]);
+			return 2;
+		}
+		return runReverseTextFile(argv[2], argv[3]);
+	}
+	if (mode == "reverse-text-inplace")
+	{
+		if (argc < 4)
+		{
+			std::println(stderr, "Usage: {} reverse-text-inplace <input> <output>", argv[0]);
+			return 2;
+		}
+		return runReverseTextFileInPlace(argv[2], argv[3]);
+	}
+	if (mode == "bench-text")
+	{
+		uint64_t count = 10'000'000;
+		if (argc > 2 && !parseNumberArgument(argv[2], count))
+		{
+			std::println(stderr, "Usage: {} bench-text [count]", argv[0]);
+			return 2;
+		}
+		return runTextPipelineBenchmark(count);
+	}
+	if (mode == "generate-text")
+	{
+		uint64_t count = 10'000'000;
+		if (argc < 3 || (argc > 3 && !parseNumberArgument(argv[3], count)))
+		{
+			std::println(stderr, "Usage: {} generate-text <output> [count]", argv[0]);
+			return 2;
+		}
+		return runGenerateTextFile(argv[2], count);
+	}
+	if (mode == "reverse-fixed")
+	{
+		size_t width = 0;
+		if (argc < 5 || !parseNumberArgument(argv[4], width))
+		{
+			std::println(stderr, "Usage: {} reverse-fixed <input> <output> <width>", argv[0]);
+			return 2;
+		}
+		return runReverseFixedWidthFile(argv[2], argv[3], width);
+	}
+	if (mode == "generate-fixed")
+	{
+		uint64_t count = 10'000'000;
+		size_t width = 8;
+		if (argc < 3 || (argc > 3 && !parseNumberArgument(argv[3], count)) || (argc > 4 && !parseNumberArgument(argv[4], width)))
+		{
+			std::println(stderr, "Usage: {} generate-fixed <output> [count] [width]", argv[0]);
+			return 2;
+		}
+		return runGenerateFixedWidthFile(argv[2], count, width);
+	}
+	if (mode == "bench-fixed")
+	{
+		uint64_t count = 10'000'000;
+		size_t width = 8;
+		if ((argc > 2 && !parseNumberArgument(argv[2], count)) || (argc > 3 && !parseNumberArgument(argv[3], width)))
+		{
+			std::println(stderr, "Usage: {} bench-fixed [count] [width]", argv[0]);
+			return 2;
+		}
+		return runFixedWidthBenchmark(count, width);
+	}
+	if (mode == "reverse-file")
+	{
+		size_t blockKiB = defaultColumnBlockBytes >> 10;
+		if (argc < 4 || (argc > 4 && (!parseNumberArgument(argv[4], blockKiB) || blockKiB > (std::numeric_limits<size_t>::max() >> 10))))
+		{
+			std::println(stderr, "Usage: {} reverse-file <input> <output> [blockKiB]", argv[0]);
+			return 2;
+		}
+		return runReverseColumnFile(argv[2], argv[3], blockKiB << 10);
+	}
+	if (mode == "reverse-file-async")
+	{
+		if (argc < 4)
+		{
+			std::println(stderr, "Usage: {} reverse-file-async <input> <output> [blockKiB] [queueDepth] [auto|io_uring|threads]", argv[0]);
+			return 2;
+		}
+		size_t blockKiB = defaultColumnBlockBytes >> 10;
+		size_t queueDepth = defaultColumnQueueDepth;
+		const std::string_view backendName = argc > 6 ? argv[6] : "auto";
+		if ((argc > 4 && (!parseNumberArgument(argv[4], blockKiB) || blockKiB > (maxColumnBlockBytes >> 10)))
+			|| (argc > 5 && (!parseNumberArgument(argv[5], queueDepth) || queueDepth > maxColumnQueueDepth))
+			|| (backendName != "auto" && backendName != "io_uring" && backendName != "threads"))
+		{
+			std::println(stderr, "Usage: {} reverse-file-async <input> <output> [blockKiB <= {}] [queueDepth <= {}] [auto|io_uring|threads]", argv[0],
+				maxColumnBlockBytes >> 10, maxColumnQueueDepth);
+			return 2;
+		}
+		const size_t blockBytes = blockKiB << 10;
+		const AsyncFileBackend backend = backendName == "io_uring" ? AsyncFileBackend::IoUring : backendName == "threads" ? AsyncFileBackend::ThreadPool : AsyncFileBackend::Auto;
+		return runReverseColumnFileAsync(argv[2], argv[3], blockBytes, queueDepth, backend);
+	}
+	if (mode == "generate-file")
+	{
+		uint64_t count = 10'000'000;
+		if (argc < 3 || (argc > 3 && !parseNumberArgument(argv[3], count)))
+		{
+			std::println(stderr, "Usage: {} generate-file <output> [count]", argv[0]);
+			return 2;
+		}
+		return runGenerateColumnFile(argv[2], count);
+	}
 
-	std::println("Timing 'Char Array Stack' function...");
-	const TimingResult charArrayStackResult = timeFunction<&reverseDigits_CharArrayStack, valueTestRange, repeatCount>();
+	// Service modes
+	if (mode == "serve" || mode == "load" || mode == "bench-serve")
+	{
+		const std::string address = argc > 2 ? argv[2] : defaultServiceAddress();
+		if (mode == "serve")
+		{
+			int64_t windowMicroseconds = 50;
+			if (argc > 3 && (!parseNumberArgument(argv[3], windowMicroseconds) || windowMicroseconds < 0))
+			{
+				std::println(stderr, "Usage: {} serve [address] [windowUs]", argv[0]);
+				return 2;
+			}
+			return runReversalServer(address, std::chrono::microseconds(windowMicroseconds));
+		}
 
+		size_t connectionCount = 16;
+		size_t requestCount = mode == "load" ? 10'000 : 5'000;
+		size_t valuesPerRequest = 16;
+		if ((argc > 3 && !parseNumberArgument(argv[3], connectionCount)) || (argc > 4 && !parseNumberArgument(argv[4], requestCount))
+			|| (argc > 5 && !parseNumberArgument(argv[5], valuesPerRequest)))
+		{
+			std::println(stderr, "Usage: {} {} [address] [connections] [requests] [values]", argv[0], mode);
+			return 2;
+		}
+		return mode == "load"
+			? runReversalLoad(address, connectionCount, requestCount, valuesPerRequest)
+			: runReversalServiceBenchmark(address, connectionCount, requestCount, valuesPerRequest);
+	}
 
-	std::println("Timing 'Char Array Stack - Range Algorithm' function...");
-	const TimingResult charArrayStackAlgoResult = timeFunction<&reverseDigits_CharArrayStack_RangeAlgorithm, valueTestRange, repeatCount>();
+	if (mode == "bench-ring")
+	{
+		size_t valuesPerRequest = 16;
+		size_t requestCount = 100'000;
+		size_t producerCount = 4;
+		if ((argc > 2 && !parseNumberArgument(argv[2], valuesPerRequest)) || (argc > 3 && !parseNumberArgument(argv[3], requestCount))
+			|| (argc > 4 && !parseNumberArgument(argv[4], producerCount)))
+		{
+			std::println(stderr, "Usage: {} bench-ring [values] [requests] [producers]", argv[0]);
+			return 2;
+		}
+		return runSharedRingBenchmark(valuesPerRequest, requestCount, producerCount);
+	}
 
-	std::println("Timing 'Char Array Heap - Shared Alloc' function...");
-	const TimingResult charArrayHeapSharedResult = timeFunction<&reverseDigits_CharArrayHeap_SharedAlloc, valueTestRange, repeatCount>();
+	if (mode == "bench-parallel")
+	{
+		size_t maxElements = defaultParallelBenchmarkElements();
+		if (argc > 2 && !parseNumberArgument(argv[2], maxElements))
+		{
+			std::println(stderr, "Usage: {} bench-parallel [maxElements]", argv[0]);
+			return 2;
+		}
+		return runParallelReverseBenchmark(maxElements);
+	}
 
-	std::println("Timing 'Char Array Heap - Always Alloc' function...");
-	const TimingResult charArrayHeapAllocResult = timeFunction<&reverseDigits_CharArrayHeap_AlwaysAlloc, valueTestRange, repeatCount>();
+	if (mode == "bench-async")
+	{
+		size_t awaitCount = 1'000'000;
+		if (argc > 2 && !parseNumberArgument(argv[2], awaitCount))
+		{
+			std::println(stderr, "Usage: {} bench-async [awaits]", argv[0]);
+			return 2;
+		}
+		return runAsyncReverserBenchmark(awaitCount);
+	}
 
-	std::println("Timing 'Modulo Lookup' function...");
-	const TimingResult moduloLookupResult = timeFunction<&reverseDigits_ModuloLookup, valueTestRange, repeatCount>();
+	if (mode == "range-stats")
+	{
+		int64_t first = 0;
+		int64_t last = 0;
+		if (argc < 4 || !parseNumberArgument(argv[2], first) || !parseNumberArgument(argv[3], last))
+		{
+			std::println(stderr, "Usage: {} range-stats <first> <last> [64]", argv[0]);
+			return 2;
+		}
+		return runRangeStats(first, last, argc > 4 && std::string_view(argv[4]) == "64");
+	}
+	if (mode == "verify-range")
+	{
+		size_t trialCount = 200;
+		if (argc > 2 && !parseNumberArgument(argv[2], trialCount))
+		{
+			std::println(stderr, "Usage: {} verify-range [trials]", argv[0]);
+			return 2;
+		}
+		return runRangeStatsVerification(trialCount);
+	}
 
-	std::println("Timing 'Modulo Multiply' function...");
-	const TimingResult moduloMultiplyResult = timeFunction<&reverseDigits_ModuloMultiply, valueTestRange, repeatCount>();
+	if (mode == "preimage")
+	{
+		int64_t reversed = 0;
+		if (argc < 3 || !parseNumberArgument(argv[2], reversed))
+		{
+			std::println(stderr, "Usage: {} preimage <y> [64]", argv[0]);
+			return 2;
+		}
+		return runPreimageQuery(reversed, argc > 3 && std::string_view(argv[3]) == "64", 20);
+	}
+	if (mode == "verify-preimage")
+	{
+		return runPreimageVerification();
+	}
 
-	std::println("\n=====================================");
-	std::println("  Results");
-	std::println("=====================================\n");
+	if (mode == "bench-palindrome")
+	{
+		size_t valueCount = 1 << 24;
+		int32_t filterRange = 20'000'000;
+		if ((argc > 2 && !parseNumberArgument(argv[2], valueCount)) || (argc > 3 && !parseNumberArgument(argv[3], filterRange)))
+		{
+			std::println(stderr, "Usage: {} bench-palindrome [values] [range]", argv[0]);
+			return 2;
+		}
+		return runPalindromeBenchmark(valueCount, filterRange);
+	}
 
-	
-	std::println("Char Stack               ({})", charArrayStackResult.toString());
-	std::println("Char Stack - Range Algo  ({})", charArrayStackAlgoResult.toString());
-	std::println("Char Heap - Shared Alloc ({})", charArrayHeapSharedResult.toString());
-	std::println("Char Heap - Always Alloc ({})", charArrayHeapAllocResult.toString());
-	std::println("Modulo Lookup            ({})", moduloLookupResult.toString());
-	std::println("Modulo Multiply          ({})", moduloMultiplyResult.toString());
+	if (mode == "lychrel")
+	{
+		uint64_t first = 0;
+		uint64_t last = 0;
+		uint32_t iterationLimit = 500;
+		size_t threadCount = 0;
+		if (argc < 4 || !parseNumberArgument(argv[2], first) || !parseNumberArgument(argv[3], last)
+			|| (argc > 4 && !parseNumberArgument(argv[4], iterationLimit)) || (argc > 5 && !parseNumberArgument(argv[5], threadCount)))
+		{
+			std::println(stderr, "Usage: {} lychrel <first> <last> [limit] [threads] [nomemo]", argv[0]);
+			return 2;
+		}
+		return runReverseAndAddSweep(first, last, iterationLimit, threadCount, !(argc > 6 && std::string_view(argv[6]) == "nomemo"));
+	}
+	if (mode == "verify-lychrel")
+	{
+		return runReverseAndAddVerification();
+	}
 
-	std::print("\n");
-	std::println("## NOTE: These times are not representative of a single function call, but 3 function calls per iteration over a negative -> positive value range.");
-	std::println("## As such, the functions have been called {:L} times per timing cycle.", (static_cast<uint64_t>(valueTestRange) * 2ull * 3ull));
+	if (mode == "bench-cache")
+	{
+		size_t sampleCount = 1 << 23;
+		if (argc > 2 && !parseNumberArgument(argv[2], sampleCount))
+		{
+			std::println(stderr, "Usage: {} bench-cache [samples]", argv[0]);
+			return 2;
+		}
+		return runReversalCacheBenchmark(sampleCount);
+	}
+	if (mode == "bench-unrolled")
+	{
+		size_t valueCount = 1 << 24;
+		if (argc > 2 && !parseNumberArgument(argv[2], valueCount))
+		{
+			std::println(stderr, "Usage: {} bench-unrolled [values]", argv[0]);
+			return 2;
+		}
+		return runUnrolledBenchmark(valueCount);
+	}
 
-	return 0;
+	// These serve as a visual check and process warmup
+	for (const int32_t value : selfTestSpotValues)
+	{
+		validateDifferentOutputs(value);
+	}
+
+	if (mode == "scaling")
+	{
+		return runScalingBenchmark();
+	}
+	if (mode == "verify")
+	{
+		size_t maxReported = 16;
+		if (argc > 2 && !parseNumberArgument(argv[2], maxReported))
+		{
+			std::println(stderr, "Usage: {} verify [maxReported]", argv[0]);
+			return 2;
+		}
+		return runExhaustiveVerification(maxReported);
+	}
+
+	if (mode == "train")
+	{
+		// Short run of the timing workload, used to collect the PGO profile
+		return runTimingBenchmark<200'000, 2>(false);
+	}
+	if (mode == "csv")
+	{
+		// Longer range so the faster kernels' millisecond timings have some resolution
+		return runTimingBenchmark<20'000'000, 10>(true);
+	}
+
+	return runTimingBenchmark<2'000'000, 10>(false);
 }
@@ -0,0 +1,6 @@
+# Installed package config for IntDigitReverser::ReverseDigits, whose interface links Threads::Threads
+
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+
+include("${CMAKE_CURRENT_LIST_DIR}/IntDigitReverserTargets.cmake")
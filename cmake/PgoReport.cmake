@@ -0,0 +1,57 @@
+# Times the plain and PGO builds with the `csv` mode and prints how much each variant gains.
+#
+# Inputs: BASELINE_BINARY, PGO_BINARY
+
+function(collect_timings binary prefix)
+	message(STATUS "Timing ${binary}...")
+	execute_process(
+		COMMAND "${binary}" csv
+		OUTPUT_VARIABLE output
+		RESULT_VARIABLE result
+	)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "${binary} failed (${result})")
+	endif()
+
+	# csv,<variant>,<mode>,<mean ms>,<median ms>,<min ms>,<max ms>
+	string(REGEX MATCHALL "csv,[^\n]*" lines "${output}")
+	set(keys)
+	foreach(line IN LISTS lines)
+		string(REPLACE "," ";" fields "${line}")
+		list(GET fields 1 variant)
+		list(GET fields 2 mode)
+		list(GET fields 4 median)
+		set(key "${variant} (${mode})")
+		list(APPEND keys "${key}")
+		set("${prefix}_${key}" "${median}" PARENT_SCOPE)
+	endforeach()
+	set("${prefix}_keys" "${keys}" PARENT_SCOPE)
+endfunction()
+
+collect_timings("${BASELINE_BINARY}" baseline)
+collect_timings("${PGO_BINARY}" pgo)
+
+message("")
+message("Median milliseconds, plain build vs PGO build:")
+foreach(key IN LISTS baseline_keys)
+	set(baselineMs "${baseline_${key}}")
+	set(pgoMs "${pgo_${key}}")
+	if(pgoMs STREQUAL "")
+		continue()
+	endif()
+
+	if(pgoMs GREATER 0)
+		# Integer math only; report the speedup in hundredths
+		math(EXPR speedup "${baselineMs} * 100 / ${pgoMs}")
+		math(EXPR speedupWhole "${speedup} / 100")
+		math(EXPR speedupFraction "${speedup} % 100")
+		if(speedupFraction LESS 10)
+			set(speedupFraction "0${speedupFraction}")
+		endif()
+		set(speedupText "${speedupWhole}.${speedupFraction}x")
+	else()
+		set(speedupText "n/a")
+	endif()
+
+	message("  ${key}: ${baselineMs}ms -> ${pgoMs}ms (${speedupText})")
+endforeach()
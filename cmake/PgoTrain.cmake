@@ -0,0 +1,52 @@
+# Stage one of PGO: runs the instrumented benchmark on its training workload
+#	and leaves the profile where the IntDigitReverser_PGO target expects it.
+#
+# Inputs: COMPILER_ID, TRAINING_BINARY, PROFILE_DIR, LLVM_PROFDATA (Clang),
+#	GENERATE_OBJECT_DIR, USE_OBJECT_DIR, STAMP
+
+file(REMOVE_RECURSE "${PROFILE_DIR}")
+file(MAKE_DIRECTORY "${PROFILE_DIR}")
+
+if(COMPILER_ID MATCHES "Clang")
+	set(ENV{LLVM_PROFILE_FILE} "${PROFILE_DIR}/train-%p.profraw")
+endif()
+
+execute_process(
+	COMMAND "${TRAINING_BINARY}" train
+	OUTPUT_QUIET
+	RESULT_VARIABLE trainingResult
+)
+if(NOT trainingResult EQUAL 0)
+	message(FATAL_ERROR "PGO training run failed (${trainingResult})")
+endif()
+
+if(COMPILER_ID MATCHES "Clang")
+	file(GLOB rawProfiles "${PROFILE_DIR}/*.profraw")
+	execute_process(
+		COMMAND "${LLVM_PROFDATA}" merge "-output=${PROFILE_DIR}/merged.profdata" ${rawProfiles}
+		RESULT_VARIABLE mergeResult
+	)
+	if(NOT mergeResult EQUAL 0)
+		message(FATAL_ERROR "llvm-profdata merge failed (${mergeResult})")
+	endif()
+else()
+	# GCC names each .gcda after the mangled path of the object that produced it ('/' becomes '#'),
+	#	so the stage one profiles have to be renamed to the stage two object paths to be picked up.
+	string(REPLACE "/" "#" generatePrefix "${GENERATE_OBJECT_DIR}")
+	string(REPLACE "/" "#" usePrefix "${USE_OBJECT_DIR}")
+	file(GLOB profiles RELATIVE "${PROFILE_DIR}" "${PROFILE_DIR}/*.gcda")
+	foreach(profile IN LISTS profiles)
+		string(REPLACE "${generatePrefix}" "${usePrefix}" renamed "${profile}")
+		if(NOT renamed STREQUAL profile)
+			file(RENAME "${PROFILE_DIR}/${profile}" "${PROFILE_DIR}/${renamed}")
+		endif()
+	endforeach()
+endif()
+
+# Stale stage two objects were compiled against the previous profile
+file(GLOB_RECURSE staleObjects "${USE_OBJECT_DIR}/*.o")
+if(staleObjects)
+	file(REMOVE ${staleObjects})
+endif()
+
+file(TOUCH "${STAMP}")